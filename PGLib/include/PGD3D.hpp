@@ -1,5 +1,7 @@
 #pragma once
 
+#include "util/MemoryGovernor.hpp"
+
 #include <DirectXTex.h>
 
 #include <array>
@@ -33,8 +35,11 @@ private:
 
     static inline const D3D_FEATURE_LEVEL s_featureLevel = D3D_FEATURE_LEVEL_11_0; // DX11
 
+    static constexpr size_t DDS_META_CACHE_ENTRY_OVERHEAD = 64; /** Approximate hash node overhead per cache entry */
+
     std::unordered_map<std::filesystem::path, DirectX::TexMetadata> m_ddsMetaDataCache;
     std::shared_mutex m_ddsMetaDataMutex;
+    MemoryGovernor::Subsystem* m_ddsMetaDataMemory = nullptr; /** Evicted as a whole, entries are cheap to reload */
 
     // Global shader storage
     Microsoft::WRL::ComPtr<ID3D11ComputeShader> m_shaderCountAlphaValues;
@@ -72,6 +77,12 @@ public:
      */
     PGD3D(std::filesystem::path shaderPath);
 
+    ~PGD3D();
+    PGD3D(const PGD3D&) = delete;
+    auto operator=(const PGD3D&) -> PGD3D& = delete;
+    PGD3D(PGD3D&&) = delete;
+    auto operator=(PGD3D&&) -> PGD3D& = delete;
+
     /**
      * @brief Initialize GPU. This must be called before any other GPU functions
      *
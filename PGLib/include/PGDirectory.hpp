@@ -6,6 +6,7 @@
 #include "common/BethesdaGame.hpp"
 #include "pgutil/PGEnums.hpp"
 #include "pgutil/PGMeshPermutationTracker.hpp"
+#include "pgutil/PGNIFScanner.hpp"
 #include "pgutil/PGTypes.hpp"
 #include "util/TaskQueue.hpp"
 #include "util/TaskTracker.hpp"
@@ -14,10 +15,13 @@
 #include <nlohmann/json.hpp>
 
 #include <array>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <shared_mutex>
 #include <string>
@@ -40,19 +44,37 @@ public:
     struct NifCache {
         std::vector<std::pair<PGMeshPermutationTracker::FormKey, PGPlugin::MeshUseAttributes>>
             meshUses; // list of mesh uses
+        PGNIFScanner::MeshShapes meshShapes; // shapes read during mapping, for the mesh patch prefilter
     };
 
 private:
-    struct UnconfirmedTextureProperty {
-        std::unordered_map<PGEnums::TextureSlots, size_t> slots;
-        std::unordered_map<PGEnums::TextureType, size_t> types;
+    static constexpr size_t NUM_TEXTURE_TYPES = static_cast<size_t>(PGEnums::TextureType::UNKNOWN) + 1;
+    static constexpr size_t TEXTURE_DECISION_CHUNK_SIZE = 4096;
+
+    // Slot and type votes for a texture from the shapes that use it
+    struct TextureVotes {
+        std::array<uint32_t, NUM_TEXTURE_SLOTS> slots {};
+        std::array<uint32_t, NUM_TEXTURE_TYPES> types {};
+    };
+    using TextureVoteMap = std::unordered_map<uint32_t, TextureVotes>; /** Keyed by unconfirmed texture ID */
+
+    struct TextureMapping {
+        std::filesystem::path path;
+        PGEnums::TextureSlots slot;
+        PGEnums::TextureType type;
+        std::unordered_set<PGEnums::TextureAttribute> attributes;
     };
 
     // Temp Structures
-    std::unordered_map<std::filesystem::path, UnconfirmedTextureProperty> m_unconfirmedTextures;
-    std::mutex m_unconfirmedTexturesMutex;
+    std::vector<std::filesystem::path> m_unconfirmedTextures; /** Sorted, the index is the texture ID */
+    std::unordered_map<std::filesystem::path, uint32_t> m_unconfirmedTextureIDs; /** Read-only while mapping */
     std::unordered_set<std::filesystem::path> m_unconfirmedMeshes;
 
+    // Each mapping thread votes into its own buffer, the buffers are reduced after all meshes are mapped
+    std::mutex m_textureVoteBuffersMutex;
+    std::vector<std::shared_ptr<TextureVoteMap>> m_textureVoteBuffers;
+    static inline std::atomic<uint64_t> s_textureVoteGeneration = 0; /** Bumped at the start of every mapFiles */
+
     struct TextureDetails {
         PGEnums::TextureType type;
         std::unordered_set<PGEnums::TextureAttribute> attributes;
@@ -130,26 +152,46 @@ private:
     auto mapTexturesFromNIF(const std::filesystem::path& nifPath,
                             const bool& multithreading = true) -> TaskTracker::Result;
 
-    auto updateUnconfirmedTexturesMap(const std::filesystem::path& path,
-                                      const PGEnums::TextureSlots& slot,
-                                      const PGEnums::TextureType& type) -> void;
+    /**
+     * @brief Counts a slot and type vote for an unconfirmed texture in the calling thread's vote buffer
+     *
+     * @param path Texture path
+     * @param slot Slot the texture is used in
+     * @param type Type deduced from the shader
+     */
+    auto addTextureVote(const std::filesystem::path& path,
+                        const PGEnums::TextureSlots& slot,
+                        const PGEnums::TextureType& type) -> void;
+
+    /**
+     * @brief Merges all thread vote buffers into one with a pairwise tree reduction
+     *
+     * @param multithreading Merge pairs of buffers in parallel
+     * @return TextureVoteMap merged votes
+     */
+    auto reduceTextureVotes(const bool& multithreading) -> TextureVoteMap;
 
     auto addToTextureMaps(const std::filesystem::path& path,
                           const PGEnums::TextureSlots& slot,
                           const PGEnums::TextureType& type,
                           const std::unordered_set<PGEnums::TextureAttribute>& attributes) -> void;
 
+    /**
+     * @brief Adds several textures to the texture maps, taking each map lock once
+     *
+     * @param mappings Textures to add
+     */
+    auto addToTextureMaps(const std::vector<TextureMapping>& mappings) -> void;
+
     void updateNifCache(const std::filesystem::path& path,
-                        const std::vector<std::pair<PGMeshPermutationTracker::FormKey,
-                                                    PGPlugin::MeshUseAttributes>>& meshUses);
+                        std::vector<std::pair<PGMeshPermutationTracker::FormKey,
+                                              PGPlugin::MeshUseAttributes>>&& meshUses,
+                        PGNIFScanner::MeshShapes&& meshShapes);
 
     void checkIfCMAddToMap(const std::filesystem::path& texture,
                            const PGEnums::TextureSlots& winningSlot);
 
 public:
-    static auto checkGlobMatchInVector(const std::wstring& check,
-                                       const std::vector<std::wstring>& list) -> bool;
-
     /// @brief Get the texture map for a given texture slot
     ///
     /// To populate the map call populateFileMap() and mapFiles().
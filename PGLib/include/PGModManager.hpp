@@ -12,6 +12,7 @@
 #include <memory>
 #include <set>
 #include <shared_mutex>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -85,15 +86,32 @@ public:
         std::unordered_set<std::shared_ptr<Mod>, ModHash> conflicts;
     };
 
+    /**
+     * @brief Entry of the file to mod index.
+     */
+    struct ModFileEntry {
+        /// @brief Mod that provides the file in the load order.
+        std::shared_ptr<Mod> mod;
+        /// @brief Offset of the first overwritten mod in the shared loser list.
+        uint32_t losersBegin = 0;
+        /// @brief Number of lower priority mods that also contain the file.
+        uint32_t losersCount = 0;
+    };
+
+    using ModFileMap = std::unordered_map<std::filesystem::path, ModFileEntry>;
+
 private:
     std::unordered_map<std::wstring, std::shared_ptr<Mod>> m_modMap;
-    std::unordered_map<std::filesystem::path, std::shared_ptr<Mod>> m_modFileMap;
+    ModFileMap m_modFileMap; /** Lower case relative path to winning mod, read-only once populated */
+    std::vector<std::shared_ptr<Mod>> m_modFileLosers; /** Overwritten mods, grouped per file in priority order */
 
     ModManagerType m_mmType;
     std::filesystem::path m_stagingLocation;
+    std::filesystem::path m_overwriteLocation; /** MO2 overwrite folder, empty for other mod managers */
 
     static constexpr const char* MO2INI_PROFILESDIR_KEY = "profiles_directory=";
     static constexpr const char* MO2INI_MODDIR_KEY = "mod_directory=";
+    static constexpr const char* MO2INI_OVERWRITEDIR_KEY = "overwrite_directory=";
     static constexpr const char* MO2INI_BASEDIR_KEY = "base_directory=";
     static constexpr const char* MO2INI_GAMEDIR_KEY = "gamePath=";
     static constexpr const char* MO2INI_PROFILE_KEY = "selected_profile=";
@@ -117,8 +135,7 @@ public:
      *
      * @return Const reference to the file-to-mod map.
      */
-    [[nodiscard]] auto getModFileMap() const -> const std::unordered_map<std::filesystem::path,
-                                                                         std::shared_ptr<Mod>>&;
+    [[nodiscard]] auto getModFileMap() const -> const ModFileMap&;
 
     /**
      * @brief Finds the mod that owns the given relative file path.
@@ -136,6 +153,15 @@ public:
      */
     [[nodiscard]] auto getModByFileSmart(const std::filesystem::path& relPath) const -> std::shared_ptr<Mod>;
 
+    /**
+     * @brief Finds the mods whose copy of a file is overwritten by the owning mod (MO2 only).
+     *
+     * @param relPath Relative path of the file (as used in the data directory).
+     * @return Overwritten mods ordered from highest to lowest priority, empty if none.
+     */
+    [[nodiscard]] auto getLosingModsByFile(const std::filesystem::path& relPath) const
+        -> std::span<const std::shared_ptr<Mod>>;
+
     /**
      * @brief Returns all known mods (excluding the empty/virtual mod entry).
      *
@@ -217,9 +243,11 @@ public:
      *
      * @param instanceDir Path to the MO2 instance directory.
      * @param outputDir Path to the PGPatcher output directory (treated as a special mod entry).
+     * @param multithread If true, mod folders are scanned concurrently.
      */
     void populateModFileMapMO2(const std::filesystem::path& instanceDir,
-                               const std::filesystem::path& outputDir);
+                               const std::filesystem::path& outputDir,
+                               const bool& multithread = true);
 
     /**
      * @brief Populates the mod file map by reading Vortex's deployment manifest from the given directory.
@@ -257,6 +285,15 @@ public:
      */
     [[nodiscard]] auto getStagingLocation() const -> const std::filesystem::path&;
 
+    /**
+     * @brief Returns the folders MO2 layers on top of the game data folder, for reading the load order without the
+     * MO2 VFS.
+     *
+     * @return Enabled mod folders from lowest to highest priority in modlist order, followed by the overwrite folder.
+     * Empty if populateModFileMapMO2 was not called.
+     */
+    [[nodiscard]] auto getMO2OverlayFolders() const -> std::vector<std::filesystem::path>;
+
     /**
      * @brief Normalizes persisted priority order to match dialog save semantics.
      *
@@ -275,6 +312,15 @@ public:
                               const PGEnums::ShapeShader& shader) const;
 
 private:
+    /**
+     * @brief Folders configured in modorganizer.ini.
+     */
+    struct MO2Paths {
+        std::filesystem::path profileDir;
+        std::filesystem::path modDir;
+        std::filesystem::path overwriteDir;
+    };
+
     [[nodiscard]] static auto compareMods(const std::shared_ptr<Mod>& a,
                                           const std::shared_ptr<Mod>& b,
                                           bool checkPriority = true) -> bool;
@@ -283,6 +329,15 @@ private:
                                const std::string& fieldName,
                                const bool& isByteArray = false) -> std::wstring;
 
-    static auto getMO2FilePaths(const std::filesystem::path& instanceDir) -> std::pair<std::filesystem::path,
-                                                                                       std::filesystem::path>;
+    static auto getMO2FilePaths(const std::filesystem::path& instanceDir) -> MO2Paths;
+
+    /**
+     * @brief Lists the mapped files of a single MO2 mod folder.
+     *
+     * @param modDir Absolute path to the mod folder.
+     * @param modName Mod name used in log output.
+     * @return Lower case paths relative to the mod folder.
+     */
+    static auto scanMO2ModFolder(const std::filesystem::path& modDir,
+                                 const std::wstring& modName) -> std::vector<std::wstring>;
 };
@@ -2,10 +2,15 @@
 
 #include "PGDirectory.hpp"
 #include "PGPlugin.hpp"
+#include "patchers/base/PatcherTextureHook.hpp"
 #include "patchers/base/PatcherUtil.hpp"
 #include "pgutil/PGEnums.hpp"
+#include "pgutil/PGMeshPatchStore.hpp"
 #include "pgutil/PGMeshPermutationTracker.hpp"
+#include "pgutil/PGNIFBlockIndex.hpp"
 #include "pgutil/PGTypes.hpp"
+#include "util/MemoryBudget.hpp"
+#include "util/MemoryGovernor.hpp"
 #include "util/TaskTracker.hpp"
 
 #include "Geometry.hpp"
@@ -20,55 +25,155 @@
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 class PGPatcher {
 public:
     // Mesh Patch Tracking structures (for meta info displayed to user later)
-    struct MatchMeta {
-        std::shared_ptr<PGModManager::Mod> mod;
-        PGEnums::ShapeShader shader {};
-        PGEnums::ShapeShader shaderTransformTo {};
-        std::filesystem::path matchedPath;
-    };
-    struct MeshShapeMeta {
-        uint32_t blockID;
-        std::string shapeName;
-        std::vector<std::string> prePatchersApplied;
-        std::vector<std::string> postPatchersApplied;
-        std::unordered_map<PGMeshPermutationTracker::FormKey,
-                           std::vector<MatchMeta>,
-                           PGMeshPermutationTracker::FormKeyHash>
-            matches;
-    };
-    struct MeshMeta {
-        std::vector<std::string> globalPatchersApplied;
-        std::vector<PGMeshPermutationTracker::FormKey> formKeys;
-        std::map<size_t, MeshShapeMeta> shapeMeta;
-    };
-
-    using MeshPatchInfo = std::map<std::filesystem::path, MeshMeta>;
+    using MatchMeta = PGMeshPatchStore::MatchMeta;
+    using MeshShapeMeta = PGMeshPatchStore::MeshShapeMeta;
+    using MeshMeta = PGMeshPatchStore::MeshMeta;
 
 private:
     // Registered Patchers
     static PatcherUtil::PatcherTextureSet s_texPatchers;
     static PatcherUtil::PatcherMeshSet s_meshPatchers;
 
-    static std::shared_mutex s_diffJSONMutex;
-    static nlohmann::json s_diffJSON;
+    // Mesh patcher objects are pooled per worker thread and re-pointed at every NIF instead of being constructed for
+    // every mesh use. A pool is dropped once loadPatchers registers a different set of patchers
+    static inline std::atomic<uint64_t> s_meshPatchersGeneration = 0;
+    static thread_local std::unique_ptr<PatcherUtil::PatcherMeshObjectSet> s_patcherObjectPool;
+    static thread_local uint64_t s_patcherObjectPoolGeneration;
+
+    /**
+     * @brief Borrows the patcher objects of the calling thread for one NIF and releases them back to the pool when
+     * destroyed. Nested leases on the same thread get their own objects
+     */
+    class PatcherObjectLease {
+    private:
+        std::unique_ptr<PatcherUtil::PatcherMeshObjectSet> m_objects;
+        uint64_t m_generation;
+
+    public:
+        PatcherObjectLease(const std::filesystem::path& nifPath,
+                           nifly::NifFile* nif);
+        ~PatcherObjectLease();
+        PatcherObjectLease(const PatcherObjectLease&) = delete;
+        auto operator=(const PatcherObjectLease&) -> PatcherObjectLease& = delete;
+        PatcherObjectLease(PatcherObjectLease&&) = delete;
+        auto operator=(PatcherObjectLease&&) -> PatcherObjectLease& = delete;
+
+        [[nodiscard]] auto get() const -> const PatcherUtil::PatcherMeshObjectSet&;
+    };
+
+    // Base mesh diffs (ParallaxGen_Diff.json). Each thread appends compact records to its own buffer so that saving a
+    // mesh takes no shared lock, the buffers are merged and sorted once when the diff is read
+    struct DiffRecord {
+        uint32_t pathOffset; /** Offset of the UTF-8 mesh path in DiffBuffer::paths */
+        uint32_t pathLength;
+        uint32_t crc32original;
+        uint32_t crc32patched;
+    };
+    struct DiffBuffer {
+        std::string paths; /** Concatenated UTF-8 mesh paths referenced by records */
+        std::vector<DiffRecord> records;
+    };
+    struct DiffEntry {
+        std::string_view path;
+        uint32_t crc32original;
+        uint32_t crc32patched;
+    };
+    static inline std::mutex s_diffBuffersMutex;
+    static inline std::vector<std::shared_ptr<DiffBuffer>> s_diffBuffers;
+    static inline std::atomic<uint64_t> s_diffGeneration = 0; /** Bumped when buffers are dropped */
+
+    static inline PGMeshPatchStore s_meshPatchStore;
+
+    // Mod conflicts found during mesh patching. Each thread records (mod, conflicting mod) edges in its own buffer so
+    // that popular mods are not locked per shape, the buffers are merged into Mod::conflicts after patchMeshes
+    using ModConflictEdge = std::pair<PGModManager::Mod*, PGModManager::Mod*>;
+    struct ModConflictBuffer {
+        std::unordered_set<ModConflictEdge, boost::hash<ModConflictEdge>> edges;
+        std::unordered_map<PGModManager::Mod*, std::shared_ptr<PGModManager::Mod>> mods; /** Owners of edge pointers */
+    };
+    static inline std::mutex s_modConflictBuffersMutex;
+    static inline std::vector<std::shared_ptr<ModConflictBuffer>> s_modConflictBuffers;
+    static inline std::atomic<uint64_t> s_modConflictGeneration = 0; /** Bumped when buffers are merged or dropped */
+
+    // Shader match memo. Architecture and clutter reuse the same texture sets across many shapes, so the shader
+    // matches found before canApply are memoized per texture set. Cleared at the start of every mesh run
+    struct ShaderMatchKey {
+        PGTypes::TextureSet slots;
+        std::wstring context; /** PatcherMeshShader::getMatchContext of all shader patchers */
+        uint32_t shaderMask = 0; /** Bit per shader patcher that was asked */
+
+        auto operator==(const ShaderMatchKey& other) const -> bool = default;
+    };
+    struct ShaderMatchKeyHash {
+        auto operator()(const ShaderMatchKey& key) const -> size_t;
+    };
+    struct ShaderMatchMemoShard {
+        std::shared_mutex mutex;
+        std::unordered_map<ShaderMatchKey, std::vector<PatcherUtil::ShaderPatcherMatch>, ShaderMatchKeyHash> entries;
+        size_t bytes = 0; /** Estimated size of entries, charged to the memory governor */
+    };
+    static constexpr size_t SHADER_MATCH_MEMO_SHARD_BITS = 4;
+    static std::array<ShaderMatchMemoShard, 1ULL << SHADER_MATCH_MEMO_SHARD_BITS> s_shaderMatchMemo;
+    static inline std::atomic<bool> s_shaderMatchMemoEnabled = true;
+    static inline std::atomic<size_t> s_shaderMatchMemoHits = 0;
+    static inline std::atomic<size_t> s_shaderMatchMemoMisses = 0;
+
+    // Mesh prefilter. Meshes where no enabled patcher could change anything, judged from the shapes read during
+    // mapping, are skipped without loading them. Verify mode patches them anyway and reports every one that changed
+    static inline std::atomic<bool> s_meshPrefilterEnabled = true;
+    static inline std::atomic<bool> s_meshPrefilterVerify = false;
+    static inline std::atomic<size_t> s_meshPrefilterSkipped = 0;
+    static inline std::atomic<size_t> s_meshPrefilterMisses = 0; /** Skipped meshes that patching changed */
+
+    // Texture pipeline
+    static constexpr size_t DEFAULT_TEXTURE_PIXEL_BUDGET = 4ULL << 30ULL; /** 4 GiB of decoded pixels in flight */
+    static constexpr size_t TEXTURE_QUEUE_CAPACITY = 8; /** Jobs waiting in front of each texture stage */
+    static constexpr size_t TEXTURE_IO_WORKERS = 2;
+    static constexpr size_t TEXTURE_KERNEL_WORKERS = 2; /** PGD3D serializes GPU work, this only overlaps upload */
+    static constexpr size_t TEXTURE_WRITE_WORKERS = 2;
+
+    static inline MemoryBudget s_texturePixelBudget {"Texture Pixels", DEFAULT_TEXTURE_PIXEL_BUDGET};
+
+    /**
+     * @brief Generated texture produced by a texture hook, carried from the kernel stage to the write stage
+     */
+    struct TextureHookOutput {
+        std::unique_ptr<PatcherTextureHook> hook;
+        DirectX::ScratchImage image;
+    };
 
-    static inline MeshPatchInfo s_meshPatchInfo;
-    static inline std::shared_mutex s_meshPatchInfoMutex;
+    /**
+     * @brief State of one texture as it moves through the texture pipeline
+     */
+    struct TextureJob {
+        std::filesystem::path ddsPath;
+        std::vector<std::byte> ddsBytes; /** Raw file bytes, dropped after decode */
+        DirectX::ScratchImage ddsImage;
+        bool ddsModified = false;
+        std::vector<TextureHookOutput> hookOutputs;
+        size_t reservedBytes = 0; /** Bytes currently held in s_texturePixelBudget */
+        TaskTracker::Result result = TaskTracker::Result::SUCCESS;
+    };
 
 public:
     /**
@@ -104,11 +209,64 @@ public:
                                                        size_t)>& progressCallback = {});
 
     /**
-     * @brief Get the Patch Meta object
+     * @brief Set the maximum amount of decoded texture pixel data held by the texture pipeline at once
+     *
+     * @param bytes budget in bytes (0 for unlimited)
+     */
+    static void setTexturePixelBudget(const size_t& bytes);
+
+    struct ShaderMatchMemoStats {
+        size_t hits = 0;
+        size_t misses = 0;
+    };
+
+    /**
+     * @brief Enable or disable the shader match memo. Patch output is the same either way
+     *
+     * @param enabled whether shapes with the same texture set share shader matches
+     */
+    static void setShaderMatchMemoEnabled(const bool& enabled);
+
+    /**
+     * @brief Get hit and miss counters of the shader match memo for the last mesh run
+     *
+     * @return ShaderMatchMemoStats hit and miss counters
+     */
+    static auto getShaderMatchMemoStats() -> ShaderMatchMemoStats;
+
+    /**
+     * @brief Drop all memoized shader matches, needed when patcher configs change outside of patchMeshes
+     */
+    static void clearShaderMatchMemo();
+
+    struct MeshPrefilterStats {
+        size_t skipped = 0;
+        size_t misses = 0; /** Only counted in verify mode */
+    };
+
+    /**
+     * @brief Enable or disable the mesh prefilter, which skips meshes that no enabled patcher could change without
+     * loading them. Patch output is the same either way
+     *
+     * @param enabled whether meshes are skipped
+     * @param verify patch skipped meshes anyway and log an error for every one that changed (slow, for testing)
+     */
+    static void setMeshPrefilter(const bool& enabled,
+                                 const bool& verify = false);
+
+    /**
+     * @brief Get counters of the mesh prefilter for the last mesh run
+     *
+     * @return MeshPrefilterStats skipped meshes and, in verify mode, skipped meshes that patching changed
+     */
+    static auto getMeshPrefilterStats() -> MeshPrefilterStats;
+
+    /**
+     * @brief Get a shared read-only snapshot of the mesh patch metadata
      *
-     * @return std::map<std::filesystem::path, MeshMeta>
+     * @return std::shared_ptr<const PGMeshPatchStore::View> snapshot, not copied per caller
      */
-    static auto getPatchMeta() -> MeshPatchInfo;
+    static auto getPatchMeta() -> std::shared_ptr<const PGMeshPatchStore::View>;
 
     /**
      * @brief Sort matches according to a provided mod priority list.
@@ -156,8 +314,29 @@ public:
      */
     static auto isOutputEmpty() -> bool;
 
+    /**
+     * @brief Check whether any base mesh diff has been recorded
+     *
+     * @return true if diff data exists
+     */
+    static auto hasDiffData() -> bool;
+
+    /**
+     * @brief Get the diff JSON object built from the recorded base mesh diffs
+     *
+     * @return nlohmann::json diff JSON keyed by mesh path
+     */
     static auto getDiffJSON() -> nlohmann::json;
 
+    /**
+     * @brief Writes the diff JSON without building a JSON document. Output is identical to saving getDiffJSON() with
+     * FileUtil::saveJSON in readable mode
+     *
+     * @param filePath Destination file path
+     * @return true if the file was written successfully
+     */
+    static auto saveDiffJSON(const std::filesystem::path& filePath) -> bool;
+
 private:
     // NIF Runners
 
@@ -165,6 +344,7 @@ private:
      * @brief Patch a single NIF file
      *
      * @param nifPath relative path to the NIF file
+     * @param prefiltered mayPatchNIF found nothing to change, the NIF is only loaded in verify mode
      * @return TaskTracker::Result result of the patching process
      */
     static auto patchNIF(const std::filesystem::path& nifPath,
@@ -172,7 +352,48 @@ private:
                          const bool& forceBasePatch = false,
                          const std::unordered_set<PGPlugin::ModelRecordType>& allowedModelRecTypes = {},
                          const bool& checkAllowedRecTypes = false,
-                         const bool& excludeFacegens = false) -> TaskTracker::Result;
+                         const bool& excludeFacegens = false,
+                         PGMeshPermutationTracker::WeightVariantFingerprints* weightVariants = nullptr,
+                         const bool& prefiltered = false) -> TaskTracker::Result;
+
+    /**
+     * @brief Check if any enabled patcher could change a NIF, from the shapes read during mapping. NIFs with
+     * alternate textures are always patched
+     *
+     * @param nifPath relative path to the NIF file
+     * @param nifCache cache entry of the NIF
+     * @return true if patchNIF might change the NIF
+     * @return false if patchNIF would leave the NIF as it is
+     */
+    static auto mayPatchNIF(const std::filesystem::path& nifPath,
+                            const PGDirectory::NifCache& nifCache) -> bool;
+
+    /**
+     * @brief Check if a texture set has a shader match that changes shapes
+     *
+     * @param slots texture slots of the shape
+     * @param patchers patcher objects of the NIF
+     * @return true if a shader patcher other than the default one matches
+     */
+    static auto hasModifyingShaderMatch(const PGTypes::TextureSet& slots,
+                                        const PatcherUtil::PatcherMeshObjectSet& patchers) -> bool;
+
+    /**
+     * @brief Builds the mesh meta of a NIF that mayPatchNIF skipped from the shapes read during mapping, and records
+     * the mod conflicts of its shader matches, which processNIF would otherwise have done
+     *
+     * @param nifPath relative path to the NIF file
+     * @param nifCache cache entry of the NIF
+     * @param meshUses uses patchNIF would have processed
+     * @return MeshMeta meta with the shapes in block order
+     */
+    static auto getPrefilteredMeta(
+        const std::filesystem::path& nifPath,
+        const PGDirectory::NifCache& nifCache,
+        const std::vector<std::pair<PGMeshPermutationTracker::FormKey,
+                                    PGPlugin::MeshUseAttributes>>& meshUses,
+        const std::unordered_set<PGPlugin::ModelRecordType>& allowedModelRecTypes,
+        const bool& checkAllowedRecTypes) -> MeshMeta;
 
     // NIF Helpers
 
@@ -185,11 +406,13 @@ private:
      * @param[out] createdNIFs map of created NIFs
      * @param[out] nifModified whether the NIF file was modified
      * @param forceShaders optional map of shape shaders to force (used for duplicate meshes in recursion)
+     * @param blockIndex block index of nif, shared with the patchers created for it
      * @return true if the NIF file was processed successfully
      * @return false if the NIF file was not processed successfully
      */
     static auto processNIF(const std::filesystem::path& nifPath,
                            nifly::NifFile* nif,
+                           PGNIFBlockIndex& blockIndex,
                            MeshMeta& meshMeta,
                            bool singlepassMATO,
                            const PGMeshPermutationTracker::FormKey& formKey,
@@ -229,6 +452,39 @@ private:
                            const PatcherUtil::PatcherMeshObjectSet* patcherObjects = nullptr,
                            nifly::NiShape* shape = nullptr) -> std::vector<PatcherUtil::ShaderPatcherMatch>;
 
+    /**
+     * @brief Get the mesh meta entry of a shader match
+     *
+     * @param match shader match
+     * @return MatchMeta match meta
+     */
+    static auto getMatchMeta(const PatcherUtil::ShaderPatcherMatch& match) -> MatchMeta;
+
+    /**
+     * @brief Get the shader matches of a texture set before canApply, from the memo if another shape had the same set.
+     * The memo is skipped while a shader patcher reports canMemoizeMatches false
+     *
+     * @param slots texture slots of the shape
+     * @param patchers patcher objects of the NIF
+     * @return std::vector<PatcherUtil::ShaderPatcherMatch> unsorted matches with mod attribution
+     */
+    static auto getShaderMatches(const PGTypes::TextureSet& slots,
+                                 const PatcherUtil::PatcherMeshObjectSet& patchers)
+        -> std::vector<PatcherUtil::ShaderPatcherMatch>;
+
+    /**
+     * @brief Run shouldApply of every shader patcher and attribute matches to mods
+     *
+     * @param slots texture slots of the shape
+     * @param patchers patcher objects of the NIF
+     * @return std::vector<PatcherUtil::ShaderPatcherMatch> unsorted matches with mod attribution
+     */
+    static auto findShaderMatches(const PGTypes::TextureSet& slots,
+                                  const PatcherUtil::PatcherMeshObjectSet& patchers)
+        -> std::vector<PatcherUtil::ShaderPatcherMatch>;
+
+    static auto getShaderMatchMemoMemory() -> MemoryGovernor::Subsystem*;
+
     /**
      * @brief Helper method to run a transform if needed on a match
      *
@@ -239,11 +495,46 @@ private:
     static auto applyTransformIfNeeded(PatcherUtil::ShaderPatcherMatch& match,
                                        const PatcherUtil::PatcherMeshObjectSet& patchers) -> bool;
 
+    /**
+     * @brief Records that all given mods conflict with each other in the calling thread's conflict buffer
+     *
+     * @param mods Distinct mods that matched the same shape
+     */
+    static void recordModConflicts(const std::vector<const std::shared_ptr<PGModManager::Mod>*>& mods);
+
+    /**
+     * @brief Merges all thread conflict buffers into Mod::conflicts and drops the buffers
+     */
+    static void mergeModConflicts();
+
+    /**
+     * @brief Records a base mesh diff in the calling thread's diff buffer
+     *
+     * @param nifPath Mesh path
+     * @param crc32original CRC32 of the original mesh
+     * @param crc32patched CRC32 of the patched mesh
+     */
+    static void recordDiff(const std::filesystem::path& nifPath,
+                           const uint32_t& crc32original,
+                           const uint32_t& crc32patched);
+
+    /**
+     * @brief Get all recorded diffs sorted by mesh path, keeping the last record of a path recorded twice. Views are
+     * valid until resetRunState
+     *
+     * @return std::vector<DiffEntry> sorted diff entries
+     */
+    static auto getDiffEntries() -> std::vector<DiffEntry>;
+
     static auto createNIFPatcherObjects(const std::filesystem::path& nifPath,
                                         nifly::NifFile* nif) -> PatcherUtil::PatcherMeshObjectSet;
 
-    // DDS Runners
-    static auto patchDDS(const std::filesystem::path& ddsPath) -> TaskTracker::Result;
+    // DDS Runners (texture pipeline stages, return false to drop the job)
+    static auto readDDS(TextureJob& job) -> bool;
+    static auto decodeDDS(TextureJob& job) -> bool;
+    static auto runDDSKernels(TextureJob& job) -> bool;
+    static auto encodeDDS(TextureJob& job) -> bool;
+    static auto writeDDS(TextureJob& job) -> bool;
 
     static auto createDDSPatcherObjects(const std::filesystem::path& ddsPath,
                                         DirectX::ScratchImage* dds) -> PatcherUtil::PatcherTextureObjectSet;
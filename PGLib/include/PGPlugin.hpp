@@ -1,5 +1,6 @@
 #pragma once
 
+#include "PGMutagenWrapper.hpp"
 #include "common/BethesdaGame.hpp"
 #include "pgutil/PGMeshPermutationTracker.hpp"
 #include "pgutil/PGTypes.hpp"
@@ -9,8 +10,10 @@
 #include <nlohmann/json.hpp>
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -28,6 +31,18 @@ class PGPlugin {
 private:
     static inline bool s_initialized = false;
 
+    static constexpr size_t DEFAULT_MODEL_USE_FLUSH_BYTES = 16ULL << 20ULL; /** 16 MiB per bridge call */
+
+    // Model uses are collected here and submitted in large batches instead of one bridge call per mesh
+    static inline std::mutex s_modelUseBatchMutex;
+    static inline PGMutagenWrapper::ModelUseBatch s_modelUseBatch;
+    static inline size_t s_modelUseFlushBytes = DEFAULT_MODEL_USE_FLUSH_BYTES;
+
+    /**
+     * @brief Submits the collected model uses. Caller must hold s_modelUseBatchMutex
+     */
+    static void flushModelUsesLocked();
+
 public:
     enum class PluginLang : uint8_t {
         ENGLISH,
@@ -174,8 +189,8 @@ public:
         bool isDummyUse;
         /// @brief The plugin record type that references this model.
         ModelRecordType recType;
-        /// @brief Map from alternate texture set index to the overriding TextureSet.
-        std::unordered_map<unsigned int, PGTypes::TextureSet> alternateTextures;
+        /// @brief Alternate texture set index and the interned paths of the overriding TextureSet, in record order.
+        std::vector<std::pair<unsigned int, PGTypes::TextureSetIDs>> alternateTextures;
     };
 
     /**
@@ -268,10 +283,24 @@ public:
     /**
      * @brief Updates plugin records with the patched mesh paths from all committed mesh results.
      *
+     * Uses are batched and submitted once the batch reaches the flush size or flushModelUses() is called.
+     *
      * @param meshResults List of MeshResult objects produced by PGMeshPermutationTracker::saveMeshes().
      */
     static void setModelUses(const std::vector<PGMeshPermutationTracker::MeshResult>& meshResults);
 
+    /**
+     * @brief Submits all model uses collected by setModelUses() to the plugin.
+     */
+    static void flushModelUses();
+
+    /**
+     * @brief Sets the batch size at which collected model uses are submitted.
+     *
+     * @param bytes Approximate serialized size in bytes (0 to submit only on flushModelUses()).
+     */
+    static void setModelUseFlushBytes(const size_t& bytes);
+
     /**
      * @brief Saves the generated output plugin to the given directory.
      *
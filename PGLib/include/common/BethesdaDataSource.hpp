@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @brief Storage layer that BethesdaDirectory reads loose files from.
+ *
+ * A source is made of one or more layers, layer 0 has the lowest priority. Listing reports the files of every layer
+ * from the lowest to the highest layer, so a file map that keeps the last reported entry resolves conflicts the same
+ * way the game resolves loose file overrides. Paths passed in are relative to the root of the data directory and are
+ * matched case insensitively, paths reported keep the case found in the source.
+ */
+class BethesdaDataSource {
+public:
+    using FileCallback = std::function<void(const std::filesystem::path& relPath, uint32_t layer)>;
+
+    BethesdaDataSource() = default;
+    virtual ~BethesdaDataSource() = default;
+    BethesdaDataSource(const BethesdaDataSource& other) = default;
+    auto operator=(const BethesdaDataSource& other) -> BethesdaDataSource& = default;
+    BethesdaDataSource(BethesdaDataSource&& other) noexcept = default;
+    auto operator=(BethesdaDataSource&& other) noexcept -> BethesdaDataSource& = default;
+
+    /**
+     * @brief Report the files at the top level of every layer, used for BSAs and INIs
+     *
+     * @param callback Called for each file with its path relative to the layer root
+     */
+    virtual void listRootFiles(const FileCallback& callback) const = 0;
+
+    /**
+     * @brief Report all files in the given folders of every layer, recursively. Hidden files and folders are skipped
+     *
+     * @param folders Lower case top level folders to list
+     * @param callback Called for each file with its path relative to the layer root
+     */
+    virtual void listFiles(const std::unordered_set<std::filesystem::path>& folders,
+                           const FileCallback& callback) const
+        = 0;
+
+    /**
+     * @brief Find the highest priority layer that has a file
+     *
+     * @param relPath Path relative to the data directory
+     * @return std::optional<uint32_t> layer of the file, empty if no layer has it
+     */
+    [[nodiscard]] virtual auto findFile(const std::filesystem::path& relPath) const -> std::optional<uint32_t> = 0;
+
+    /**
+     * @brief Read a file from a layer
+     *
+     * @param relPath Path relative to the data directory
+     * @param layer Layer reported for the file
+     * @return std::vector<std::byte> bytes of the file, empty if it cannot be read
+     */
+    [[nodiscard]] virtual auto readFile(const std::filesystem::path& relPath,
+                                        uint32_t layer) const -> std::vector<std::byte>
+        = 0;
+
+    /**
+     * @brief Get the absolute path of a file in a layer, for consumers that can only open files from disk
+     *
+     * @param relPath Path relative to the data directory
+     * @param layer Layer reported for the file
+     * @return std::filesystem::path absolute path, empty if the layer does not live on disk
+     */
+    [[nodiscard]] virtual auto getFullPath(const std::filesystem::path& relPath,
+                                           uint32_t layer) const -> std::filesystem::path
+        = 0;
+
+    /**
+     * @brief Get a description of the source for log output
+     *
+     * @return std::wstring description
+     */
+    [[nodiscard]] virtual auto getDescription() const -> std::wstring = 0;
+};
+
+/**
+ * @brief Single physical directory, the classic data folder
+ */
+class BethesdaFolderSource : public BethesdaDataSource {
+private:
+    std::filesystem::path m_rootDir;
+
+public:
+    explicit BethesdaFolderSource(std::filesystem::path rootDir);
+
+    void listRootFiles(const FileCallback& callback) const override;
+    void listFiles(const std::unordered_set<std::filesystem::path>& folders,
+                   const FileCallback& callback) const override;
+    [[nodiscard]] auto findFile(const std::filesystem::path& relPath) const -> std::optional<uint32_t> override;
+    [[nodiscard]] auto readFile(const std::filesystem::path& relPath,
+                                uint32_t layer) const -> std::vector<std::byte> override;
+    [[nodiscard]] auto getFullPath(const std::filesystem::path& relPath,
+                                   uint32_t layer) const -> std::filesystem::path override;
+    [[nodiscard]] auto getDescription() const -> std::wstring override;
+
+    [[nodiscard]] auto getRootDir() const -> const std::filesystem::path&;
+};
+
+/**
+ * @brief Ordered overlay of physical directories, for example the game data folder followed by the mod folders of a
+ * mod manager. Reads files in place so the load order does not have to be deployed first.
+ */
+class BethesdaOverlaySource : public BethesdaDataSource {
+private:
+    std::vector<BethesdaFolderSource> m_layers; /**< Lowest priority first */
+
+public:
+    /**
+     * @brief Construct a new overlay
+     *
+     * @param layerDirs Directories ordered from lowest to highest priority
+     */
+    explicit BethesdaOverlaySource(const std::vector<std::filesystem::path>& layerDirs);
+
+    void listRootFiles(const FileCallback& callback) const override;
+    void listFiles(const std::unordered_set<std::filesystem::path>& folders,
+                   const FileCallback& callback) const override;
+    [[nodiscard]] auto findFile(const std::filesystem::path& relPath) const -> std::optional<uint32_t> override;
+    [[nodiscard]] auto readFile(const std::filesystem::path& relPath,
+                                uint32_t layer) const -> std::vector<std::byte> override;
+    [[nodiscard]] auto getFullPath(const std::filesystem::path& relPath,
+                                   uint32_t layer) const -> std::filesystem::path override;
+    [[nodiscard]] auto getDescription() const -> std::wstring override;
+};
+
+/**
+ * @brief Single layer of files held in memory. Files are added up front, the source is read-only once it is handed to
+ * a BethesdaDirectory. Files in it have no path on disk.
+ */
+class BethesdaMemorySource : public BethesdaDataSource {
+private:
+    struct MemoryFile {
+        std::filesystem::path relPath; /**< Path with the case it was added with */
+        std::vector<std::byte> bytes;
+    };
+
+    std::map<std::filesystem::path, MemoryFile> m_files; /**< Key is the lower case relative path */
+
+public:
+    /**
+     * @brief Add or replace a file
+     *
+     * @param relPath Path relative to the data directory
+     * @param bytes Contents of the file
+     */
+    void addFile(const std::filesystem::path& relPath,
+                 std::vector<std::byte> bytes);
+
+    void listRootFiles(const FileCallback& callback) const override;
+    void listFiles(const std::unordered_set<std::filesystem::path>& folders,
+                   const FileCallback& callback) const override;
+    [[nodiscard]] auto findFile(const std::filesystem::path& relPath) const -> std::optional<uint32_t> override;
+    [[nodiscard]] auto readFile(const std::filesystem::path& relPath,
+                                uint32_t layer) const -> std::vector<std::byte> override;
+    [[nodiscard]] auto getFullPath(const std::filesystem::path& relPath,
+                                   uint32_t layer) const -> std::filesystem::path override;
+    [[nodiscard]] auto getDescription() const -> std::wstring override;
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include "common/BethesdaDataSource.hpp"
 #include "common/BethesdaGame.hpp"
 #include "util/StringUtil.hpp"
 
@@ -8,6 +9,7 @@
 #include <nlohmann/json_fwd.hpp>
 
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <map>
 #include <memory>
@@ -55,11 +57,13 @@ private:
      * path stores the path to the file, preserving case from the original path
      * bsa_file stores a shared pointer to a BSA file struct, or nullptr if the
      * file is a loose file
+     * layer stores the data source layer a loose file is read from
      */
     struct BethesdaFile {
         std::filesystem::path path;
         std::shared_ptr<BSAFile> bsaFile;
         bool generated;
+        uint32_t layer = 0;
 
         [[nodiscard]] auto getDiagJSON() const -> nlohmann::json
         {
@@ -76,6 +80,7 @@ private:
     // Class member variables
     std::filesystem::path m_dataDir; /**< Stores the path to the game data directory */
     std::filesystem::path m_generatedDir; /**< Stores the path to the generated directory */
+    std::unique_ptr<BethesdaDataSource> m_dataSource; /**< Storage layer loose files, BSAs and INIs are read from */
     std::map<std::filesystem::path, BethesdaFile> m_fileMap; /** < Stores the file map for every file found in the load
                                                               order. Key is a lowercase path, value is a BethesdaFile*/
     std::map<std::filesystem::path, BethesdaFile>
@@ -127,6 +132,14 @@ public:
                       std::unordered_set<std::filesystem::path> foldersToMap,
                       std::filesystem::path generatedPath = "");
 
+    /**
+     * @brief Replace the storage layer loose files, BSAs and INIs are read from. Defaults to the data directory. Clears
+     * the file map, populateFileMap must be called again afterwards
+     *
+     * @param dataSource New data source
+     */
+    void setDataSource(std::unique_ptr<BethesdaDataSource> dataSource);
+
     /**
      * @brief Populate file map with all files in the load order
      */
@@ -227,7 +240,7 @@ public:
      * @brief Get the full path of a loose file in the load order
      *
      * @param relPath path to the file relative to the data directory
-     * @return std::filesystem::path absolute path to the file
+     * @return std::filesystem::path absolute path to the file, empty if the data source does not live on disk
      */
     [[nodiscard]] auto getLooseFileFullPath(const std::filesystem::path& relPath) -> std::filesystem::path;
 
@@ -272,18 +285,6 @@ public:
     static auto checkIfAnyComponentIs(const std::filesystem::path& path,
                                       const std::vector<std::wstring>& components) -> bool;
 
-    /**
-     * @brief Check if any glob in list matches string. Globs are basic MS-DOS wildcards, a * represents any number of
-     * any character including slashes
-     *
-     * @param str String to check
-     * @param globList Globs to check
-     * @return true if any match
-     * @return false if none match
-     */
-    static auto checkGlob(const std::wstring& str,
-                          const std::vector<std::wstring>& globList) -> bool;
-
     /**
      * @brief Check if file or folder is hidden
      *
@@ -330,9 +331,9 @@ private:
     [[nodiscard]] auto getBSAFilesFromINIs() const -> std::vector<std::wstring>;
 
     /**
-     * @brief Get BSA files in the data directory
+     * @brief Get BSA files at the top level of the data source
      *
-     * @return std::vector<std::wstring> list of BSAs in the data directory
+     * @return std::vector<std::wstring> list of BSAs in the data source
      */
     [[nodiscard]] auto getBSAFilesInDirectory() const -> std::vector<std::wstring>;
 
@@ -359,10 +360,13 @@ private:
      *
      * @param filePath path to update or add
      * @param bsaFile BSA file or nullptr if it doesn't exist
+     * @param generated whether the file is generated
+     * @param layer data source layer of a loose file
      */
     void updateFileMap(const std::filesystem::path& filePath,
                        std::shared_ptr<BSAFile> bsaFile,
-                       const bool& generated = false);
+                       const bool& generated = false,
+                       const uint32_t& layer = 0);
 
     /**
      * @brief Convert a list of wstrings to a LPCWSTRs
@@ -373,19 +377,6 @@ private:
     [[nodiscard]] static auto convertWStringToLPCWSTRVector(const std::vector<std::wstring>& original)
         -> std::vector<LPCWSTR>;
 
-    /**
-     * @brief Checks whether a glob matches a provided list of globs
-     *
-     * @param str String to check
-     * @param winningGlob Last glob that one (for performance)
-     * @param globList List of globs to check
-     * @return true Any glob is the list mated
-     * @return false No globs in the list matched
-     */
-    static auto checkGlob(const LPCWSTR& str,
-                          LPCWSTR& winningGlob,
-                          const std::vector<LPCWSTR>& globList) -> bool;
-
     static auto readINIValue(const std::filesystem::path& iniPath,
                              const std::wstring& section,
                              const std::wstring& key) -> std::wstring;
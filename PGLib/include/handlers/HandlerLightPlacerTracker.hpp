@@ -3,20 +3,36 @@
 #include <nlohmann/json.hpp>
 #include <nlohmann/json_fwd.hpp>
 
+#include <cstddef>
 #include <filesystem>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 class HandlerLightPlacerTracker {
 private:
+    struct LPJSON;
+
+    /**
+     * @brief A "models" array of a light placer block together with the set of strings it already contains
+     */
+    struct LPModels {
+        LPJSON* owner = nullptr;
+        nlohmann::json* models = nullptr;
+        std::unordered_set<std::string> entries; /** Guarded by owner->jsonMutex */
+    };
+
     struct LPJSON {
         std::filesystem::path jsonPath;
         std::mutex jsonMutex;
         nlohmann::json jsonData;
         bool changed = false;
+        std::vector<LPModels> modelArrays;
 
         LPJSON(std::filesystem::path path,
                nlohmann::json data = {})
@@ -26,17 +42,54 @@ private:
         }
     };
 
+    /**
+     * @brief Hashes and compares model paths case-insensitively with forward slashes folded to backslashes, so that
+     * lookups can use the raw mesh path without building a normalized copy
+     */
+    struct ModelKeyHash {
+        using is_transparent = void;
+        auto operator()(std::wstring_view key) const noexcept -> size_t;
+    };
+
+    struct ModelKeyEqual {
+        using is_transparent = void;
+        auto operator()(std::wstring_view lhs,
+                        std::wstring_view rhs) const noexcept -> bool;
+    };
+
     static std::vector<std::unique_ptr<LPJSON>> s_lightPlacerJSONs;
-    static std::unordered_map<std::filesystem::path, std::vector<std::pair<LPJSON*, nlohmann::json*>>>
-        s_lightPlacerJSONMap;
+    /** Immutable while patching, so lookups need no lock */
+    static std::unordered_map<std::wstring, std::vector<LPModels*>, ModelKeyHash, ModelKeyEqual> s_modelIndex;
+
+    /**
+     * @brief Strips leading separators and a leading "meshes" folder from a model path
+     *
+     * @param path Model path as stored in a light placer JSON or as a data relative mesh path
+     * @return std::wstring_view view into path used as index key
+     */
+    static auto getModelKey(std::wstring_view path) -> std::wstring_view;
+
+    /**
+     * @brief Collects the models arrays of a loaded light placer JSON
+     *
+     * @param lpJSON light placer JSON to scan
+     */
+    static void collectModelArrays(LPJSON& lpJSON);
+
+    /**
+     * @brief Rebuilds the model path index from the models arrays of all loaded JSONs. NOT THREAD SAFE
+     */
+    static void rebuildIndex();
 
 public:
     /**
      * @brief Initializes the light placer tracker with the provided JSON files. NOT THREAD SAFE
      *
      * @param lpJSONs A vector of paths to the light placer JSON files to be tracked.
+     * @param multithreading Whether to load the JSON files in parallel
      */
-    static void init(const std::vector<std::filesystem::path>& lpJSONs);
+    static void init(const std::vector<std::filesystem::path>& lpJSONs,
+                     const bool& multithreading = true);
 
     /**
      * @brief Handles the creation of a NIF file and updates the associated light placer JSONs. THIS IS THE ONLY METHOD
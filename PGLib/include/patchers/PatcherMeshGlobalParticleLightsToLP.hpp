@@ -1,6 +1,7 @@
 #pragma once
 
 #include "patchers/base/PatcherMeshGlobal.hpp"
+#include "pgutil/PGNIFScanner.hpp"
 
 #include "Animation.hpp"
 #include "Geometry.hpp"
@@ -53,6 +54,23 @@ public:
      */
     auto applyPatch() -> bool override;
 
+    /**
+     * @brief Check if applyPatch could change a NIF, only NIFs with billboard nodes can have particle lights
+     *
+     * @param meshShapes Shapes as read during mapping
+     * @return true NIF has billboard nodes
+     * @return false NIF has no billboard nodes
+     */
+    [[nodiscard]] auto mayApply(const PGNIFScanner::MeshShapes& meshShapes) const -> bool override;
+
+    /**
+     * @brief Check if a NIF might have particle lights, shared by applyPatch and mayApply
+     *
+     * @param hasBillboardNodes NIF has at least one NiBillboardNode
+     * @return true if the NIF might be patched
+     */
+    [[nodiscard]] static auto needsPatch(bool hasBillboardNodes) -> bool;
+
     /**
      * @brief Save output JSON
      */
@@ -1,11 +1,13 @@
 #pragma once
 
 #include "patchers/base/PatcherMeshPost.hpp"
+#include "pgutil/PGNIFScanner.hpp"
 #include "pgutil/PGTypes.hpp"
 
 #include "Geometry.hpp"
 #include "NifFile.hpp"
 
+#include <cstdint>
 #include <filesystem>
 
 class PatcherMeshPostFixSSS : public PatcherMeshPost {
@@ -35,4 +37,24 @@ public:
      */
     auto applyPatch(PGTypes::TextureSet& slots,
                     nifly::NiShape& nifShape) -> bool override;
+
+    /**
+     * @brief Check if applyPatch could change a shape, from what the NIF scanner read during mapping
+     *
+     * @param shape Shape as read during mapping
+     * @return true Patch might be applied
+     * @return false Patch would not be applied
+     */
+    [[nodiscard]] auto mayApply(const PGNIFScanner::ShaderShape& shape) const -> bool override;
+
+    /**
+     * @brief Check the shader part of the patch conditions, shared by applyPatch and mayApply. The slots are checked
+     * by applyPatch only since alternate textures can replace them
+     *
+     * @param shaderType nifly::BSLightingShaderPropertyShaderType
+     * @param shaderFlags2 nifly::SkyrimShaderPropertyFlags2 of the shader
+     * @return true if the shader might be patched
+     */
+    [[nodiscard]] static auto needsPatch(uint32_t shaderType,
+                                         uint32_t shaderFlags2) -> bool;
 };
@@ -1,12 +1,14 @@
 #pragma once
 
 #include "patchers/base/PatcherMeshPost.hpp"
+#include "pgutil/PGNIFScanner.hpp"
 #include "pgutil/PGTypes.hpp"
 
 #include "Geometry.hpp"
 #include "NifFile.hpp"
 #include "Shaders.hpp"
 
+#include <cstdint>
 #include <filesystem>
 
 class PatcherMeshPostRestoreDefaultShaders : public PatcherMeshPost {
@@ -37,6 +39,24 @@ public:
     auto applyPatch(PGTypes::TextureSet& slots,
                     nifly::NiShape& nifShape) -> bool override;
 
+    /**
+     * @brief Check if applyPatch could change a shape, from what the NIF scanner read during mapping
+     *
+     * @param shape Shape as read during mapping
+     * @return true Patch might be applied
+     * @return false Patch would not be applied
+     */
+    [[nodiscard]] auto mayApply(const PGNIFScanner::ShaderShape& shape) const -> bool override;
+
+    /**
+     * @brief Check the shader part of the patch conditions, shared by applyPatch and mayApply. The slots are checked
+     * by applyPatch only since alternate textures can replace them
+     *
+     * @param shaderType nifly::BSLightingShaderPropertyShaderType
+     * @return true if the shader might be restored to default
+     */
+    [[nodiscard]] static auto needsPatch(uint32_t shaderType) -> bool;
+
 private:
     /**
      * @brief Restores the default shader on a shape that currently uses the Parallax shader type,
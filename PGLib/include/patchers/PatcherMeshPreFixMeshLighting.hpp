@@ -1,11 +1,13 @@
 #pragma once
 
 #include "patchers/base/PatcherMeshPre.hpp"
+#include "pgutil/PGNIFScanner.hpp"
 #include "pgutil/PGTypes.hpp"
 
 #include "Geometry.hpp"
 #include "NifFile.hpp"
 
+#include <cstdint>
 #include <filesystem>
 
 class PatcherMeshPreFixMeshLighting : public PatcherMeshPre {
@@ -38,4 +40,23 @@ public:
      */
     auto applyPatch(PGTypes::TextureSet& slots,
                     nifly::NiShape& nifShape) -> bool override;
+
+    /**
+     * @brief Check if applyPatch could change a shape, from what the NIF scanner read during mapping
+     *
+     * @param shape Shape as read during mapping
+     * @return true Patch might be applied
+     * @return false Patch would not be applied
+     */
+    [[nodiscard]] auto mayApply(const PGNIFScanner::ShaderShape& shape) const -> bool override;
+
+    /**
+     * @brief Check if a shader needs its soft lighting capped, shared by applyPatch and mayApply
+     *
+     * @param shaderType nifly::BSLightingShaderPropertyShaderType
+     * @param softLighting soft lighting of the shader
+     * @return true if the shader should be patched
+     */
+    [[nodiscard]] static auto needsPatch(uint32_t shaderType,
+                                         float softLighting) -> bool;
 };
@@ -1,11 +1,13 @@
 #pragma once
 
 #include "patchers/base/PatcherMeshPre.hpp"
+#include "pgutil/PGNIFScanner.hpp"
 #include "pgutil/PGTypes.hpp"
 
 #include "Geometry.hpp"
 #include "NifFile.hpp"
 
+#include <cstddef>
 #include <filesystem>
 
 class PatcherMeshPreFixTextureSlotCount : public PatcherMeshPre {
@@ -38,4 +40,21 @@ public:
      */
     auto applyPatch(PGTypes::TextureSet& slots,
                     nifly::NiShape& nifShape) -> bool override;
+
+    /**
+     * @brief Check if applyPatch could change a shape, from what the NIF scanner read during mapping
+     *
+     * @param shape Shape as read during mapping
+     * @return true Patch might be applied
+     * @return false Patch would not be applied
+     */
+    [[nodiscard]] auto mayApply(const PGNIFScanner::ShaderShape& shape) const -> bool override;
+
+    /**
+     * @brief Check if a texture set needs more slots, shared by applyPatch and mayApply
+     *
+     * @param numTextures textures in the texture set
+     * @return true if the texture set should be patched
+     */
+    [[nodiscard]] static auto needsPatch(size_t numTextures) -> bool;
 };
@@ -4,6 +4,7 @@
 #include "patchers/base/PatcherMeshShader.hpp"
 #include "pgutil/PGEnums.hpp"
 #include "pgutil/PGTypes.hpp"
+#include "util/MemoryGovernor.hpp"
 
 #include "Geometry.hpp"
 #include "NifFile.hpp"
@@ -26,6 +27,13 @@ private:
     static std::shared_mutex s_metaCacheMutex; /** Mutex for material meta cache */
     static std::unordered_map<std::filesystem::path, nlohmann::json> s_metaCache; /** Cache for material meta */
 
+    /**
+     * @brief Get the memory governor subsystem of the material meta cache, registered on first use
+     *
+     * @return MemoryGovernor::Subsystem* subsystem
+     */
+    static auto getMetaCacheMemory() -> MemoryGovernor::Subsystem*;
+
     // Options
     inline static bool s_disableDynCubemap = false;
 
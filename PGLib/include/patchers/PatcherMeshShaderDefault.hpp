@@ -103,4 +103,11 @@ public:
      * @param nifModified Whether the NIF was modified
      */
     void applyShader(nifly::NiShape& nifShape) override;
+
+    /**
+     * @brief The default shader leaves shapes as they are
+     *
+     * @return false
+     */
+    [[nodiscard]] auto modifiesShapes() const -> bool override;
 };
@@ -52,6 +52,8 @@ private:
     inline static bool s_checkPaths = true;
     inline static bool s_printNonExistentPaths = false;
 
+    inline static bool s_hasNIFFilter = false; /** Any config uses nif_filter, matches depend on the NIF path */
+
 public:
     /**
      * @brief Get the True PBR Configs
@@ -182,6 +184,20 @@ public:
     auto shouldApply(const PGTypes::TextureSet& oldSlots,
                      std::vector<PatcherMatch>& matches) -> bool override;
 
+    /**
+     * @brief Get the NIF path if any config filters by it
+     *
+     * @return std::wstring NIF path or empty
+     */
+    [[nodiscard]] auto getMatchContext() const -> std::wstring override;
+
+    /**
+     * @brief Matches are not memoized while missing paths are printed, the warning names the mesh
+     *
+     * @return true if print_nonexistent_paths is off
+     */
+    [[nodiscard]] auto canMemoizeMatches() const -> bool override;
+
     /**
      * @brief Applies a match to a shape
      *
@@ -264,14 +280,6 @@ private:
 
     // TruePBR Helpers
 
-    /**
-     * @brief Calculate ABS of 2-element vector
-     *
-     * @param v vector to calculate abs of
-     * @return nifly::Vector2 ABS of vector
-     */
-    static auto abs2(nifly::Vector2 v) -> nifly::Vector2;
-
     /**
      * @brief Math that calculates auto UV scale for a shape
      *
@@ -20,6 +20,9 @@ private:
     bool m_hasAttachedHavok
         = false; /** Stores at the NIF level whether the NIF has attached havok (incompatible with parallax) */
 
+protected:
+    void onRebind() override;
+
 public:
     /**
      * @brief Get the Factory object for parallax patcher
@@ -4,6 +4,7 @@
 
 #include <DirectXTex.h>
 #include <d3d11.h>
+#include <dxgiformat.h>
 
 #include <filesystem>
 #include <shared_mutex>
@@ -66,9 +67,19 @@ public:
                                   DirectX::ScratchImage* dds);
 
     /**
-     * @brief Applies the parallax-to-Complex-Material conversion and writes the output DDS.
+     * @brief Runs the parallax-to-Complex-Material shader on the source texture.
      *
-     * @return true if the patch was successfully applied; false otherwise.
+     * @param[out] out Uncompressed shader output.
+     * @return true if the shader produced an image; false otherwise.
      */
-    auto applyPatch() -> bool override;
+    auto applyShader(DirectX::ScratchImage& out) -> bool override;
+
+    [[nodiscard]] auto getOutputPath() const -> std::filesystem::path override;
+
+    [[nodiscard]] auto getOutputFormat() const -> DXGI_FORMAT override;
+
+    /**
+     * @brief Adds the generated Complex Material texture to the envmask texture map.
+     */
+    void registerOutput() override;
 };
@@ -4,6 +4,7 @@
 
 #include <DirectXTex.h>
 #include <d3d11.h>
+#include <dxgiformat.h>
 
 #include <filesystem>
 #include <shared_mutex>
@@ -74,9 +75,19 @@ public:
                              DirectX::ScratchImage* dds);
 
     /**
-     * @brief Applies the SSS fix shader and writes the output subsurface color DDS.
+     * @brief Runs the SSS fix shader on the source texture.
      *
-     * @return true if the patch was successfully applied; false otherwise.
+     * @param[out] out Uncompressed shader output.
+     * @return true if the shader produced an image; false otherwise.
      */
-    auto applyPatch() -> bool override;
+    auto applyShader(DirectX::ScratchImage& out) -> bool override;
+
+    [[nodiscard]] auto getOutputPath() const -> std::filesystem::path override;
+
+    [[nodiscard]] auto getOutputFormat() const -> DXGI_FORMAT override;
+
+    /**
+     * @brief Adds the generated subsurface color texture to the glow texture map.
+     */
+    void registerOutput() override;
 };
@@ -27,7 +27,7 @@ public:
     /**
      * @brief Get the Patcher Name object
      *
-     * @return std::string Patcher name
+     * @return const std::string& Patcher name
      */
-    [[nodiscard]] auto getPatcherName() const -> std::string;
+    [[nodiscard]] auto getPatcherName() const -> const std::string&;
 };
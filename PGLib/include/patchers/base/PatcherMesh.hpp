@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Patcher.hpp"
+#include "pgutil/PGNIFBlockIndex.hpp"
 #include "pgutil/PGTypes.hpp"
 
 #include "Geometry.hpp"
@@ -8,6 +9,7 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <shared_mutex>
 #include <string>
 #include <unordered_map>
@@ -41,6 +43,8 @@ private:
     // Instance vars
     std::filesystem::path m_nifPath; /** Stores the path to the NIF file currently being patched */
     nifly::NifFile* m_nif; /** Stores the NIF object itself */
+    PGNIFBlockIndex* m_blockIndex; /** Index shared by all patchers of the NIF, see PGNIFBlockIndex::Scope */
+    std::unique_ptr<PGNIFBlockIndex> m_ownBlockIndex; /** Fallback if no shared index was active at construction */
 
 protected:
     /**
@@ -59,8 +63,29 @@ protected:
      */
     [[nodiscard]] auto getNIF() const -> nifly::NifFile*;
 
+    /**
+     * @brief Check if the patcher currently points at a NIF (pooled patchers do not between uses)
+     *
+     * @return true NIF is set
+     */
+    [[nodiscard]] auto hasNIF() const -> bool;
+
     void setNIF(nifly::NifFile* nif);
 
+    /**
+     * @brief Get the block index of the NIF for the current patcher (used only within child patchers). Patchers that
+     * re-link blocks without adding or removing any must call invalidate() on it
+     *
+     * @return PGNIFBlockIndex& block index
+     */
+    [[nodiscard]] auto getBlockIndex() -> PGNIFBlockIndex&;
+
+    /**
+     * @brief Called by rebind() once the patcher points at its new NIF. Patchers that keep state per NIF must reset
+     * it here, the NIF is nullptr when the patcher is returned to its pool
+     */
+    virtual void onRebind();
+
 public:
     /**
      * @brief Construct a new Patcher object
@@ -72,4 +97,14 @@ public:
     PatcherMesh(std::filesystem::path nifPath,
                 nifly::NifFile* nif,
                 std::string patcherName);
+
+    /**
+     * @brief Points a pooled patcher at another NIF instead of constructing a new one. Picks up the block index of
+     * the active PGNIFBlockIndex::Scope like the constructor does
+     *
+     * @param nifPath Path to NIF being patched
+     * @param nif NIF object, nullptr to release the previous NIF
+     */
+    void rebind(std::filesystem::path nifPath,
+                nifly::NifFile* nif);
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "patchers/base/PatcherMesh.hpp"
+#include "pgutil/PGNIFScanner.hpp"
 
 #include "NifFile.hpp"
 
@@ -37,4 +38,14 @@ public:
      * @return false Patch was not applied
      */
     virtual auto applyPatch() -> bool = 0;
+
+    /**
+     * @brief Check if applyPatch could change a NIF, from what the NIF scanner read during mapping. Meshes that no
+     * patcher could change are not loaded, so this may only return false if applyPatch would return false
+     *
+     * @param meshShapes Shapes as read during mapping
+     * @return true Patch might be applied
+     * @return false Patch would not be applied
+     */
+    [[nodiscard]] virtual auto mayApply(const PGNIFScanner::MeshShapes& meshShapes) const -> bool;
 };
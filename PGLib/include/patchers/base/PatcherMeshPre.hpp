@@ -1,6 +1,7 @@
 #pragma once
 
 #include "patchers/base/PatcherMesh.hpp"
+#include "pgutil/PGNIFScanner.hpp"
 #include "pgutil/PGTypes.hpp"
 
 #include "Geometry.hpp"
@@ -42,4 +43,14 @@ public:
     virtual auto applyPatch(PGTypes::TextureSet& slots,
                             nifly::NiShape& nifShape) -> bool
         = 0;
+
+    /**
+     * @brief Check if applyPatch could change a shape, from what the NIF scanner read during mapping. Meshes that no
+     * patcher could change are not loaded, so this may only return false if applyPatch would return false
+     *
+     * @param shape Shape as read during mapping
+     * @return true Patch might be applied
+     * @return false Patch would not be applied
+     */
+    [[nodiscard]] virtual auto mayApply(const PGNIFScanner::ShaderShape& shape) const -> bool;
 };
@@ -74,6 +74,30 @@ public:
                              std::vector<PatcherMatch>& matches) -> bool
         = 0;
 
+    /**
+     * @brief Inputs other than the slots that shouldApply depends on. Shapes with the same slots and context share
+     * memoized matches
+     *
+     * @return std::wstring context, empty if matches only depend on the slots
+     */
+    [[nodiscard]] virtual auto getMatchContext() const -> std::wstring;
+
+    /**
+     * @brief Whether the matches of shouldApply can be memoized. Patchers whose shouldApply has output per mesh, like
+     * warnings naming the NIF, must run it for every shape
+     *
+     * @return true if shouldApply has no side effects per mesh
+     */
+    [[nodiscard]] virtual auto canMemoizeMatches() const -> bool;
+
+    /**
+     * @brief Whether applying a match can change a shape. Meshes whose only matches are from patchers that do not
+     * change shapes are not loaded
+     *
+     * @return true if applyPatch can change the shape or its slots
+     */
+    [[nodiscard]] virtual auto modifiesShapes() const -> bool;
+
     // Methods that apply the patch to a shape
     virtual void applyPatch(PGTypes::TextureSet& slots,
                             nifly::NiShape& nifShape,
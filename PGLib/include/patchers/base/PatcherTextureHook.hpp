@@ -1,8 +1,10 @@
 #pragma once
 
 #include "patchers/base/PatcherTexture.hpp"
+#include "util/BCEncoder.hpp"
 
 #include <DirectXTex.h>
+#include <dxgiformat.h>
 
 #include <filesystem>
 #include <functional>
@@ -16,7 +18,10 @@
  */
 class PatcherTextureHook : public PatcherTexture {
 protected:
-    static inline std::mutex s_generatedFileTrackerMutex;
+    static inline std::mutex s_generatedFileTrackerMutex; /** Guards texture map updates for generated files */
+
+    static constexpr BCEncoder::Quality COMPRESS_QUALITY
+        = BCEncoder::Quality::NORMAL; /** Quality tier used to compress generated textures */
 
 public:
     // type definitions
@@ -35,10 +40,62 @@ public:
     auto operator=(PatcherTextureHook&& other) noexcept -> PatcherTextureHook& = default;
 
     /**
-     * @brief Apply the patch to the texture if able
+     * @brief Apply the patch to the texture if able. Runs applyShader, compression, saving and registerOutput in order.
      *
      * @return true Patch was applied
      * @return false Patch was not applied
      */
-    virtual auto applyPatch() -> bool = 0;
+    auto applyPatch() -> bool;
+
+    /**
+     * @brief Runs the hook's shader on the source texture
+     *
+     * @param[out] out Uncompressed shader output
+     * @return true Shader ran and produced at least one image
+     * @return false Shader failed
+     */
+    virtual auto applyShader(DirectX::ScratchImage& out) -> bool = 0;
+
+    /**
+     * @brief Get the path of the generated texture relative to the data directory
+     *
+     * @return std::filesystem::path generated texture path
+     */
+    [[nodiscard]] virtual auto getOutputPath() const -> std::filesystem::path = 0;
+
+    /**
+     * @brief Get the compressed format the generated texture is saved in
+     *
+     * @return DXGI_FORMAT output format
+     */
+    [[nodiscard]] virtual auto getOutputFormat() const -> DXGI_FORMAT = 0;
+
+    /**
+     * @brief Adds the saved generated texture to the texture maps so meshes can pick it up
+     */
+    virtual void registerOutput() = 0;
+
+    /**
+     * @brief Compresses shader output to the hook's output format
+     *
+     * @param source Uncompressed shader output
+     * @param format Target compressed format
+     * @param[out] out Compressed image
+     * @return true Compression succeeded
+     * @return false Compression failed
+     */
+    static auto compressOutput(const DirectX::ScratchImage& source,
+                               const DXGI_FORMAT& format,
+                               DirectX::ScratchImage& out) -> bool;
+
+    /**
+     * @brief Saves a generated texture to the generated output directory
+     *
+     * @param image Image to save
+     * @param outputPath Path relative to the data directory
+     * @return true Save succeeded
+     * @return false Save failed
+     */
+    static auto saveOutput(const DirectX::ScratchImage& image,
+                           const std::filesystem::path& outputPath) -> bool;
 };
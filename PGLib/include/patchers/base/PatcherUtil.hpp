@@ -11,8 +11,10 @@
 #include "pgutil/PGEnums.hpp"
 #include "util/StringUtil.hpp"
 
+#include "NifFile.hpp"
 #include <nlohmann/json_fwd.hpp>
 
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -38,6 +40,32 @@ public:
             std::pair<PGEnums::ShapeShader, PatcherMeshShaderTransform::PatcherMeshShaderTransformObject>>
             shaderTransformPatchers;
         std::vector<PatcherMeshPost::PatcherMeshPostObject> postPatchers;
+
+        /**
+         * @brief Points every patcher of the set at another NIF, see PatcherMesh::rebind
+         *
+         * @param nifPath Path to NIF being patched
+         * @param nif NIF object, nullptr to release the previous NIF
+         */
+        void rebind(const std::filesystem::path& nifPath,
+                    nifly::NifFile* nif)
+        {
+            for (const auto& patcher : globalPatchers) {
+                patcher->rebind(nifPath, nif);
+            }
+            for (const auto& patcher : prePatchers) {
+                patcher->rebind(nifPath, nif);
+            }
+            for (const auto& [shader, patcher] : shaderPatchers) {
+                patcher->rebind(nifPath, nif);
+            }
+            for (const auto& [shader, transform] : shaderTransformPatchers) {
+                transform.second->rebind(nifPath, nif);
+            }
+            for (const auto& patcher : postPatchers) {
+                patcher->rebind(nifPath, nif);
+            }
+        }
     };
 
     /**
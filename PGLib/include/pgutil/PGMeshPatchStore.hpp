@@ -0,0 +1,160 @@
+#pragma once
+
+#include "PGModManager.hpp"
+#include "pgutil/PGEnums.hpp"
+#include "pgutil/PGMeshPermutationTracker.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @brief Concurrent store for the per-mesh patch metadata shown in the mod conflict view.
+ *
+ * Mesh workers append one record per mesh into a shard picked by path hash, so they only contend when two meshes hash
+ * to the same shard. Readers get an immutable snapshot view that is shared between callers and only rebuilt after new
+ * records were added. Patcher names are stored as bits of a mask and shape names are interned since both repeat for
+ * almost every shape.
+ */
+class PGMeshPatchStore {
+public:
+    using PatcherMask = uint64_t; /** One bit per patcher name, see getPatcherBit */
+
+    struct MatchMeta {
+        std::shared_ptr<PGModManager::Mod> mod;
+        PGEnums::ShapeShader shader {};
+        PGEnums::ShapeShader shaderTransformTo {};
+        std::filesystem::path matchedPath;
+    };
+
+    struct MeshShapeMeta {
+        uint32_t blockID = 0;
+        std::string_view shapeName; /** Interned, see internShapeName */
+        PatcherMask prePatchersApplied = 0;
+        PatcherMask postPatchersApplied = 0;
+        std::unordered_map<PGMeshPermutationTracker::FormKey,
+                           std::vector<MatchMeta>,
+                           PGMeshPermutationTracker::FormKeyHash>
+            matches;
+    };
+
+    struct MeshMeta {
+        PatcherMask globalPatchersApplied = 0;
+        std::vector<PGMeshPermutationTracker::FormKey> formKeys;
+        std::vector<MeshShapeMeta> shapeMeta; /** Indexed by the order of patchable shapes in the NIF */
+    };
+
+    struct MeshEntry {
+        std::filesystem::path meshPath;
+        MeshMeta meta;
+    };
+
+    /**
+     * @brief Immutable snapshot of the store, sorted by mesh path
+     */
+    class View {
+    private:
+        std::vector<std::shared_ptr<const MeshEntry>> m_meshes;
+
+    public:
+        View() = default;
+        explicit View(std::vector<std::shared_ptr<const MeshEntry>> meshes);
+
+        [[nodiscard]] auto begin() const { return m_meshes.begin(); }
+        [[nodiscard]] auto end() const { return m_meshes.end(); }
+        [[nodiscard]] auto size() const -> size_t { return m_meshes.size(); }
+        [[nodiscard]] auto empty() const -> bool { return m_meshes.empty(); }
+
+        /**
+         * @brief Finds the metadata of a mesh
+         *
+         * @param meshPath Mesh path
+         * @return const MeshMeta* metadata or nullptr if the mesh is not in the view
+         */
+        [[nodiscard]] auto find(const std::filesystem::path& meshPath) const -> const MeshMeta*;
+
+        [[nodiscard]] auto contains(const std::filesystem::path& meshPath) const -> bool;
+    };
+
+private:
+    static constexpr size_t SHARD_COUNT = 32;
+    static constexpr size_t MAX_PATCHERS = 64;
+
+    struct Shard {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<const MeshEntry>> meshes;
+    };
+
+    std::array<Shard, SHARD_COUNT> m_shards;
+    std::atomic<uint64_t> m_generation = 0; /** Bumped on every add and clear */
+    std::atomic<size_t> m_size = 0;
+
+    std::mutex m_viewMutex;
+    std::shared_ptr<const View> m_view;
+    uint64_t m_viewGeneration = 0;
+
+    static inline std::shared_mutex s_patcherNamesMutex;
+    static inline std::vector<std::string> s_patcherNames;
+    static inline std::unordered_map<std::string, PatcherMask> s_patcherBits;
+
+    static inline std::array<std::mutex, SHARD_COUNT> s_shapeNameMutexes;
+    static inline std::array<std::unordered_set<std::string>, SHARD_COUNT> s_shapeNames;
+
+public:
+    /**
+     * @brief Get the mask bit of a patcher, assigning the next free bit on first use
+     *
+     * @param patcherName Patcher name
+     * @return PatcherMask mask with the single bit of the patcher set
+     */
+    static auto getPatcherBit(const std::string& patcherName) -> PatcherMask;
+
+    /**
+     * @brief Get the names of all patchers set in a mask
+     *
+     * @param mask Patcher mask
+     * @return std::vector<std::string> patcher names in bit order
+     */
+    static auto getPatcherNames(const PatcherMask& mask) -> std::vector<std::string>;
+
+    /**
+     * @brief Interns a shape name. The returned view stays valid for the lifetime of the program
+     *
+     * @param shapeName Shape name
+     * @return std::string_view interned name
+     */
+    static auto internShapeName(const std::string& shapeName) -> std::string_view;
+
+    /**
+     * @brief Adds the metadata of a patched mesh. Thread-safe
+     *
+     * @param meshPath Mesh path
+     * @param meta Mesh metadata
+     */
+    void add(std::filesystem::path meshPath,
+             MeshMeta&& meta);
+
+    /**
+     * @brief Get an immutable snapshot of all meshes added so far. Cheap if nothing was added since the last call
+     *
+     * @return std::shared_ptr<const View> snapshot
+     */
+    auto getView() -> std::shared_ptr<const View>;
+
+    [[nodiscard]] auto empty() const -> bool;
+
+    /**
+     * @brief Removes all meshes. Views handed out before stay valid
+     */
+    void clear();
+};
@@ -1,6 +1,9 @@
 #pragma once
 
+#include "pgutil/PGNIFBlockIndex.hpp"
 #include "pgutil/PGTypes.hpp"
+#include "util/MemoryGovernor.hpp"
+#include "util/StringInterner.hpp"
 
 #include "BasicTypes.hpp"
 #include "Geometry.hpp"
@@ -8,11 +11,13 @@
 #include "Shaders.hpp"
 
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <functional>
+#include <map>
 #include <memory>
-#include <mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -23,29 +28,48 @@
  */
 class PGMeshPermutationTracker {
 public:
+    /**
+     * @brief Compact key of a record that references a mesh. Mod keys and sub-model paths are interned, which keeps
+     * the key at 8 bytes so that the NIF cache and the per-mesh maps stay small and cheap to hash.
+     */
     struct FormKey {
-        /// @brief Name of the mod file (plugin) that owns this form (e.g., L"Skyrim.esm").
-        std::wstring modKey;
+        /// @brief Interned ID of the mod file (plugin) that owns this form, 0 for the empty mod key.
+        uint16_t pluginID = 0;
+        /// @brief Interned ID of the sub-model path within the record, 0 for the primary model.
+        uint16_t subModelID = 0;
         /// @brief Numeric form ID of the record referencing this mesh.
-        unsigned int formID;
-        /// @brief Sub-model path within the record (empty for the primary model).
-        std::string subMODL;
+        uint32_t formID = 0;
 
-        auto operator==(const FormKey& other) const -> bool
-        {
-            return formID == other.formID && modKey == other.modKey && subMODL == other.subMODL;
-        }
+        /**
+         * @brief Builds a FormKey, interning the mod key and sub-model path
+         *
+         * @param modKey Name of the mod file (e.g., L"Skyrim.esm")
+         * @param formID Numeric form ID
+         * @param subMODL Sub-model path (empty for the primary model)
+         * @return FormKey compact key
+         */
+        static auto make(std::wstring_view modKey,
+                         uint32_t formID,
+                         std::string_view subMODL) -> FormKey;
 
-        auto operator<(const FormKey& other) const -> bool
-        {
-            if (modKey != other.modKey) {
-                return modKey < other.modKey;
-            }
-            if (formID != other.formID) {
-                return formID < other.formID;
-            }
-            return subMODL < other.subMODL;
-        }
+        [[nodiscard]] auto getModKey() const -> const std::wstring&;
+        [[nodiscard]] auto getSubMODL() const -> const std::string&;
+
+        auto operator==(const FormKey& other) const -> bool = default;
+
+        /// @brief Orders by the mod key and sub-model strings rather than the IDs so that the order is deterministic
+        auto operator<(const FormKey& other) const -> bool;
+
+        /**
+         * @brief Get the number of interned mod keys and sub-model paths together with the bytes they hold
+         *
+         * @return std::pair<size_t, size_t> number of strings, bytes
+         */
+        static auto getInternerStats() -> std::pair<size_t, size_t>;
+
+    private:
+        static inline StringInterner<wchar_t, uint16_t> s_modKeys;
+        static inline StringInterner<char, uint16_t> s_subModels;
     };
 
     /**
@@ -53,17 +77,23 @@ public:
      */
     struct FormKeyHash {
         /**
-         * @brief Computes a combined hash from the mod key, form ID, and sub-model path.
+         * @brief Packs the key into 64 bits and mixes it with the splitmix64 finalizer.
          *
          * @param key The FormKey to hash.
-         * @return Combined hash value.
+         * @return Hash value.
          */
         auto operator()(const FormKey& key) const -> std::size_t
         {
-            const size_t h1 = std::hash<std::wstring> {}(key.modKey);
-            const size_t h2 = std::hash<unsigned int> {}(key.formID);
-            const size_t h3 = std::hash<std::string> {}(key.subMODL);
-            return h1 ^ (h2 << 1) ^ (h3 << 2);
+            // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+            uint64_t h = (static_cast<uint64_t>(key.pluginID) << 48U) | (static_cast<uint64_t>(key.subModelID) << 32U)
+                | key.formID;
+            h ^= h >> 30U;
+            h *= 0xbf58476d1ce4e5b9ULL;
+            h ^= h >> 27U;
+            h *= 0x94d049bb133111ebULL;
+            h ^= h >> 31U;
+            // NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+            return static_cast<std::size_t>(h);
         }
     };
 
@@ -78,6 +108,18 @@ public:
         std::unordered_map<int, int> inverseIdxCorrectionsPatching;
     };
 
+    /// @brief Kind of every comparable block of a mesh, which is all that weight variants need to agree on.
+    using ShapeFingerprint = std::vector<uint8_t>;
+
+    /**
+     * @brief Fingerprints of committed weighted meshes whose other weight variant has not been committed yet.
+     *
+     * One instance is shared by the trackers of a _0/_1 pair that are patched in the same task, so it needs no lock.
+     */
+    struct WeightVariantFingerprints {
+        std::map<std::pair<std::filesystem::path, size_t>, ShapeFingerprint> pending; /** (mesh path, dup index) */
+    };
+
 private:
     std::filesystem::path m_origMeshPath;
     nifly::NifFile m_origNifFile;
@@ -91,33 +133,31 @@ private:
     nifly::NifFile m_stagedMesh;
     nifly::NifFile* m_stagedMeshPtr;
     std::unordered_map<nifly::NiObject*, int> m_stagedMeshOriginal3DIdx;
+    PGNIFBlockIndex m_stagedBlockIndex;
 
-    using AltTex3DIndices = std::unordered_set<unsigned int>;
+    WeightVariantFingerprints* m_weightVariants;
 
-    struct PathSizeHash {
-        auto operator()(const std::pair<std::filesystem::path,
-                                        size_t>& key) const noexcept -> size_t
-        {
-            const size_t h1 = std::hash<std::wstring> {}(key.first.wstring());
-            const size_t h2 = std::hash<size_t> {}(key.second);
+    static constexpr size_t PARSED_NIF_SIZE_FACTOR = 4; /** Parsed original plus staged copy per byte on disk */
+    MemoryGovernor::Reservation m_parsedNIFReservation;
 
-            // standard hash combine
-            return h1
-                ^ (h2 + 0x9e3779b97f4a7c15ULL + (h1 << 6) + (h1 >> 2)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-        }
-    };
-    static inline std::mutex s_otherWeightVariantsMutex;
-    static inline std::unordered_map<std::pair<std::filesystem::path, size_t>, nifly::NifFile, PathSizeHash>
-        s_otherWeightVariants;
+    using AltTex3DIndices = std::unordered_set<unsigned int>;
+
+    // Fingerprint block kind bits
+    static constexpr uint8_t FINGERPRINT_PARTICLE = 1U << 0U;
+    static constexpr uint8_t FINGERPRINT_SHAPE = 1U << 1U;
+    static constexpr uint8_t FINGERPRINT_TRISHAPE = 1U << 2U;
 
 public:
     /**
      * @brief Constructs a tracker for the given original mesh path.
      *
      * @param origMeshPath Relative path (within the data directory) to the source NIF file.
+     * @param weightVariants Fingerprints shared with the tracker of the other weight variant, weighted meshes are not
+     * validated if null.
      * @throws std::runtime_error if the file does not exist in the directory.
      */
-    PGMeshPermutationTracker(const std::filesystem::path& origMeshPath);
+    PGMeshPermutationTracker(const std::filesystem::path& origMeshPath,
+                             WeightVariantFingerprints* weightVariants = nullptr);
 
     // Plugin mesh staging
     /**
@@ -142,6 +182,13 @@ public:
      */
     auto stageMesh() -> nifly::NifFile*;
 
+    /**
+     * @brief Returns the block index of the staged mesh, shared with the patchers working on it.
+     *
+     * @return Block index of the NifFile returned by the last stageMesh() call.
+     */
+    auto getStagedBlockIndex() -> PGNIFBlockIndex&;
+
     /**
      * @brief Marks that the unmodified base mesh should not be written to disk even when no patches are needed.
      */
@@ -175,9 +222,21 @@ public:
                                              unsigned long long>>;
 
     /**
-     * @brief Validates all weighted mesh variants across all trackers, ensuring _0/_1 pairs are consistent.
+     * @brief Logs an error for every weighted mesh whose other weight variant was never committed.
+     *
+     * Call once both variants of a pair have been patched.
+     *
+     * @param weightVariants Fingerprints shared by the trackers of the pair.
      */
-    static void validateWeightedVariants();
+    static void reportUnmatchedWeightVariants(const WeightVariantFingerprints& weightVariants);
+
+    /**
+     * @brief Resolves the path of the corresponding weighted variant (_0/_1) for a given NIF.
+     *
+     * @param nifPath Path of the current NIF (e.g., the _1 variant).
+     * @return Path of the other weight variant (e.g., the _0 variant), or nifPath if it is not a weight variant.
+     */
+    static auto getOtherWeightVariant(const std::filesystem::path& nifPath) -> std::filesystem::path;
 
 private:
     /**
@@ -185,6 +244,29 @@ private:
      */
     void processWeightVariant();
 
+    /**
+     * @brief Builds the fingerprint compared between weight variants. Equal fingerprints are exactly the meshes that
+     * compareMesh considers equal with checkOnlyWeighted set.
+     *
+     * @param blockIndex Block index of the NIF.
+     * @return Kind of every comparable block in block order.
+     */
+    static auto getShapeFingerprint(PGNIFBlockIndex& blockIndex) -> ShapeFingerprint;
+
+    /**
+     * @brief Memory governor subsystem for NIFs held by trackers, mesh workers wait for it before parsing
+     *
+     * @return MemoryGovernor::Subsystem* subsystem
+     */
+    static auto getParsedNIFMemory() -> MemoryGovernor::Subsystem*;
+
+    /**
+     * @brief Memory governor subsystem for serialized meshes waiting in the file saver queue
+     *
+     * @return MemoryGovernor::Subsystem* subsystem
+     */
+    static auto getMeshWriteMemory() -> MemoryGovernor::Subsystem*;
+
     // Helpers
     /**
      * @brief Compares two NIF files for equivalence, optionally restricting to specific shape texture sets.
@@ -298,12 +380,4 @@ private:
                                            const std::unordered_map<nifly::NiObject*,
                                                                     int>& original3DIndices) -> std::unordered_map<int,
                                                                                                                    int>;
-
-    /**
-     * @brief Resolves the path of the corresponding weighted variant (_0/_1) for a given NIF.
-     *
-     * @param nifPath Path of the current NIF (e.g., the _1 variant).
-     * @return Path of the other weight variant (e.g., the _0 variant).
-     */
-    static auto getOtherWeightVariant(const std::filesystem::path& nifPath) -> std::filesystem::path;
 };
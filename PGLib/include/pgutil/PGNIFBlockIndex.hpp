@@ -0,0 +1,121 @@
+#pragma once
+
+#include "BasicTypes.hpp"
+#include "Geometry.hpp"
+#include "NifFile.hpp"
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Block lookup tables for one NIF, built with a single walk of the block tree and shared by the patchers and
+ * the mesh permutation tracker.
+ *
+ * The index notices added or removed blocks through the header block count and rebuilds on the next query. Patchers
+ * that re-link blocks without changing the count must call invalidate(). Not thread safe, one index belongs to the
+ * thread patching its NIF.
+ */
+class PGNIFBlockIndex {
+public:
+    struct ShapeEntry {
+        nifly::NiShape* shape = nullptr;
+        int index3D = -1; /** Index as used by plugins, particle systems take up indices as well */
+    };
+
+    /**
+     * @brief Makes an index the active one of the calling thread so that patchers constructed for its NIF share it
+     */
+    class Scope {
+    private:
+        PGNIFBlockIndex* m_prevActive;
+
+    public:
+        explicit Scope(PGNIFBlockIndex& index);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        auto operator=(const Scope&) -> Scope& = delete;
+        Scope(Scope&&) = delete;
+        auto operator=(Scope&&) -> Scope& = delete;
+    };
+
+private:
+    const nifly::NifFile* m_nif = nullptr;
+    uint32_t m_numBlocks = 0; /** Header block count at build time */
+    bool m_dirty = true;
+
+    std::unordered_map<std::string_view, std::vector<nifly::NiObject*>> m_blocksByName; /** Names are static */
+    std::unordered_map<nifly::NiObject*, std::vector<nifly::NiObject*>> m_children;
+    std::vector<ShapeEntry> m_shapes;
+    std::vector<nifly::NiObject*> m_comparableBlocks;
+    std::unordered_map<nifly::NiObject*, int> m_3dIndices;
+
+    static thread_local inline PGNIFBlockIndex* s_activeIndex = nullptr;
+
+    void ensureCurrent();
+    void rebuild();
+
+public:
+    PGNIFBlockIndex() = default;
+    explicit PGNIFBlockIndex(const nifly::NifFile* nif);
+
+    /**
+     * @brief Points the index at a NIF. The tables are built on the first query
+     *
+     * @param nif NIF to index
+     */
+    void reset(const nifly::NifFile* nif);
+
+    /**
+     * @brief Forces a rebuild on the next query
+     */
+    void invalidate();
+
+    [[nodiscard]] auto getNIF() const -> const nifly::NifFile*;
+
+    /**
+     * @brief Get all blocks of an exact block type
+     *
+     * @param blockName Block type name, e.g. nifly::NiBillboardNode::BlockName
+     * @return const std::vector<nifly::NiObject*>& blocks in tree order
+     */
+    auto getBlocksByName(std::string_view blockName) -> const std::vector<nifly::NiObject*>&;
+
+    /**
+     * @brief Get the blocks a block references in the tree
+     *
+     * @param block Block
+     * @return const std::vector<nifly::NiObject*>& children in reference order
+     */
+    auto getChildren(nifly::NiObject* block) -> const std::vector<nifly::NiObject*>&;
+
+    /**
+     * @brief Get all shapes with their 3D index
+     *
+     * @return const std::vector<ShapeEntry>& shapes in 3D index order
+     */
+    auto getShapes() -> const std::vector<ShapeEntry>&;
+
+    /**
+     * @brief Get shapes and particle systems, the blocks that take up a 3D index
+     *
+     * @return const std::vector<nifly::NiObject*>& blocks in 3D index order
+     */
+    auto getComparableBlocks() -> const std::vector<nifly::NiObject*>&;
+
+    /**
+     * @brief Get the 3D index of every shape and particle system
+     *
+     * @return const std::unordered_map<nifly::NiObject*, int>& block to 3D index
+     */
+    auto get3dIndices() -> const std::unordered_map<nifly::NiObject*, int>&;
+
+    /**
+     * @brief Get the index made active by a Scope on the calling thread, if it belongs to the given NIF
+     *
+     * @param nif NIF the caller works on
+     * @return PGNIFBlockIndex* active index or nullptr
+     */
+    static auto getActive(const nifly::NifFile* nif) -> PGNIFBlockIndex*;
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "pgutil/PGTypes.hpp"
+
+#include "NifFile.hpp"
+#include "Shaders.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Reads the shaders and texture sets of the patchable shapes of a NIF without parsing the rest of it, for
+ * texture mapping.
+ *
+ * Only the header, the child lists of nodes and the shape, BSLightingShaderProperty, BSEffectShaderProperty,
+ * BSShaderTextureSet and NiBooleanExtraData blocks are decoded. Everything else, including vertex, triangle and skin
+ * data, is skipped with the block size table. The shapes, textures and load checks match what getShaderShapes gives
+ * for the same NIF loaded with nifly.
+ *
+ * NIFs the scanner cannot vouch for are left to nifly: other versions than Skyrim LE/SE, block types that could be
+ * shapes the scanner does not know, shapes that are not reached from the root node exactly once, and anything that
+ * would make PGNIFUtil::loadNIFFromBytes throw.
+ *
+ * The shapes are kept per mesh after mapping, so that PGPatcher can tell which meshes no patcher would change before
+ * loading them.
+ */
+class PGNIFScanner {
+public:
+    /**
+     * @brief Patchable shape with a BSLightingShaderProperty
+     */
+    struct ShaderShape {
+        uint32_t shaderType = 0; /** nifly::BSLightingShaderPropertyShaderType */
+        uint32_t shaderFlags1 = 0;
+        uint32_t shaderFlags2 = 0;
+        float softLighting = 0.0F;
+        uint32_t numTextures = 0; /** Textures in the texture set block, 0 without one */
+        bool shaderPatchable = false; /** Has a texture set and is not marked PG_IGNORE, see isShaderPatchableShape */
+        PGTypes::TextureSetIDs textureSet {}; /** Interned lowercase paths, like PGNIFUtil::getTextureSlots */
+        uint32_t blockID = 0;
+        std::string name;
+
+        [[nodiscard]] auto hasShaderFlag(nifly::SkyrimShaderPropertyFlags1 flag) const -> bool;
+        [[nodiscard]] auto hasShaderFlag(nifly::SkyrimShaderPropertyFlags2 flag) const -> bool;
+    };
+
+    /**
+     * @brief Patchable shape with another shader, which no patcher changes
+     */
+    struct OtherShape {
+        uint32_t blockID = 0;
+        std::string name;
+    };
+
+    /**
+     * @brief Shapes of one NIF
+     */
+    struct MeshShapes {
+        std::vector<ShaderShape> shapes; /** Tree order of the scanner, which is not the 3D index order */
+        std::vector<OtherShape> otherShapes; /** Same order as shapes */
+        bool hasBillboardNodes = false;
+    };
+
+    /**
+     * @brief Counters over all scans since program start
+     */
+    struct Stats {
+        size_t scanned; /** NIFs read by the scanner */
+        size_t fallbacks; /** NIFs left to nifly */
+        size_t bytesSkipped; /** Bytes of blocks the scanner never decoded */
+    };
+
+private:
+    static inline std::atomic<size_t> s_scanned {0};
+    static inline std::atomic<size_t> s_fallbacks {0};
+    static inline std::atomic<size_t> s_bytesSkipped {0};
+
+public:
+    /**
+     * @brief Scan a NIF in memory
+     *
+     * @param nifBytes NIF file
+     * @return std::optional<MeshShapes> shapes, nullopt if the NIF has to be loaded with nifly
+     */
+    static auto scan(const std::vector<std::byte>& nifBytes) -> std::optional<MeshShapes>;
+
+    /**
+     * @brief Same result as scan from a NIF loaded with nifly
+     *
+     * @param nif NIF
+     * @return MeshShapes shapes in tree order
+     */
+    static auto getShaderShapes(nifly::NifFile& nif) -> MeshShapes;
+
+    [[nodiscard]] static auto getStats() -> Stats;
+
+    /**
+     * @brief Logs the counters at debug level
+     */
+    static void logStats();
+};
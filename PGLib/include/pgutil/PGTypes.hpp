@@ -4,9 +4,12 @@
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <functional>
 #include <string>
+#include <string_view>
+#include <utility>
 
 constexpr unsigned NUM_TEXTURE_SLOTS = 9;
 
@@ -18,6 +21,8 @@ namespace PGTypes {
 using TextureSet = std::array<std::wstring, NUM_TEXTURE_SLOTS>;
 /// @brief Array of narrow-string texture paths indexed by texture slot (up to NUM_TEXTURE_SLOTS entries).
 using TextureSetStr = std::array<std::string, NUM_TEXTURE_SLOTS>;
+/// @brief Array of interned texture path IDs indexed by texture slot, 0 is the empty path.
+using TextureSetIDs = std::array<uint32_t, NUM_TEXTURE_SLOTS>;
 
 /**
  * @brief Hash functor for TextureSet, enabling use as an unordered_map/unordered_set key.
@@ -59,6 +64,29 @@ auto getTextureSlotsFromStr(const std::string& slots) -> TextureSet;
  */
 auto getStrFromTextureSlots(const TextureSet& slots) -> std::string;
 
+/**
+ * @brief Interns a texture path so that texture sets repeated across many mesh uses share one copy of each path.
+ *
+ * @param path Texture path
+ * @return uint32_t ID of the path
+ */
+auto internTexturePath(std::wstring_view path) -> uint32_t;
+
+/**
+ * @brief Resolves interned slot IDs back into a TextureSet.
+ *
+ * @param ids IDs returned by internTexturePath().
+ * @return TextureSet with the interned paths.
+ */
+auto resolveTextureSet(const TextureSetIDs& ids) -> TextureSet;
+
+/**
+ * @brief Get the number of interned texture paths together with the bytes they hold.
+ *
+ * @return std::pair<size_t, size_t> number of paths, bytes
+ */
+auto getTexturePathInternerStats() -> std::pair<size_t, size_t>;
+
 /// @brief texture used by parallaxgen with type
 struct PGTexture {
     /// @brief relative path in the data directory
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <DirectXTex.h>
+#include <dxgiformat.h>
+
+#include <cstdint>
+#include <winnt.h>
+
+/**
+ * @brief CPU block compressor for BC1/BC2/BC3 textures with selectable quality tiers.
+ *
+ * Every mip level and array slice is split into rows of 4x4 blocks which are encoded in parallel. Formats that are
+ * not handled natively (BC7 and friends) and the REFERENCE tier are passed through to DirectXTex.
+ */
+namespace BCEncoder {
+
+/**
+ * @brief Quality tiers for block compression.
+ */
+enum class Quality : uint8_t {
+    FAST, /** Inset bounding box endpoints, single index pass */
+    NORMAL, /** Principal axis endpoints with a least squares refinement pass */
+    REFERENCE /** DirectXTex reference encoder (slowest, used for comparisons) */
+};
+
+/**
+ * @brief Checks whether a BC format is encoded by this module instead of DirectXTex.
+ *
+ * @param format Target compressed format.
+ * @return true if the format is encoded natively.
+ */
+auto isNativeFormat(const DXGI_FORMAT& format) -> bool;
+
+/**
+ * @brief Compresses all images (mips, array slices) of an image to a BC format.
+ *
+ * Native encoding requires an R8G8B8A8_UNORM source. Any other source format, non-native target format or the
+ * REFERENCE tier falls back to DirectX::Compress.
+ *
+ * @param source Uncompressed source image.
+ * @param format Target compressed format.
+ * @param quality Quality tier to use.
+ * @param[out] out Compressed image.
+ * @return HRESULT S_OK on success.
+ */
+auto compress(const DirectX::ScratchImage& source,
+              const DXGI_FORMAT& format,
+              const Quality& quality,
+              DirectX::ScratchImage& out) -> HRESULT;
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Batched float kernels for mesh geometry and vertex colors.
+ *
+ * Inputs are in structure of arrays layout. AVX2 is used when the CPU and OS support it, SSE2 otherwise and plain
+ * loops on other targets, picked once at runtime. Every path does the same IEEE operations in the same order per
+ * element and sums into the same lanes, so results never depend on the CPU.
+ */
+namespace GeometryKernels {
+
+constexpr size_t NUM_LANES = 8;
+
+/**
+ * @brief Edges of up to CAPACITY triangles, edge 1 is p2 - p1 and edge 2 is p3 - p1
+ */
+struct TriangleEdgeBlock {
+    static constexpr size_t CAPACITY = 256; /** Multiple of NUM_LANES */
+
+    alignas(32) std::array<float, CAPACITY> uv1U {};
+    alignas(32) std::array<float, CAPACITY> uv1V {};
+    alignas(32) std::array<float, CAPACITY> uv2U {};
+    alignas(32) std::array<float, CAPACITY> uv2V {};
+    alignas(32) std::array<float, CAPACITY> pos1X {};
+    alignas(32) std::array<float, CAPACITY> pos1Y {};
+    alignas(32) std::array<float, CAPACITY> pos1Z {};
+    alignas(32) std::array<float, CAPACITY> pos2X {};
+    alignas(32) std::array<float, CAPACITY> pos2Y {};
+    alignas(32) std::array<float, CAPACITY> pos2Z {};
+    size_t size = 0;
+};
+
+/**
+ * @brief Per lane sums of inverse UV density. Triangle i of a block is added to lane i % NUM_LANES
+ */
+struct UVDensitySums {
+    alignas(32) std::array<float, NUM_LANES> u {};
+    alignas(32) std::array<float, NUM_LANES> v {};
+
+    /**
+     * @brief Sum of all lanes, always added in the same order
+     */
+    [[nodiscard]] auto totalU() const -> float;
+    [[nodiscard]] auto totalV() const -> float;
+};
+
+/**
+ * @brief Adds 1 / ((|uv1| + |uv2|) / (length(pos1) + length(pos2))) per UV component for every triangle of the block
+ *
+ * @param block Triangle edges
+ * @param sums Sums to add to
+ */
+void accumulateInverseUVDensity(const TriangleEdgeBlock& block,
+                                UVDensitySums& sums);
+
+/**
+ * @brief Lightness and saturation change for adjustHSL
+ */
+struct HSLAdjust {
+    bool scaleLightness = false; /** L = 1 - (1 - L) * lightnessMult */
+    float lightnessMult = 1.0F;
+    bool scaleSaturation = false; /** S = S * saturationMult */
+    float saturationMult = 1.0F;
+};
+
+/**
+ * @brief Converts 8-bit colors to HSL, applies the adjustment, clamps S and L to [0, 1] and converts back in place.
+ * Results are identical to boost::gil color_convert between rgb8_pixel_t and hsl32f_pixel_t.
+ *
+ * @param red Red channel
+ * @param green Green channel
+ * @param blue Blue channel
+ * @param count Number of colors
+ * @param adjust Change to apply
+ */
+void adjustHSL(uint8_t* red,
+               uint8_t* green,
+               uint8_t* blue,
+               size_t count,
+               const HSLAdjust& adjust);
+
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Compiled set of MS-DOS style globs with PathMatchSpecW semantics, usable on any platform.
+ *
+ * A * matches any number of any character including slashes, a ? matches exactly one character. A glob may hold
+ * several patterns separated by ; with leading spaces ignored, and the glob *.* matches everything. Matching is case
+ * insensitive for ASCII.
+ *
+ * Patterns are sorted into buckets when the set is built. Literal patterns and patterns that are a literal prefix or
+ * suffix around a single * are answered with one hash lookup per distinct length, only the remaining patterns are
+ * matched one by one.
+ */
+class GlobSet {
+private:
+    /** Pattern that needs the generic matcher, segments are the parts between the stars */
+    struct WildcardPattern {
+        size_t globIdx;
+        std::vector<std::wstring> segments;
+        bool hasStar;
+        size_t minLength; /** Sum of all segment lengths */
+    };
+
+    /** Literals of one length, keyed by views into m_storage, value is the lowest glob index */
+    struct LiteralBucket {
+        size_t length;
+        std::unordered_map<std::wstring_view, size_t> globIndices;
+    };
+
+    std::deque<std::wstring> m_storage;
+    std::unordered_map<std::wstring_view, size_t> m_exact;
+    std::vector<LiteralBucket> m_prefixes; /** literal* */
+    std::vector<LiteralBucket> m_suffixes; /** *literal */
+    std::vector<WildcardPattern> m_wildcards; /** Sorted by glob index */
+    std::optional<size_t> m_matchAll;
+    size_t m_numGlobs = 0;
+
+    void addPattern(std::wstring_view pattern,
+                    size_t globIdx);
+    static void addToBucket(std::vector<LiteralBucket>& buckets,
+                            std::wstring_view literal,
+                            size_t globIdx);
+    static void lookupBucket(const std::vector<LiteralBucket>& buckets,
+                             std::wstring_view path,
+                             bool fromFront,
+                             std::optional<size_t>& best);
+
+    static auto matchSegment(std::wstring_view text,
+                             std::wstring_view segment) -> bool;
+    static auto matchWildcard(const WildcardPattern& pattern,
+                              std::wstring_view path) -> bool;
+
+public:
+    GlobSet() = default;
+    ~GlobSet() = default;
+
+    // the lookup tables hold views into m_storage, a copy would point into the source. A moved deque keeps its
+    // elements in place, so moving is safe
+    GlobSet(const GlobSet&) = delete;
+    auto operator=(const GlobSet&) -> GlobSet& = delete;
+    GlobSet(GlobSet&&) noexcept = default;
+    auto operator=(GlobSet&&) noexcept -> GlobSet& = default;
+
+    /**
+     * @brief Compiles a list of globs
+     *
+     * @param globs Globs in priority order
+     */
+    explicit GlobSet(const std::vector<std::wstring>& globs);
+
+    /**
+     * @brief Find the first glob in the list that matches a path
+     *
+     * @param path Path to check, any case
+     * @return std::optional<size_t> index of the matching glob in the list passed to the constructor
+     */
+    [[nodiscard]] auto findMatch(std::wstring_view path) const -> std::optional<size_t>;
+
+    /**
+     * @brief Same as findMatch for a path that is already lower case, which saves the case conversion
+     *
+     * @param lowerPath Lower case path to check
+     * @return std::optional<size_t> index of the matching glob
+     */
+    [[nodiscard]] auto findMatchLower(std::wstring_view lowerPath) const -> std::optional<size_t>;
+
+    /**
+     * @brief Check if any glob matches a path
+     *
+     * @param path Path to check, any case
+     * @return true if any glob matches
+     */
+    [[nodiscard]] auto matches(std::wstring_view path) const -> bool;
+
+    [[nodiscard]] auto empty() const -> bool;
+};
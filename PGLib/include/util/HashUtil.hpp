@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief Checksums and content hashes.
+ *
+ * The CRC32 is the zlib/boost::crc_32_type CRC, so values are interchangeable with the ones already stored in
+ * ParallaxGen_Diff.json. It uses PCLMULQDQ folding when the CPU has it and slicing-by-16 otherwise, picked once at
+ * runtime. The content hash is a 128-bit non-cryptographic hash in the style of XXH3 for content addressed caches, it
+ * is not bit compatible with XXH3 and must not be persisted across versions without a version tag.
+ */
+namespace HashUtil {
+
+/**
+ * @brief Compute or continue a CRC32
+ *
+ * @param data Bytes to add
+ * @param size Number of bytes
+ * @param crc CRC32 of the bytes before, 0 to start a new checksum
+ * @return uint32_t CRC32 of everything so far, identical to boost::crc_32_type
+ */
+auto crc32(const void* data,
+           size_t size,
+           uint32_t crc = 0) -> uint32_t;
+
+/**
+ * @brief CRC32 of two concatenated blocks from the CRC32 of each block, like zlib's crc32_combine. O(log len2)
+ *
+ * @param crc1 CRC32 of the first block
+ * @param crc2 CRC32 of the second block
+ * @param len2 Length of the second block
+ * @return uint32_t CRC32 of both blocks
+ */
+auto crc32Combine(uint32_t crc1,
+                  uint32_t crc2,
+                  size_t len2) -> uint32_t;
+
+/**
+ * @brief Name of the CRC32 implementation picked for this CPU, for log output
+ */
+auto getCRC32Implementation() -> std::string_view;
+
+/**
+ * @brief 128-bit content hash
+ */
+struct Hash128 {
+    uint64_t low;
+    uint64_t high;
+
+    auto operator==(const Hash128& other) const -> bool = default;
+};
+
+/**
+ * @brief Streaming 128-bit content hash. Feeding the same bytes in any split gives the same hash
+ */
+class ContentHasher {
+public:
+    static constexpr size_t NUM_LANES = 8;
+    static constexpr size_t STRIPE_SIZE = NUM_LANES * sizeof(uint64_t);
+    static constexpr size_t STRIPES_PER_BLOCK = 16;
+
+private:
+    alignas(16) std::array<uint64_t, NUM_LANES> m_acc {};
+    alignas(16) std::array<uint8_t, STRIPE_SIZE> m_buffer {};
+    size_t m_bufferSize = 0;
+    size_t m_stripeInBlock = 0;
+    uint64_t m_totalSize = 0;
+
+    void consumeStripe(const uint8_t* stripe);
+
+public:
+    ContentHasher();
+
+    /**
+     * @brief Add bytes to the hash
+     *
+     * @param data Bytes to add
+     * @param size Number of bytes
+     */
+    void update(const void* data,
+                size_t size);
+
+    /**
+     * @brief Get the hash of everything added so far. More bytes can be added afterwards
+     *
+     * @return Hash128 hash
+     */
+    [[nodiscard]] auto digest() const -> Hash128;
+
+    /**
+     * @brief Start over with no bytes
+     */
+    void reset();
+};
+
+/**
+ * @brief 128-bit content hash of one buffer
+ *
+ * @param data Bytes to hash
+ * @param size Number of bytes
+ * @return Hash128 same value as a ContentHasher fed the same bytes
+ */
+auto hash128(const void* data,
+             size_t size) -> Hash128;
+
+}
@@ -4,13 +4,19 @@
 #include <spdlog/common.h>
 #include <spdlog/spdlog.h>
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <fmt/base.h>
 #include <fmt/format.h>
 #include <fmt/xchar.h>
+#include <functional>
 #include <mutex>
 #include <shared_mutex>
 #include <string>
-#include <unordered_set>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -19,16 +25,30 @@
  * @brief Thread-safe logging facade built on top of spdlog with deduplication and prefix support.
  *
  * Features:
- * - Duplicate-message suppression: identical messages (critical/error/warn) are logged only once.
+ * - Duplicate-message suppression: identical messages (critical/error/warn) are logged only once. Messages are
+ *   tracked as 64-bit hashes in a sharded table with a configurable capacity.
  * - Scoped prefix stack: Prefix objects push/pop bracket-enclosed labels for debug/trace messages.
- * - Threaded buffer mode: worker threads accumulate log entries that are flushed atomically via
- *   flushThreadedBuffer() to avoid interleaved output.
+ * - Disabled levels are free: arguments are not formatted and prefixes are not materialized unless the
+ *   level is enabled.
+ * - Threaded buffer mode: worker threads accumulate log entries without taking the global log lock. They are
+ *   flushed atomically via flushThreadedBuffer() to avoid interleaved output.
  * - Overloads for both std::string (UTF-8) and std::wstring (UTF-16) format strings.
  */
 class Logger {
 private:
-    inline static std::unordered_set<std::wstring> s_existingMessages;
-    inline static std::shared_mutex s_existingMessagesMutex;
+    // Duplicate-message suppression: 64-bit message hashes spread over independently locked, fixed-capacity shards
+    static constexpr size_t DEDUP_SHARD_COUNT = 64;
+    static constexpr size_t DEFAULT_DEDUP_CAPACITY = 1ULL << 20;
+
+    struct DedupShard {
+        std::mutex mutex;
+        std::vector<uint64_t> slots; // open addressing, 0 marks an empty slot
+        size_t size = 0;
+    };
+    static std::array<DedupShard, DEDUP_SHARD_COUNT> s_dedupShards;
+    inline static std::atomic<size_t> s_dedupShardCapacity = DEFAULT_DEDUP_CAPACITY / DEDUP_SHARD_COUNT;
+    inline static std::atomic<uint64_t> s_suppressedMessages;
+    inline static std::atomic<uint64_t> s_untrackedMessages;
 
     inline static std::shared_mutex s_mtLogLock;
     inline thread_local static std::vector<
@@ -40,34 +60,46 @@ private:
     static auto buildPrefixWString() -> std::wstring;
     static auto buildPrefixString() -> std::string;
 
-    static auto processMessage(const std::wstring& message) -> bool
-    {
-        {
-            const std::shared_lock lock(s_existingMessagesMutex);
-            if (s_existingMessages.contains(message)) {
-                // don't log anything if already logged
-                return false;
-            }
-        }
+    /**
+     * @brief Checks whether prefixes are used by any enabled level (only debug/trace messages carry prefixes).
+     *
+     * @return true if prefixes should be materialized
+     */
+    static auto isPrefixEnabled() -> bool { return shouldLog(spdlog::level::debug); }
 
-        {
-            const std::unique_lock lock(s_existingMessagesMutex);
-            const auto [_, inserted] = s_existingMessages.insert(message);
-            return inserted; // true only for the first thread
-        }
-    }
+    /**
+     * @brief Records a message hash and checks whether the message was seen before.
+     *
+     * Once a shard is full, new messages are no longer tracked and are always logged.
+     *
+     * @param messageHash hash of the fully formatted message
+     * @return true if the message should be logged
+     */
+    static auto processMessage(uint64_t messageHash) -> bool;
 
-    template <typename... Args> static auto shouldLogString(const std::wstring& fmt) -> bool
+    static auto shouldLogString(const std::wstring& message) -> bool
     {
-        return processMessage(fmt);
+        return processMessage(std::hash<std::wstring_view> {}(message));
     }
 
-    template <typename... Args> static auto shouldLogString(const std::string& fmt) -> bool
+    static auto shouldLogString(const std::string& message) -> bool
     {
-        return processMessage(StringUtil::utf8toUTF16(fmt));
+        // narrow messages are hashed as UTF-8 to avoid converting every message
+        return processMessage(std::hash<std::string_view> {}(message));
     }
 
 public:
+    /**
+     * @brief Checks whether a message at the given level would be emitted by the default logger.
+     *
+     * Log calls already perform this check before formatting. Use it directly to skip building expensive
+     * arguments for disabled levels.
+     *
+     * @param level spdlog level to check
+     * @return true if messages at this level are emitted
+     */
+    static auto shouldLog(const spdlog::level::level_enum& level) -> bool { return spdlog::should_log(level); }
+
     /**
      * @brief RAII guard that pushes a label onto the thread-local prefix stack for debug/trace messages.
      *
@@ -75,23 +107,94 @@ public:
      * while this object is alive. The prefix is automatically removed when the object is destroyed.
      */
     class Prefix {
+    private:
+        bool m_pushed = false;
+
+        /**
+         * @brief Pushes an already materialized label onto the thread-local prefix stack.
+         *
+         * @param prefix Label text to push.
+         */
+        void push(std::wstring&& prefix);
+
+        /**
+         * @brief Converts UTF-8 std::string arguments of a wide format, other arguments are passed through.
+         *
+         * @tparam T Type of the argument.
+         * @param arg Format argument.
+         * @return decltype(auto) UTF-16 string or the argument itself.
+         */
+        template <typename T> static auto widenArg(T&& arg) -> decltype(auto)
+        {
+            if constexpr (std::is_same_v<std::remove_cvref_t<T>, std::string>) {
+                return StringUtil::utf8toUTF16(arg);
+            } else {
+                return std::forward<T>(arg);
+            }
+        }
+
     public:
         /**
          * @brief Pushes a wide-string prefix label onto the thread-local prefix stack.
          *
+         * Nothing is stored if debug/trace messages are disabled.
+         *
          * @param prefix Label text to prepend to debug/trace messages.
          */
-        explicit Prefix(const std::wstring& prefix);
+        explicit Prefix(std::wstring_view prefix);
 
         /**
          * @brief Pushes a UTF-8 string prefix label onto the thread-local prefix stack.
          *
+         * Nothing is stored if debug/trace messages are disabled.
+         *
          * @param prefix Label text to prepend to debug/trace messages.
          */
-        explicit Prefix(const std::string& prefix);
+        explicit Prefix(std::string_view prefix);
+
+        /**
+         * @brief Pushes a formatted wide-string prefix label onto the thread-local prefix stack.
+         *
+         * The label is only formatted if debug/trace messages are enabled, so callers should pass the raw
+         * parts of the label instead of concatenating them beforehand. UTF-8 std::string arguments are converted
+         * only then as well.
+         *
+         * @tparam Args Types of the format arguments.
+         * @param fmt Wide-string fmt format string.
+         * @param moreArgs Arguments forwarded to fmt::format.
+         */
+        template <typename... Args>
+            requires(sizeof...(Args) > 0)
+        explicit Prefix(std::wstring_view fmt,
+                        Args&&... moreArgs)
+        {
+            if (isPrefixEnabled()) {
+                push(fmt::format(fmt::runtime(fmt), widenArg(std::forward<Args>(moreArgs))...));
+            }
+        }
+
+        /**
+         * @brief Pushes a formatted UTF-8 prefix label onto the thread-local prefix stack.
+         *
+         * The label is only formatted if debug/trace messages are enabled, so callers should pass the raw
+         * parts of the label instead of concatenating them beforehand.
+         *
+         * @tparam Args Types of the format arguments.
+         * @param fmt Narrow fmt format string.
+         * @param moreArgs Arguments forwarded to fmt::format.
+         */
+        template <typename... Args>
+            requires(sizeof...(Args) > 0)
+        explicit Prefix(std::string_view fmt,
+                        Args&&... moreArgs)
+        {
+            if (isPrefixEnabled()) {
+                push(StringUtil::utf8toUTF16(fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...)));
+            }
+        }
 
         /**
-         * @brief Pops this prefix label from the thread-local prefix stack.
+         * @brief Pops this prefix label from the thread-local prefix stack if it was pushed.
          */
         ~Prefix();
 
@@ -101,6 +204,29 @@ public:
         auto operator=(Prefix&&) -> Prefix& = delete;
     };
 
+    /**
+     * @brief Sets the total number of distinct messages tracked for duplicate suppression.
+     *
+     * Should be called before logging starts. Messages beyond the capacity are always logged.
+     *
+     * @param capacity maximum number of tracked message hashes
+     */
+    static void setDedupCapacity(const size_t& capacity);
+
+    /**
+     * @brief Gets the number of duplicate critical/error/warn messages that were suppressed.
+     *
+     * @return number of suppressed messages
+     */
+    static auto getSuppressedDuplicateCount() -> uint64_t;
+
+    /**
+     * @brief Gets the number of messages that could not be tracked because the dedup table was full.
+     *
+     * @return number of untracked messages
+     */
+    static auto getUntrackedMessageCount() -> uint64_t;
+
     /**
      * @brief Activates the thread-local buffered logging mode and clears any previous buffer contents.
      *
@@ -128,18 +254,21 @@ public:
     static void critical(const std::wstring& fmt,
                          Args&&... moreArgs)
     {
-        const std::shared_lock lock(s_mtLogLock);
+        if (!shouldLog(spdlog::level::critical)) {
+            return;
+        }
 
-        const auto resolvedStr = fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
+        auto resolvedStr = fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
         if (!shouldLogString(resolvedStr)) {
             return;
         }
 
         if (s_isThreadedBufferActive) {
-            s_curBuffer.emplace_back(spdlog::level::critical, resolvedStr);
+            s_curBuffer.emplace_back(spdlog::level::critical, std::move(resolvedStr));
             return;
         }
 
+        const std::shared_lock lock(s_mtLogLock);
         spdlog::critical(L"{}", resolvedStr);
     }
 
@@ -154,18 +283,21 @@ public:
     static void error(const std::wstring& fmt,
                       Args&&... moreArgs)
     {
-        const std::shared_lock lock(s_mtLogLock);
+        if (!shouldLog(spdlog::level::err)) {
+            return;
+        }
 
-        const auto resolvedStr = fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
+        auto resolvedStr = fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
         if (!shouldLogString(resolvedStr)) {
             return;
         }
 
         if (s_isThreadedBufferActive) {
-            s_curBuffer.emplace_back(spdlog::level::err, resolvedStr);
+            s_curBuffer.emplace_back(spdlog::level::err, std::move(resolvedStr));
             return;
         }
 
+        const std::shared_lock lock(s_mtLogLock);
         spdlog::error(L"{}", resolvedStr);
     }
 
@@ -180,18 +312,21 @@ public:
     static void warn(const std::wstring& fmt,
                      Args&&... moreArgs)
     {
-        const std::shared_lock lock(s_mtLogLock);
+        if (!shouldLog(spdlog::level::warn)) {
+            return;
+        }
 
-        const auto resolvedStr = fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
+        auto resolvedStr = fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
         if (!shouldLogString(resolvedStr)) {
             return;
         }
 
         if (s_isThreadedBufferActive) {
-            s_curBuffer.emplace_back(spdlog::level::warn, resolvedStr);
+            s_curBuffer.emplace_back(spdlog::level::warn, std::move(resolvedStr));
             return;
         }
 
+        const std::shared_lock lock(s_mtLogLock);
         spdlog::warn(L"{}", resolvedStr);
     }
 
@@ -206,14 +341,17 @@ public:
     static void info(const std::wstring& fmt,
                      Args&&... moreArgs)
     {
-        const std::shared_lock lock(s_mtLogLock);
+        if (!shouldLog(spdlog::level::info)) {
+            return;
+        }
 
-        const auto resolvedStr = fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
+        auto resolvedStr = fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
         if (s_isThreadedBufferActive) {
-            s_curBuffer.emplace_back(spdlog::level::info, resolvedStr);
+            s_curBuffer.emplace_back(spdlog::level::info, std::move(resolvedStr));
             return;
         }
 
+        const std::shared_lock lock(s_mtLogLock);
         spdlog::info(L"{}", resolvedStr);
     }
 
@@ -228,14 +366,17 @@ public:
     static void debug(const std::wstring& fmt,
                       Args&&... moreArgs)
     {
-        const std::shared_lock lock(s_mtLogLock);
+        if (!shouldLog(spdlog::level::debug)) {
+            return;
+        }
 
-        const auto resolvedStr = buildPrefixWString() + fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
+        auto resolvedStr = buildPrefixWString() + fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
         if (s_isThreadedBufferActive) {
-            s_curBuffer.emplace_back(spdlog::level::debug, resolvedStr);
+            s_curBuffer.emplace_back(spdlog::level::debug, std::move(resolvedStr));
             return;
         }
 
+        const std::shared_lock lock(s_mtLogLock);
         spdlog::debug(L"{}", resolvedStr);
     }
 
@@ -250,14 +391,17 @@ public:
     static void trace(const std::wstring& fmt,
                       Args&&... moreArgs)
     {
-        const std::shared_lock lock(s_mtLogLock);
+        if (!shouldLog(spdlog::level::trace)) {
+            return;
+        }
 
-        const auto resolvedStr = buildPrefixWString() + fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
+        auto resolvedStr = buildPrefixWString() + fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
         if (s_isThreadedBufferActive) {
-            s_curBuffer.emplace_back(spdlog::level::trace, resolvedStr);
+            s_curBuffer.emplace_back(spdlog::level::trace, std::move(resolvedStr));
             return;
         }
 
+        const std::shared_lock lock(s_mtLogLock);
         spdlog::trace(L"{}", resolvedStr);
     }
 
@@ -272,18 +416,21 @@ public:
     static void critical(const std::string& fmt,
                          Args&&... moreArgs)
     {
-        const std::shared_lock lock(s_mtLogLock);
+        if (!shouldLog(spdlog::level::critical)) {
+            return;
+        }
 
-        const auto resolvedStr = fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
+        auto resolvedStr = fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
         if (!shouldLogString(resolvedStr)) {
             return;
         }
 
         if (s_isThreadedBufferActive) {
-            s_curBuffer.emplace_back(spdlog::level::critical, resolvedStr);
+            s_curBuffer.emplace_back(spdlog::level::critical, std::move(resolvedStr));
             return;
         }
 
+        const std::shared_lock lock(s_mtLogLock);
         spdlog::critical("{}", resolvedStr);
     }
 
@@ -298,18 +445,21 @@ public:
     static void error(const std::string& fmt,
                       Args&&... moreArgs)
     {
-        const std::shared_lock lock(s_mtLogLock);
+        if (!shouldLog(spdlog::level::err)) {
+            return;
+        }
 
-        const auto resolvedStr = fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
+        auto resolvedStr = fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
         if (!shouldLogString(resolvedStr)) {
             return;
         }
 
         if (s_isThreadedBufferActive) {
-            s_curBuffer.emplace_back(spdlog::level::err, resolvedStr);
+            s_curBuffer.emplace_back(spdlog::level::err, std::move(resolvedStr));
             return;
         }
 
+        const std::shared_lock lock(s_mtLogLock);
         spdlog::error("{}", resolvedStr);
     }
 
@@ -324,18 +474,21 @@ public:
     static void warn(const std::string& fmt,
                      Args&&... moreArgs)
     {
-        const std::shared_lock lock(s_mtLogLock);
+        if (!shouldLog(spdlog::level::warn)) {
+            return;
+        }
 
-        const auto resolvedStr = fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
+        auto resolvedStr = fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
         if (!shouldLogString(resolvedStr)) {
             return;
         }
 
         if (s_isThreadedBufferActive) {
-            s_curBuffer.emplace_back(spdlog::level::warn, resolvedStr);
+            s_curBuffer.emplace_back(spdlog::level::warn, std::move(resolvedStr));
             return;
         }
 
+        const std::shared_lock lock(s_mtLogLock);
         spdlog::warn("{}", resolvedStr);
     }
 
@@ -350,14 +503,17 @@ public:
     static void info(const std::string& fmt,
                      Args&&... moreArgs)
     {
-        const std::shared_lock lock(s_mtLogLock);
+        if (!shouldLog(spdlog::level::info)) {
+            return;
+        }
 
-        const auto resolvedStr = fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
+        auto resolvedStr = fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
         if (s_isThreadedBufferActive) {
-            s_curBuffer.emplace_back(spdlog::level::info, resolvedStr);
+            s_curBuffer.emplace_back(spdlog::level::info, std::move(resolvedStr));
             return;
         }
 
+        const std::shared_lock lock(s_mtLogLock);
         spdlog::info("{}", resolvedStr);
     }
 
@@ -372,14 +528,17 @@ public:
     static void debug(const std::string& fmt,
                       Args&&... moreArgs)
     {
-        const std::shared_lock lock(s_mtLogLock);
+        if (!shouldLog(spdlog::level::debug)) {
+            return;
+        }
 
-        const auto resolvedStr = buildPrefixString() + fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
+        auto resolvedStr = buildPrefixString() + fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
         if (s_isThreadedBufferActive) {
-            s_curBuffer.emplace_back(spdlog::level::debug, resolvedStr);
+            s_curBuffer.emplace_back(spdlog::level::debug, std::move(resolvedStr));
             return;
         }
 
+        const std::shared_lock lock(s_mtLogLock);
         spdlog::debug("{}", resolvedStr);
     }
 
@@ -394,14 +553,17 @@ public:
     static void trace(const std::string& fmt,
                       Args&&... moreArgs)
     {
-        const std::shared_lock lock(s_mtLogLock);
+        if (!shouldLog(spdlog::level::trace)) {
+            return;
+        }
 
-        const auto resolvedStr = buildPrefixString() + fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
+        auto resolvedStr = buildPrefixString() + fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
         if (s_isThreadedBufferActive) {
-            s_curBuffer.emplace_back(spdlog::level::trace, resolvedStr);
+            s_curBuffer.emplace_back(spdlog::level::trace, std::move(resolvedStr));
             return;
         }
 
+        const std::shared_lock lock(s_mtLogLock);
         spdlog::trace("{}", resolvedStr);
     }
 };
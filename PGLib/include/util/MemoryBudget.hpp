@@ -0,0 +1,96 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief Thread-safe byte budget used to bound how much memory a producer may hold at once.
+ *
+ * Producers call acquire() before allocating and release() once the memory is freed. acquire() blocks while the
+ * budget is exhausted. A single request larger than the whole budget is allowed through once nothing else is held so
+ * that oversized items cannot deadlock the caller. cancel() wakes every waiting producer without reserving anything, so
+ * that a consumer shutting down cannot leave producers blocked.
+ */
+class MemoryBudget {
+private:
+    std::string m_name;
+    size_t m_budget; /** Budget in bytes, 0 means unlimited */
+    size_t m_used = 0;
+    size_t m_peak = 0;
+    bool m_cancelled = false;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+
+public:
+    /**
+     * @brief Constructs a MemoryBudget.
+     *
+     * @param name Human-readable name used in log output.
+     * @param budget Budget in bytes (0 for unlimited).
+     */
+    MemoryBudget(std::string name,
+                 const size_t& budget = 0);
+
+    /**
+     * @brief Changes the budget. Waiting producers are re-evaluated against the new budget.
+     *
+     * @param budget Budget in bytes (0 for unlimited).
+     */
+    void setBudget(const size_t& budget);
+
+    /**
+     * @brief Blocks until the requested bytes fit in the budget, then reserves them.
+     *
+     * @param bytes Number of bytes to reserve.
+     * @return true if the bytes were reserved, false if the budget was cancelled (nothing is reserved).
+     */
+    [[nodiscard]] auto acquire(const size_t& bytes) -> bool;
+
+    /**
+     * @brief Reserves bytes without waiting, even if this exceeds the budget.
+     *
+     * Used to correct an estimate once the real size is known, since blocking there could deadlock.
+     *
+     * @param bytes Number of bytes to reserve.
+     */
+    void forceAcquire(const size_t& bytes);
+
+    /**
+     * @brief Returns previously reserved bytes to the budget and wakes waiting producers.
+     *
+     * @param bytes Number of bytes to release.
+     */
+    void release(const size_t& bytes);
+
+    /**
+     * @brief Replaces an existing reservation with a new size without blocking.
+     *
+     * @param oldBytes Currently reserved bytes.
+     * @param newBytes Bytes to reserve instead.
+     */
+    void adjust(const size_t& oldBytes,
+                const size_t& newBytes);
+
+    /**
+     * @brief Makes every waiting and future acquire() return false until resume() is called.
+     */
+    void cancel();
+
+    /**
+     * @brief Lets acquire() reserve bytes again after cancel().
+     */
+    void resume();
+
+    [[nodiscard]] auto getName() const -> const std::string&;
+    [[nodiscard]] auto getBudget() const -> size_t;
+    [[nodiscard]] auto getUsed() const -> size_t;
+    [[nodiscard]] auto getPeak() const -> size_t;
+
+    /**
+     * @brief Resets the high-water mark to the current usage.
+     */
+    void resetPeak();
+};
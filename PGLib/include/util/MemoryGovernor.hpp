@@ -0,0 +1,166 @@
+#pragma once
+
+#include "util/MemoryBudget.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Process-wide memory governor that ties caches and producer queues to a single byte budget.
+ *
+ * Every subsystem that holds a meaningful amount of memory registers itself and reports what it holds. Caches register
+ * an evict callback and are asked to shrink when the total goes over budget. Producers call acquire(), which first
+ * evicts caches and then blocks until consumers released enough memory. Existing MemoryBudget instances can be attached
+ * so that their usage counts toward the total and their high-water mark shows up in the summary.
+ *
+ * Lock order: charge() and release() may be called while holding a cache lock, reclaim() and acquire() must not be,
+ * since they call the evict callbacks of other caches.
+ */
+class MemoryGovernor {
+public:
+    /** Called with the number of bytes the governor wants back. Must release() what it frees */
+    using EvictFunc = std::function<void(size_t)>;
+
+    struct Subsystem {
+        std::string name;
+        EvictFunc evict;
+        size_t used = 0;
+        size_t peak = 0;
+        size_t evictions = 0;
+        bool active = true;
+    };
+
+    /**
+     * @brief Move-only handle that releases its bytes when destroyed
+     */
+    class Reservation {
+    private:
+        Subsystem* m_subsystem = nullptr;
+        size_t m_bytes = 0;
+
+    public:
+        Reservation() = default;
+        Reservation(Subsystem* subsystem,
+                    const size_t& bytes);
+        ~Reservation();
+
+        Reservation(const Reservation&) = delete;
+        auto operator=(const Reservation&) -> Reservation& = delete;
+        Reservation(Reservation&& other) noexcept;
+        auto operator=(Reservation&& other) noexcept -> Reservation&;
+
+        /**
+         * @brief Releases the reserved bytes early
+         */
+        void reset();
+    };
+
+private:
+    static constexpr std::chrono::milliseconds WAIT_INTERVAL {50}; /** Re-check interval for blocked producers */
+
+    static inline std::mutex s_mutex;
+    static inline std::condition_variable s_cv;
+    static inline size_t s_budget = 0; /** Total budget in bytes, 0 means unlimited */
+    static inline size_t s_used = 0; /** Sum over all registered subsystems, attached budgets excluded */
+    static inline size_t s_peak = 0;
+    static inline std::deque<Subsystem> s_subsystems; /** Deque so that handed out pointers stay valid */
+    static inline std::vector<MemoryBudget*> s_attachedBudgets;
+
+    static inline std::mutex s_evictMutex; /** Only one thread evicts at a time */
+
+    static auto getTotalUsedLocked() -> size_t;
+    static auto isOverBudgetLocked(const size_t& extraBytes) -> bool;
+
+public:
+    /**
+     * @brief Sets the total budget. Blocked producers are re-evaluated against the new budget.
+     *
+     * @param bytes Budget in bytes (0 for unlimited).
+     */
+    static void setBudget(const size_t& bytes);
+
+    [[nodiscard]] static auto getBudget() -> size_t;
+    [[nodiscard]] static auto getUsed() -> size_t;
+
+    /**
+     * @brief Registers a subsystem
+     *
+     * @param name Human-readable name used in the summary
+     * @param evict Evict callback for caches, empty for subsystems that cannot give memory back on demand
+     * @return Subsystem* handle that stays valid for the lifetime of the program
+     */
+    static auto registerSubsystem(std::string name,
+                                  EvictFunc evict = {}) -> Subsystem*;
+
+    /**
+     * @brief Drops the evict callback and the usage of a subsystem whose owner is going away. Its peak is kept for
+     * the summary.
+     *
+     * @param subsystem Subsystem to deactivate
+     */
+    static void unregisterSubsystem(Subsystem* subsystem);
+
+    /**
+     * @brief Counts a MemoryBudget toward the total and includes it in the summary. The budget must outlive the
+     * governor.
+     *
+     * @param budget Budget to attach
+     */
+    static void attachBudget(MemoryBudget* budget);
+
+    /**
+     * @brief Records bytes held by a subsystem without blocking or evicting
+     *
+     * @param subsystem Subsystem holding the memory
+     * @param bytes Number of bytes
+     */
+    static void charge(Subsystem* subsystem,
+                       const size_t& bytes);
+
+    /**
+     * @brief Records bytes freed by a subsystem and wakes blocked producers
+     *
+     * @param subsystem Subsystem that freed the memory
+     * @param bytes Number of bytes
+     */
+    static void release(Subsystem* subsystem,
+                        const size_t& bytes);
+
+    /**
+     * @brief Evicts caches other than the caller until the total fits the budget again or nothing is left to evict
+     *
+     * @param caller Subsystem that triggered the reclaim, never evicted itself. May be nullptr
+     * @param extraBytes Additional bytes the caller is about to charge
+     */
+    static void reclaim(Subsystem* caller,
+                        const size_t& extraBytes = 0);
+
+    /**
+     * @brief Producer backpressure. Evicts caches, then blocks until the bytes fit and charges them.
+     *
+     * A request is let through once the subsystem itself holds nothing, so a single oversized item or memory held
+     * elsewhere that is never given back cannot deadlock the caller.
+     *
+     * @param subsystem Producer subsystem
+     * @param bytes Number of bytes to reserve
+     * @return Reservation handle releasing the bytes on destruction
+     */
+    [[nodiscard]] static auto acquire(Subsystem* subsystem,
+                                      const size_t& bytes) -> Reservation;
+
+    /**
+     * @brief Resets all high-water marks to the current usage
+     */
+    static void resetPeaks();
+
+    /**
+     * @brief Logs the high-water mark of every subsystem and of the total
+     */
+    static void logSummary();
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "util/MemoryGovernor.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <mutex>
+#include <streambuf>
+#include <vector>
+
+/**
+ * @brief Growable byte buffer that serializers write into through the std::streambuf interface, for example
+ * nifly::NifFile::Save with a std::ostream on top of it.
+ *
+ * The storage comes from a process wide pool and goes back to it when the buffer is destroyed, so the same few
+ * allocations are reused for every output file. Pooled storage is charged to the MemoryGovernor, it is freed instead
+ * of pooled when it does not fit the budget and the whole pool is dropped when the governor asks for memory back. Hand
+ * the buffer itself to whoever writes it out instead of copying the bytes.
+ *
+ * If enabled, the CRC32 (HashUtil::crc32, same as boost::crc_32_type) is computed while the bytes are written.
+ * Writers that seek back and overwrite bytes that were already hashed, like nifly filling in the block sizes of the
+ * header at the end, are handled by keeping the XOR of the old and new bytes and folding it into the checksum at the
+ * end, which works because CRC32 is linear. The data is never read a second time.
+ *
+ * There is no put area, every write goes through xsputn or overflow. Not thread safe.
+ */
+class OutputBuffer : public std::streambuf {
+public:
+    /**
+     * @brief Counters over all buffers since program start
+     */
+    struct Stats {
+        size_t buffers; /** Buffers created */
+        size_t poolReuses; /** Buffers that got their storage from the pool */
+        size_t reallocations; /** Times storage had to grow, each one copies what was written so far */
+        size_t bytesWritten; /** Final size of all buffers */
+    };
+
+private:
+    static constexpr size_t INITIAL_CAPACITY = size_t {256} * 1024;
+    static constexpr size_t MAX_POOLED_BUFFERS = 32;
+    static constexpr size_t MAX_POOLED_CAPACITY = size_t {64} * 1024 * 1024; /** Bigger storage is freed */
+
+    /** Bytes that were overwritten after they were hashed, as XOR of old and new */
+    struct CRCPatch {
+        size_t offset;
+        std::vector<char> delta;
+    };
+
+    std::vector<char> m_storage; /** Size is the capacity, m_size is the used part */
+    size_t m_size = 0;
+    size_t m_pos = 0;
+
+    bool m_computeCRC;
+    uint32_t m_crc = 0;
+    size_t m_crcPos = 0; /** Bytes before this were fed to m_crc */
+    std::vector<CRCPatch> m_crcPatches;
+
+    static inline std::mutex s_poolMutex;
+    static inline std::vector<std::vector<char>> s_pool;
+
+    static inline std::atomic<size_t> s_buffers {0};
+    static inline std::atomic<size_t> s_poolReuses {0};
+    static inline std::atomic<size_t> s_reallocations {0};
+    static inline std::atomic<size_t> s_bytesWritten {0};
+
+    static auto getPoolMemory() -> MemoryGovernor::Subsystem*;
+    static void clearPool();
+
+    void write(const char* src,
+               size_t count);
+    void ensureCapacity(size_t capacity);
+    void recordCRCPatch(size_t offset,
+                        const char* src,
+                        size_t count);
+
+protected:
+    auto overflow(int_type ch) -> int_type override;
+    auto xsputn(const char_type* s,
+                std::streamsize count) -> std::streamsize override;
+    auto seekoff(off_type off,
+                 std::ios_base::seekdir dir,
+                 std::ios_base::openmode which) -> pos_type override;
+    auto seekpos(pos_type pos,
+                 std::ios_base::openmode which) -> pos_type override;
+
+public:
+    /**
+     * @brief Construct a new empty buffer
+     *
+     * @param computeCRC Whether to compute the CRC32 while writing
+     */
+    explicit OutputBuffer(bool computeCRC = false);
+    ~OutputBuffer() override;
+    OutputBuffer(const OutputBuffer&) = delete;
+    auto operator=(const OutputBuffer&) -> OutputBuffer& = delete;
+    OutputBuffer(OutputBuffer&&) = delete;
+    auto operator=(OutputBuffer&&) -> OutputBuffer& = delete;
+
+    [[nodiscard]] auto data() const -> const char*;
+    [[nodiscard]] auto size() const -> size_t;
+
+    /**
+     * @brief Get the CRC32 of everything written so far. Throws runtime_error if the buffer was created without CRC
+     *
+     * @return uint32_t checksum, same value boost::crc_32_type gives for data()
+     */
+    [[nodiscard]] auto getCRC32() -> uint32_t;
+
+    [[nodiscard]] static auto getStats() -> Stats;
+
+    /**
+     * @brief Logs the counters at debug level
+     */
+    static void logStats();
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief Thread safe string pool that hands out small dense IDs for strings that repeat many times.
+ *
+ * IDs are stable for the lifetime of the interner and ID 0 always refers to the empty string. Lookups of strings that
+ * were already interned only take a shared lock. Interned strings are never freed.
+ *
+ * @tparam CharT Character type of the interned strings
+ * @tparam IdT Unsigned integer type of the IDs, the interner throws once it runs out of IDs
+ */
+template <typename CharT,
+          typename IdT>
+class StringInterner {
+public:
+    using String = std::basic_string<CharT>;
+    using StringView = std::basic_string_view<CharT>;
+
+private:
+    mutable std::shared_mutex m_mutex;
+    std::deque<String> m_strings; /** Deque so that the views used as map keys stay valid */
+    std::unordered_map<StringView, IdT> m_ids;
+    size_t m_bytes = 0;
+
+public:
+    StringInterner() { intern(StringView {}); }
+
+    /**
+     * @brief Get the ID of a string, adding it to the pool if it is new
+     *
+     * @param str String to intern
+     * @return IdT ID of the string
+     */
+    auto intern(StringView str) -> IdT
+    {
+        {
+            const std::shared_lock lock(m_mutex);
+            const auto it = m_ids.find(str);
+            if (it != m_ids.end()) {
+                return it->second;
+            }
+        }
+
+        const std::unique_lock lock(m_mutex);
+        // another thread might have added it while we waited for the lock
+        const auto it = m_ids.find(str);
+        if (it != m_ids.end()) {
+            return it->second;
+        }
+
+        if (m_strings.size() > std::numeric_limits<IdT>::max()) {
+            throw std::runtime_error("String interner ran out of IDs");
+        }
+
+        const auto id = static_cast<IdT>(m_strings.size());
+        const auto& stored = m_strings.emplace_back(str);
+        m_ids.emplace(StringView(stored), id);
+        m_bytes += (stored.capacity() + 1) * sizeof(CharT);
+        return id;
+    }
+
+    /**
+     * @brief Get the string of an ID
+     *
+     * @param id ID returned by intern()
+     * @return const String& interned string
+     */
+    auto get(IdT id) const -> const String&
+    {
+        const std::shared_lock lock(m_mutex);
+        return m_strings.at(id);
+    }
+
+    /**
+     * @brief Get the number of interned strings, including the empty string
+     *
+     * @return size_t number of strings
+     */
+    auto size() const -> size_t
+    {
+        const std::shared_lock lock(m_mutex);
+        return m_strings.size();
+    }
+
+    /**
+     * @brief Get the approximate number of bytes held by the interned strings
+     *
+     * @return size_t bytes
+     */
+    auto getBytes() const -> size_t
+    {
+        const std::shared_lock lock(m_mutex);
+        return m_bytes;
+    }
+};
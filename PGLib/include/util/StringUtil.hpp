@@ -3,7 +3,6 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/algorithm/string/predicate.hpp>
-#include <nlohmann/json_fwd.hpp>
 
 #include <string>
 #include <vector>
@@ -133,16 +132,6 @@ auto containsOnlyAscii(const std::wstring& str) -> bool;
  */
 auto toLowerASCII(const std::wstring& str) -> std::wstring;
 
-/**
- * @brief Checks whether a string value exists inside a JSON array.
- *
- * @param json A nlohmann::json value expected to be an array.
- * @param str The string to search for.
- * @return true if the string is found as an element of the JSON array, false otherwise.
- */
-auto checkIfStringInJSONArray(const nlohmann::json& json,
-                              const std::string& str) -> bool;
-
 /**
  * @brief Returns a lower-case copy of a narrow string using a fast ASCII-only algorithm.
  *
@@ -0,0 +1,423 @@
+#pragma once
+
+#include "util/ExceptionHandler.hpp"
+#include "util/Logger.hpp"
+
+#include <cpptrace/from_current.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Runs jobs through an ordered list of stages, each with its own worker threads and bounded input queue.
+ *
+ * A stage only accepts new jobs while its queue has room, so a slow stage applies back pressure to the stages in
+ * front of it instead of letting work pile up in memory. Stage functions return false to drop a job from the
+ * pipeline early. Every job that enters the pipeline is handed to the finish function exactly once, either after the
+ * last stage, when it is dropped or, for jobs still queued, when the pipeline is aborted.
+ *
+ * @tparam Job Job type carried between stages (only needs to be movable)
+ */
+template <typename Job> class TaskPipeline {
+public:
+    using StageFunc = std::function<bool(Job&)>;
+    using FinishFunc = std::function<void(Job&)>;
+    using AbortFunc = std::function<void()>;
+
+    /**
+     * @brief Occupancy and throughput counters for a single stage.
+     */
+    struct StageStats {
+        std::string name;
+        size_t workers;
+        size_t capacity;
+        size_t queued; /** Jobs currently waiting in the stage queue */
+        size_t peakQueued; /** Highest number of jobs that waited in the stage queue at once */
+        size_t processed; /** Jobs the stage function has run on */
+        std::chrono::milliseconds busyTime; /** Summed wall time spent in the stage function across workers */
+    };
+
+private:
+    struct Stage {
+        std::string name;
+        size_t workers;
+        size_t capacity;
+        StageFunc func;
+
+        std::mutex mutex;
+        std::condition_variable notEmpty;
+        std::condition_variable notFull;
+        std::deque<std::unique_ptr<Job>> queue;
+        bool closed = false;
+        size_t activeWorkers = 0;
+        size_t peakQueued = 0;
+
+        std::atomic<size_t> processed = 0;
+        std::atomic<int64_t> busyNanos = 0;
+    };
+
+    static constexpr int LOOP_INTERVAL = 10; /** Main thread poll interval in milliseconds */
+    static constexpr int STATS_INTERVAL = 1000; /** Interval between occupancy trace messages in milliseconds */
+
+    const bool m_multithread; /** If true, run stages on worker threads */
+
+    std::vector<std::unique_ptr<Stage>> m_stages;
+    FinishFunc m_finishFunc;
+    AbortFunc m_abortFunc;
+
+    std::atomic<bool> m_aborted = false;
+    std::atomic<size_t> m_runningWorkers = 0;
+
+public:
+    /**
+     * @brief Construct a new Task Pipeline object
+     *
+     * @param multithread if false, every job runs through all stages in order on the calling thread
+     */
+    TaskPipeline(const bool& multithread = true)
+        : m_multithread(multithread)
+    {
+    }
+
+    /**
+     * @brief Appends a stage to the pipeline
+     *
+     * @param name Stage name used in log output
+     * @param workers Number of worker threads for the stage (at least one is used)
+     * @param capacity Maximum number of jobs waiting in front of the stage (at least one is used)
+     * @param func Stage function, returns false to drop the job from the pipeline
+     */
+    void addStage(std::string name,
+                  const size_t& workers,
+                  const size_t& capacity,
+                  StageFunc func)
+    {
+        auto stage = std::make_unique<Stage>();
+        stage->name = std::move(name);
+        stage->workers = std::max<size_t>(1, workers);
+        stage->capacity = std::max<size_t>(1, capacity);
+        stage->func = std::move(func);
+        m_stages.push_back(std::move(stage));
+    }
+
+    /**
+     * @brief Sets the function that receives every job leaving the pipeline. Must be thread-safe.
+     *
+     * @param func Finish function
+     */
+    void setFinishFunc(FinishFunc func) { m_finishFunc = std::move(func); }
+
+    /**
+     * @brief Sets a function called once when the pipeline aborts, used to wake stage functions that block on
+     * something other than the pipeline queues. Must be thread-safe.
+     *
+     * @param func Abort function
+     */
+    void setAbortFunc(AbortFunc func) { m_abortFunc = std::move(func); }
+
+    /**
+     * @brief Blocking function that pushes all jobs through the pipeline. Intended to be run from the main thread
+     *
+     * @param jobs Jobs to run
+     */
+    void run(std::vector<Job>&& jobs)
+    {
+        if (m_stages.empty()) {
+            for (auto& job : jobs) {
+                finish(job);
+            }
+            return;
+        }
+
+        if (!m_multithread) {
+            runSingleThreaded(jobs);
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        for (size_t stageIdx = 0; stageIdx < m_stages.size(); stageIdx++) {
+            auto& stage = *m_stages[stageIdx];
+            stage.activeWorkers = stage.workers;
+            m_runningWorkers.fetch_add(stage.workers);
+            for (size_t worker = 0; worker < stage.workers; worker++) {
+                threads.emplace_back([this, stageIdx] { workerLoop(stageIdx); });
+            }
+        }
+
+        // feeder thread so that the main thread stays free to monitor
+        threads.emplace_back([this, &jobs] {
+            for (auto& job : jobs) {
+                if (!push(0, std::make_unique<Job>(std::move(job)))) {
+                    break;
+                }
+            }
+            close(*m_stages.front());
+        });
+
+        auto lastStats = std::chrono::steady_clock::now();
+        while (m_runningWorkers.load() > 0) {
+            if (ExceptionHandler::hasException()) {
+                abort();
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            if (now - lastStats >= std::chrono::milliseconds(STATS_INTERVAL)) {
+                lastStats = now;
+                logOccupancy();
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(LOOP_INTERVAL));
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    /**
+     * @brief Get occupancy and throughput counters for every stage
+     *
+     * @return std::vector<StageStats> stats in stage order
+     */
+    [[nodiscard]] auto getStats() const -> std::vector<StageStats>
+    {
+        std::vector<StageStats> stats;
+        stats.reserve(m_stages.size());
+        for (const auto& stage : m_stages) {
+            size_t queued = 0;
+            size_t peakQueued = 0;
+            {
+                const std::lock_guard lock(stage->mutex);
+                queued = stage->queue.size();
+                peakQueued = stage->peakQueued;
+            }
+
+            stats.push_back({.name = stage->name,
+                             .workers = stage->workers,
+                             .capacity = stage->capacity,
+                             .queued = queued,
+                             .peakQueued = peakQueued,
+                             .processed = stage->processed.load(),
+                             .busyTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                 std::chrono::nanoseconds(stage->busyNanos.load()))});
+        }
+
+        return stats;
+    }
+
+    /**
+     * @brief Logs the final per-stage counters at debug level
+     *
+     * @param pipelineName Name of the pipeline used in log output
+     */
+    void logStats(const std::string& pipelineName) const
+    {
+        if (!Logger::shouldLog(spdlog::level::debug)) {
+            return;
+        }
+
+        for (const auto& stat : getStats()) {
+            Logger::debug("{} stage {}: {} jobs, {} workers, peak queue {}/{}, busy {} ms",
+                          pipelineName,
+                          stat.name,
+                          stat.processed,
+                          stat.workers,
+                          stat.peakQueued,
+                          stat.capacity,
+                          stat.busyTime.count());
+        }
+    }
+
+private:
+    void runSingleThreaded(std::vector<Job>& jobs)
+    {
+        CPPTRACE_TRY
+        {
+            for (auto& job : jobs) {
+                for (auto& stage : m_stages) {
+                    if (!runStage(*stage, job)) {
+                        break;
+                    }
+                }
+                finish(job);
+            }
+        }
+        CPPTRACE_CATCH(const std::exception& e)
+        {
+            ExceptionHandler::setException(e, cpptrace::from_current_exception().to_string());
+        }
+    }
+
+    void workerLoop(const size_t& stageIdx)
+    {
+        auto& stage = *m_stages[stageIdx];
+        const bool isLastStage = stageIdx + 1 == m_stages.size();
+
+        while (true) {
+            auto job = pop(stage);
+            if (job == nullptr) {
+                break;
+            }
+
+            bool keep = false;
+
+            // Create log buffer
+            Logger::startThreadedBuffer();
+
+            CPPTRACE_TRY { keep = runStage(stage, *job); }
+            CPPTRACE_CATCH(const std::exception& e)
+            {
+                ExceptionHandler::setException(e, cpptrace::from_current_exception().to_string());
+                abort();
+            }
+
+            // Flush log buffer
+            Logger::flushThreadedBuffer();
+
+            if (!keep || isLastStage || !push(stageIdx + 1, std::move(job))) {
+                if (job != nullptr) {
+                    finish(*job);
+                }
+            }
+        }
+
+        // last worker out closes the queue of the next stage
+        bool lastWorker = false;
+        {
+            const std::lock_guard lock(stage.mutex);
+            lastWorker = --stage.activeWorkers == 0;
+        }
+        if (lastWorker && !isLastStage) {
+            close(*m_stages[stageIdx + 1]);
+        }
+
+        m_runningWorkers.fetch_sub(1);
+    }
+
+    auto runStage(Stage& stage,
+                  Job& job) -> bool
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const bool keep = stage.func(job);
+        stage.busyNanos.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                      std::chrono::steady_clock::now() - start)
+                                      .count());
+        stage.processed.fetch_add(1);
+        return keep;
+    }
+
+    void finish(Job& job)
+    {
+        if (m_finishFunc) {
+            m_finishFunc(job);
+        }
+    }
+
+    // Blocks while the stage queue is full. Returns false (job untouched) if the pipeline was aborted.
+    auto push(const size_t& stageIdx,
+              std::unique_ptr<Job>&& job) -> bool
+    {
+        auto& stage = *m_stages[stageIdx];
+        {
+            std::unique_lock lock(stage.mutex);
+            stage.notFull.wait(lock, [this, &stage]() -> bool {
+                return m_aborted.load() || stage.queue.size() < stage.capacity;
+            });
+            if (m_aborted.load()) {
+                return false;
+            }
+
+            stage.queue.push_back(std::move(job));
+            stage.peakQueued = std::max(stage.peakQueued, stage.queue.size());
+        }
+        stage.notEmpty.notify_one();
+        return true;
+    }
+
+    // Blocks while the stage queue is empty. Returns nullptr once the queue is closed and drained or on abort, abort
+    // finishes the queued jobs itself.
+    auto pop(Stage& stage) -> std::unique_ptr<Job>
+    {
+        std::unique_ptr<Job> job;
+        {
+            std::unique_lock lock(stage.mutex);
+            stage.notEmpty.wait(lock, [this, &stage]() -> bool {
+                return m_aborted.load() || stage.closed || !stage.queue.empty();
+            });
+            if (m_aborted.load() || stage.queue.empty()) {
+                return nullptr;
+            }
+
+            job = std::move(stage.queue.front());
+            stage.queue.pop_front();
+        }
+        stage.notFull.notify_one();
+        return job;
+    }
+
+    void close(Stage& stage)
+    {
+        {
+            const std::lock_guard lock(stage.mutex);
+            stage.closed = true;
+        }
+        stage.notEmpty.notify_all();
+    }
+
+    void abort()
+    {
+        if (m_aborted.exchange(true)) {
+            return;
+        }
+
+        for (auto& stage : m_stages) {
+            std::deque<std::unique_ptr<Job>> queued;
+            {
+                // lock so that waiters cannot miss the abort between their predicate check and waiting
+                const std::lock_guard lock(stage->mutex);
+                stage->closed = true;
+                queued.swap(stage->queue);
+            }
+            stage->notEmpty.notify_all();
+            stage->notFull.notify_all();
+
+            // queued jobs never reach a worker again, finish them so they give back what earlier stages gave them
+            for (auto& job : queued) {
+                finish(*job);
+            }
+        }
+
+        if (m_abortFunc) {
+            m_abortFunc();
+        }
+    }
+
+    void logOccupancy() const
+    {
+        if (!Logger::shouldLog(spdlog::level::trace)) {
+            return;
+        }
+
+        std::string line;
+        for (const auto& stat : getStats()) {
+            if (!line.empty()) {
+                line += " | ";
+            }
+            line += fmt::format("{} {}/{} ({} done)", stat.name, stat.queued, stat.capacity, stat.processed);
+        }
+        Logger::trace("Pipeline occupancy: {}", line);
+    }
+};
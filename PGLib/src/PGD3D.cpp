@@ -3,6 +3,7 @@
 #include "PGDirectory.hpp"
 #include "PGGlobals.hpp"
 #include "util/Logger.hpp"
+#include "util/MemoryGovernor.hpp"
 
 #include <DirectXMath.h>
 #include <DirectXTex.h>
@@ -12,6 +13,7 @@
 #include <array>
 #include <comdef.h>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <d3d11.h>
@@ -41,8 +43,15 @@ using Microsoft::WRL::ComPtr;
 PGD3D::PGD3D(filesystem::path shaderPath)
     : m_shaderPath(std::move(shaderPath))
 {
+    m_ddsMetaDataMemory = MemoryGovernor::registerSubsystem("DDS Metadata Cache", [this](size_t /*bytes*/) -> void {
+        const unique_lock lock(m_ddsMetaDataMutex);
+        m_ddsMetaDataCache.clear();
+        MemoryGovernor::release(m_ddsMetaDataMemory, SIZE_MAX);
+    });
 }
 
+PGD3D::~PGD3D() { MemoryGovernor::unregisterSubsystem(m_ddsMetaDataMemory); }
+
 auto PGD3D::checkIfCM(const filesystem::path& ddsPath,
                       bool& result,
                       bool& hasEnvMask,
@@ -872,17 +881,18 @@ auto PGD3D::getDDS(const filesystem::path& ddsPath, // NOLINT(readability-conver
 
     HRESULT hr {};
 
-    if (pgd->isLooseFile(ddsPath)) {
-        const filesystem::path fullPath = pgd->getLooseFileFullPath(ddsPath);
-
+    const filesystem::path fullPath
+        = pgd->isLooseFile(ddsPath) ? pgd->getLooseFileFullPath(ddsPath) : filesystem::path();
+    if (!fullPath.empty()) {
         // Load DDS file
         hr = DirectX::LoadFromDDSFile(fullPath.c_str(), DirectX::DDS_FLAGS_NONE, nullptr, dds);
-    } else if (pgd->isBSAFile(ddsPath)) {
+    } else if (pgd->isFile(ddsPath)) {
+        // BSA files and loose files of data sources that are not on disk
         vector<std::byte> ddsBytes;
         try {
             ddsBytes = pgd->getFile(ddsPath);
         } catch (...) {
-            Logger::error(L"Failed to read DDS file from BSA: {}", ddsPath.wstring());
+            Logger::error(L"Failed to read DDS file: {}", ddsPath.wstring());
             return false;
         }
 
@@ -915,17 +925,18 @@ auto PGD3D::getDDSMetadata(const filesystem::path& ddsPath,
 
     HRESULT hr {};
 
-    if (pgd->isLooseFile(ddsPath)) {
-        const filesystem::path fullPath = pgd->getLooseFileFullPath(ddsPath);
-
+    const filesystem::path fullPath
+        = pgd->isLooseFile(ddsPath) ? pgd->getLooseFileFullPath(ddsPath) : filesystem::path();
+    if (!fullPath.empty()) {
         // Load DDS file
         hr = DirectX::GetMetadataFromDDSFile(fullPath.c_str(), DirectX::DDS_FLAGS_NONE, ddsMeta);
-    } else if (pgd->isBSAFile(ddsPath)) {
+    } else if (pgd->isFile(ddsPath)) {
+        // BSA files and loose files of data sources that are not on disk
         vector<std::byte> ddsBytes;
         try {
             ddsBytes = pgd->getFile(ddsPath);
         } catch (...) {
-            Logger::error(L"Failed to read DDS file from BSA: {}", ddsPath.wstring());
+            Logger::error(L"Failed to read DDS file: {}", ddsPath.wstring());
             return false;
         }
 
@@ -944,8 +955,12 @@ auto PGD3D::getDDSMetadata(const filesystem::path& ddsPath,
         const unique_lock lock(m_ddsMetaDataMutex);
         if (!m_ddsMetaDataCache.contains(ddsPath)) {
             m_ddsMetaDataCache[ddsPath] = ddsMeta;
+            MemoryGovernor::charge(m_ddsMetaDataMemory,
+                                   sizeof(DirectX::TexMetadata) + (ddsPath.native().size() * sizeof(wchar_t))
+                                       + DDS_META_CACHE_ENTRY_OVERHEAD);
         }
     }
+    MemoryGovernor::reclaim(m_ddsMetaDataMemory);
 
     return true;
 }
@@ -7,8 +7,10 @@
 #include "common/BethesdaGame.hpp"
 #include "pgutil/PGEnums.hpp"
 #include "pgutil/PGMeshPermutationTracker.hpp"
+#include "pgutil/PGNIFScanner.hpp"
 #include "pgutil/PGNIFUtil.hpp"
 #include "pgutil/PGTypes.hpp"
+#include "util/GlobSet.hpp"
 #include "util/Logger.hpp"
 #include "util/StringUtil.hpp"
 #include "util/TaskPoolRunner.hpp"
@@ -21,21 +23,22 @@
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/asio.hpp>
-#include <boost/crc.hpp>
 #include <boost/thread.hpp>
 #include <memory>
 #include <nlohmann/json_fwd.hpp>
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <functional>
+#include <iterator>
 #include <map>
 #include <mutex>
+#include <ranges>
 #include <shared_mutex>
-#include <shlwapi.h>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
@@ -67,6 +70,7 @@ auto PGDirectory::findFiles() -> void
 {
     // Clear existing unconfirmedtextures
     m_unconfirmedTextures.clear();
+    m_unconfirmedTextureIDs.clear();
     m_unconfirmedMeshes.clear();
 
     // Populate unconfirmed maps
@@ -90,7 +94,7 @@ auto PGDirectory::findFiles() -> void
             Logger::trace(L"Found texture: {} / {}",
                           path.wstring(),
                           file.bsaFile == nullptr ? L"" : file.bsaFile->path.wstring());
-            m_unconfirmedTextures[path] = {};
+            m_unconfirmedTextures.push_back(path);
 
             {
                 // add to textures set
@@ -123,6 +127,13 @@ auto PGDirectory::findFiles() -> void
             }
         }
     }
+
+    // Assign texture IDs in path order so that everything keyed by them is independent of file map order
+    ranges::sort(m_unconfirmedTextures);
+    m_unconfirmedTextureIDs.reserve(m_unconfirmedTextures.size());
+    for (size_t textureID = 0; textureID < m_unconfirmedTextures.size(); textureID++) {
+        m_unconfirmedTextureIDs.emplace(m_unconfirmedTextures[textureID], static_cast<uint32_t>(textureID));
+    }
 }
 
 void PGDirectory::waitForMeshMapping()
@@ -139,6 +150,15 @@ void PGDirectory::waitForMeshMapping()
 
     // shutdown the queue to free resources
     m_meshUseMappingQueue.shutdown();
+
+    const auto [numFormKeyStrings, formKeyBytes] = PGMeshPermutationTracker::FormKey::getInternerStats();
+    const auto [numTexturePaths, texturePathBytes] = PGTypes::getTexturePathInternerStats();
+    Logger::debug("Mesh use mapping interned {} mod key and sub-model strings ({} bytes) and {} alternate texture "
+                  "paths ({} bytes)",
+                  numFormKeyStrings,
+                  formKeyBytes,
+                  numTexturePaths,
+                  texturePathBytes);
 }
 
 void PGDirectory::waitForCMClassification()
@@ -180,19 +200,30 @@ auto PGDirectory::mapFiles(const vector<wstring>& nifBlocklist,
         taskTracker.setCallbackFunc(progressCallback);
     }
 
+    // Start new vote buffers
+    {
+        const lock_guard lock(m_textureVoteBuffersMutex);
+        m_textureVoteBuffers.clear();
+    }
+    s_textureVoteGeneration.fetch_add(1);
+
     // Create runner
     TaskPoolRunner runner(multithreading);
 
+    // Compile the lists once instead of matching every glob against every mesh
+    const GlobSet allowGlobs(nifAllowlist);
+    const GlobSet blockGlobs(nifBlocklist);
+
     // Loop through each mesh to confirm textures
     for (const auto& mesh : m_unconfirmedMeshes) {
-        if (!nifAllowlist.empty() && !checkGlobMatchInVector(mesh.wstring(), nifAllowlist)) {
+        if (!allowGlobs.empty() && !allowGlobs.matches(mesh.wstring())) {
             // Skip mesh because it is not on allowlist
             Logger::debug(L"Skipping mesh due to allowlist: {}", mesh.wstring());
             taskTracker.completeJob(TaskTracker::Result::SUCCESS);
             continue;
         }
 
-        if (!nifBlocklist.empty() && checkGlobMatchInVector(mesh.wstring(), nifBlocklist)) {
+        if (!blockGlobs.empty() && blockGlobs.matches(mesh.wstring())) {
             // Skip mesh because it is on blocklist
             Logger::debug(L"Skipping mesh due to blocklist: {}", mesh.wstring());
             taskTracker.completeJob(TaskTracker::Result::SUCCESS);
@@ -206,53 +237,77 @@ auto PGDirectory::mapFiles(const vector<wstring>& nifBlocklist,
 
     // Blocks until all tasks are done
     runner.runTasks();
+    PGNIFScanner::logStats();
+
+    // Merge votes from all mapping threads
+    const auto textureVotes = reduceTextureVotes(multithreading);
+
+    // Decide the slot and type of every texture in parallel, each chunk only writes its own decisions
+    struct TextureDecision {
+        PGEnums::TextureSlots slot;
+        PGEnums::TextureType type;
+        bool inExcludedBSA;
+    };
+    vector<TextureDecision> decisions(m_unconfirmedTextures.size());
+
+    TaskPoolRunner decisionRunner(multithreading);
+    for (size_t chunkStart = 0; chunkStart < m_unconfirmedTextures.size(); chunkStart += TEXTURE_DECISION_CHUNK_SIZE) {
+        decisionRunner.addTask(
+            [this, &textureVotes, &decisions, &manualTextureMapsMap, &parallaxBSAExcludes, chunkStart] {
+                const size_t chunkEnd
+                    = std::min(chunkStart + TEXTURE_DECISION_CHUNK_SIZE, m_unconfirmedTextures.size());
+                for (size_t textureID = chunkStart; textureID < chunkEnd; textureID++) {
+                    const auto& texture = m_unconfirmedTextures[textureID];
+                    auto& decision = decisions[textureID];
+
+                    const auto votesIt = textureVotes.find(static_cast<uint32_t>(textureID));
+                    if (votesIt != textureVotes.end()) {
+                        // Find winning texture slot and type, ties go to the lower enum value
+                        const auto& votes = votesIt->second;
+                        decision.slot = static_cast<PGEnums::TextureSlots>(
+                            distance(votes.slots.begin(), ranges::max_element(votes.slots)));
+                        decision.type = static_cast<PGEnums::TextureType>(
+                            distance(votes.types.begin(), ranges::max_element(votes.types)));
+                    } else {
+                        // Determine slot and type by suffix
+                        const auto defProperty = PGNIFUtil::getDefaultsFromSuffix(texture);
+                        decision.slot = get<0>(defProperty);
+                        decision.type = get<1>(defProperty);
+                    }
 
-    // Loop through unconfirmed textures to confirm them
-    for (const auto& [texture, property] : m_unconfirmedTextures) {
-        bool foundInstance = false;
-
-        // Find winning texture slot
-        size_t maxVal = 0;
-        PGEnums::TextureSlots winningSlot = {};
-        for (const auto& [slot, count] : property.slots) {
-            foundInstance = true;
-            if (count > maxVal) {
-                maxVal = count;
-                winningSlot = slot;
-            }
-        }
-
-        // Find winning texture type
-        maxVal = 0;
-        PGEnums::TextureType winningType = {};
-        for (const auto& [type, count] : property.types) {
-            foundInstance = true;
-            if (count > maxVal) {
-                maxVal = count;
-                winningType = type;
-            }
-        }
-
-        if (!foundInstance) {
-            // Determine slot and type by suffix
-            const auto defProperty = PGNIFUtil::getDefaultsFromSuffix(texture);
-            winningSlot = get<0>(defProperty);
-            winningType = get<1>(defProperty);
-        }
+                    const auto manualIt = manualTextureMapsMap.find(texture.wstring());
+                    if (manualIt != manualTextureMapsMap.end()) {
+                        // Manual texture map found, override
+                        decision.type = manualIt->second;
+                        decision.slot = PGNIFUtil::getSlotFromTexType(decision.type);
+                    }
 
-        if (manualTextureMapsMap.contains(texture.wstring())) {
-            // Manual texture map found, override
-            winningType = manualTextureMapsMap.at(texture.wstring());
-            winningSlot = PGNIFUtil::getSlotFromTexType(winningType);
-        }
+                    decision.inExcludedBSA = (decision.slot == PGEnums::TextureSlots::PARALLAX
+                                              || decision.type == PGEnums::TextureType::ENVIRONMENTMASK)
+                        && isFileInBSA(texture, parallaxBSAExcludes);
+                }
+            });
+    }
 
-        if (winningSlot == PGEnums::TextureSlots::PARALLAX && isFileInBSA(texture, parallaxBSAExcludes)) {
+    // Blocks until all tasks are done
+    decisionRunner.runTasks();
+
+    // Apply decisions in texture ID order so that the result does not depend on thread timing
+    vector<TextureMapping> mappings;
+    mappings.reserve(m_unconfirmedTextures.size());
+    for (size_t textureID = 0; textureID < m_unconfirmedTextures.size(); textureID++) {
+        const auto& texture = m_unconfirmedTextures[textureID];
+        const auto& decision = decisions[textureID];
+        const auto winningSlot = decision.slot;
+        const auto winningType = decision.type;
+
+        if (winningSlot == PGEnums::TextureSlots::PARALLAX && decision.inExcludedBSA) {
             continue;
         }
 
         // extended classification
         // check if CM
-        if (winningType == PGEnums::TextureType::ENVIRONMENTMASK && !isFileInBSA(texture, parallaxBSAExcludes)) {
+        if (winningType == PGEnums::TextureType::ENVIRONMENTMASK && !decision.inExcludedBSA) {
             if (multithreading) {
                 m_CMClassificationQueue.queueTask(
                     [this, texture, winningSlot]() -> void { checkIfCMAddToMap(texture, winningSlot); });
@@ -267,12 +322,15 @@ auto PGDirectory::mapFiles(const vector<wstring>& nifBlocklist,
         // Add to texture map
         if (winningSlot != PGEnums::TextureSlots::UNKNOWN) {
             // Only add if no unknowns
-            addToTextureMaps(texture, winningSlot, winningType, {});
+            mappings.push_back({.path = texture, .slot = winningSlot, .type = winningType, .attributes = {}});
         }
     }
 
+    addToTextureMaps(mappings);
+
     // cleanup
     m_unconfirmedTextures.clear();
+    m_unconfirmedTextureIDs.clear();
     m_unconfirmedMeshes.clear();
 }
 
@@ -317,25 +375,15 @@ void PGDirectory::checkIfCMAddToMap(const std::filesystem::path& texture,
     addToTextureMaps(texture, winningSlot, PGEnums::TextureType::COMPLEXMATERIAL, attributes);
 }
 
-auto PGDirectory::checkGlobMatchInVector(const wstring& check,
-                                         const vector<std::wstring>& list) -> bool
-{
-    // convert wstring to LPCWSTR
-    LPCWSTR checkCstr = check.c_str();
-
-    // check if string matches any glob
-    return std::ranges::any_of(list, [&](const wstring& glob) { return PathMatchSpecW(checkCstr, glob.c_str()); });
-}
-
 auto PGDirectory::mapTexturesFromNIF(const filesystem::path& nifPath,
                                      const bool& multithreading) -> TaskTracker::Result
 {
     auto result = TaskTracker::Result::SUCCESS;
 
-    // Load NIF
-    shared_ptr<nifly::NifFile> nif = nullptr;
-    vector<std::byte> nifBytes;
+    // Read the shapes, the scanner skips geometry and only NIFs it cannot read are loaded with nifly
+    PGNIFScanner::MeshShapes meshShapes;
     {
+        vector<std::byte> nifBytes;
         try {
             nifBytes = getFile(nifPath);
         } catch (...) {
@@ -343,39 +391,30 @@ auto PGDirectory::mapTexturesFromNIF(const filesystem::path& nifPath,
             return TaskTracker::Result::FAILURE;
         }
 
-        try {
-            // Attempt to load NIF file
-            nif = make_shared<nifly::NifFile>(PGNIFUtil::loadNIFFromBytes(nifBytes));
-        } catch (...) {
-            // Unable to read NIF, delete from Meshes set
-            Logger::error(L"Unable to process mesh: {}", nifPath.wstring());
-            return TaskTracker::Result::FAILURE;
+        auto scannedShapes = PGNIFScanner::scan(nifBytes);
+        if (scannedShapes.has_value()) {
+            meshShapes = std::move(*scannedShapes);
+        } else {
+            try {
+                // Attempt to load NIF file
+                auto nif = PGNIFUtil::loadNIFFromBytes(nifBytes);
+                meshShapes = PGNIFScanner::getShaderShapes(nif);
+            } catch (...) {
+                // Unable to read NIF, delete from Meshes set
+                Logger::error(L"Unable to process mesh: {}", nifPath.wstring());
+                return TaskTracker::Result::FAILURE;
+            }
         }
     }
 
-    // Loop through each shape
-    const auto shapes = PGNIFUtil::getShapesWith3DIdx(nif.get());
-    // clear shapes in cache
-    for (const auto& [shape, oldindex3d] : shapes) {
-        if (shape == nullptr) {
-            // Skip if shape is null (invalid shapes)
+    // Loop through each shader patchable shape
+    for (const auto& shape : meshShapes.shapes) {
+        if (!shape.shaderPatchable) {
             continue;
         }
 
-        if (!PGNIFUtil::isPatchableShape(*nif, *shape)) {
-            // Skip if not patchable shape
-            continue;
-        }
-
-        if (!PGNIFUtil::isShaderPatchableShape(*nif, *shape)) {
-            // Skip if not shader patchable shape
-            continue;
-        }
-
-        auto* const shader = nif->GetShader(shape);
-        const auto textureSet = PGNIFUtil::getTextureSlots(nif.get(), shape);
-
         // Loop through each texture slot
+        const auto textureSet = PGTypes::resolveTextureSet(shape.textureSet);
         for (uint32_t slot = 0; slot < NUM_TEXTURE_SLOTS; slot++) {
             string texture = utf16toUTF8(textureSet.at(slot));
 
@@ -386,16 +425,10 @@ auto PGDirectory::mapTexturesFromNIF(const filesystem::path& nifPath,
 
             toLowerASCIIFastInPlace(texture); // Lowercase for comparison
 
-            const auto shaderType = shader->GetShaderType();
+            const auto shaderType = shape.shaderType;
             PGEnums::TextureType textureType = {};
 
             // Check to make sure appropriate shaders are set for a given texture
-            auto* const shaderBSSP = dynamic_cast<BSShaderProperty*>(shader);
-            if (shaderBSSP == nullptr) {
-                // Not a BSShaderProperty, skip
-                continue;
-            }
-
             switch (static_cast<PGEnums::TextureSlots>(slot)) {
             case PGEnums::TextureSlots::DIFFUSE:
                 // Diffuse check
@@ -403,7 +436,7 @@ auto PGDirectory::mapTexturesFromNIF(const filesystem::path& nifPath,
                 break;
             case PGEnums::TextureSlots::NORMAL:
                 // Normal check
-                if (shaderType == BSLSP_SKINTINT && PGNIFUtil::hasShaderFlag(shaderBSSP, SLSF1_FACEGEN_RGB_TINT)) {
+                if (shaderType == BSLSP_SKINTINT && shape.hasShaderFlag(SLSF1_FACEGEN_RGB_TINT)) {
                     // This is a skin tint map
                     textureType = PGEnums::TextureType::MODELSPACENORMAL;
                     break;
@@ -413,21 +446,20 @@ auto PGDirectory::mapTexturesFromNIF(const filesystem::path& nifPath,
                 break;
             case PGEnums::TextureSlots::GLOW:
                 // Glowmap check
-                if ((shaderType == BSLSP_GLOWMAP && PGNIFUtil::hasShaderFlag(shaderBSSP, SLSF2_GLOW_MAP))
-                    || (shaderType == BSLSP_DEFAULT && PGNIFUtil::hasShaderFlag(shaderBSSP, SLSF2_UNUSED01))) {
+                if ((shaderType == BSLSP_GLOWMAP && shape.hasShaderFlag(SLSF2_GLOW_MAP))
+                    || (shaderType == BSLSP_DEFAULT && shape.hasShaderFlag(SLSF2_UNUSED01))) {
                     // This is an emmissive map (either vanilla glowmap shader or PBR)
                     textureType = PGEnums::TextureType::EMISSIVE;
                     break;
                 }
 
-                if (shaderType == BSLSP_MULTILAYERPARALLAX
-                    && PGNIFUtil::hasShaderFlag(shaderBSSP, SLSF2_MULTI_LAYER_PARALLAX)) {
+                if (shaderType == BSLSP_MULTILAYERPARALLAX && shape.hasShaderFlag(SLSF2_MULTI_LAYER_PARALLAX)) {
                     // This is a subsurface map
                     textureType = PGEnums::TextureType::SUBSURFACECOLOR;
                     break;
                 }
 
-                if (shaderType == BSLSP_SKINTINT && PGNIFUtil::hasShaderFlag(shaderBSSP, SLSF1_FACEGEN_RGB_TINT)) {
+                if (shaderType == BSLSP_SKINTINT && shape.hasShaderFlag(SLSF1_FACEGEN_RGB_TINT)) {
                     // This is a skin tint map
                     textureType = PGEnums::TextureType::SKINTINT;
                     break;
@@ -436,13 +468,13 @@ auto PGDirectory::mapTexturesFromNIF(const filesystem::path& nifPath,
                 continue;
             case PGEnums::TextureSlots::PARALLAX:
                 // Parallax check
-                if ((shaderType == BSLSP_PARALLAX && PGNIFUtil::hasShaderFlag(shaderBSSP, SLSF1_PARALLAX))) {
+                if ((shaderType == BSLSP_PARALLAX && shape.hasShaderFlag(SLSF1_PARALLAX))) {
                     // This is a height map
                     textureType = PGEnums::TextureType::HEIGHT;
                     break;
                 }
 
-                if ((shaderType == BSLSP_DEFAULT && PGNIFUtil::hasShaderFlag(shaderBSSP, SLSF2_UNUSED01))) {
+                if ((shaderType == BSLSP_DEFAULT && shape.hasShaderFlag(SLSF2_UNUSED01))) {
                     // This is a height map for PBR
                     textureType = PGEnums::TextureType::HEIGHTPBR;
                     break;
@@ -451,7 +483,7 @@ auto PGDirectory::mapTexturesFromNIF(const filesystem::path& nifPath,
                 continue;
             case PGEnums::TextureSlots::CUBEMAP:
                 // Cubemap check
-                if (shaderType == BSLSP_ENVMAP && PGNIFUtil::hasShaderFlag(shaderBSSP, SLSF1_ENVIRONMENT_MAPPING)) {
+                if (shaderType == BSLSP_ENVMAP && shape.hasShaderFlag(SLSF1_ENVIRONMENT_MAPPING)) {
                     textureType = PGEnums::TextureType::CUBEMAP;
                     break;
                 }
@@ -459,12 +491,12 @@ auto PGDirectory::mapTexturesFromNIF(const filesystem::path& nifPath,
                 continue;
             case PGEnums::TextureSlots::ENVMASK:
                 // Envmap check
-                if (shaderType == BSLSP_ENVMAP && PGNIFUtil::hasShaderFlag(shaderBSSP, SLSF1_ENVIRONMENT_MAPPING)) {
+                if (shaderType == BSLSP_ENVMAP && shape.hasShaderFlag(SLSF1_ENVIRONMENT_MAPPING)) {
                     textureType = PGEnums::TextureType::ENVIRONMENTMASK;
                     break;
                 }
 
-                if (shaderType == BSLSP_DEFAULT && PGNIFUtil::hasShaderFlag(shaderBSSP, SLSF2_UNUSED01)) {
+                if (shaderType == BSLSP_DEFAULT && shape.hasShaderFlag(SLSF2_UNUSED01)) {
                     textureType = PGEnums::TextureType::RMAOS;
                     break;
                 }
@@ -472,9 +504,8 @@ auto PGDirectory::mapTexturesFromNIF(const filesystem::path& nifPath,
                 continue;
             case PGEnums::TextureSlots::MULTILAYER:
                 // Tint check
-                if (shaderType == BSLSP_MULTILAYERPARALLAX
-                    && PGNIFUtil::hasShaderFlag(shaderBSSP, SLSF2_MULTI_LAYER_PARALLAX)) {
-                    if (PGNIFUtil::hasShaderFlag(shaderBSSP, SLSF2_UNUSED01)) {
+                if (shaderType == BSLSP_MULTILAYERPARALLAX && shape.hasShaderFlag(SLSF2_MULTI_LAYER_PARALLAX)) {
+                    if (shape.hasShaderFlag(SLSF2_UNUSED01)) {
                         // 2 layer PBR
                         textureType = PGEnums::TextureType::COATNORMALROUGHNESS;
                     } else {
@@ -487,23 +518,23 @@ auto PGDirectory::mapTexturesFromNIF(const filesystem::path& nifPath,
                 continue;
             case PGEnums::TextureSlots::BACKLIGHT:
                 // Backlight check
-                if (shaderType == BSLSP_MULTILAYERPARALLAX && PGNIFUtil::hasShaderFlag(shaderBSSP, SLSF2_UNUSED01)) {
+                if (shaderType == BSLSP_MULTILAYERPARALLAX && shape.hasShaderFlag(SLSF2_UNUSED01)) {
                     textureType = PGEnums::TextureType::SUBSURFACEPBR;
                     break;
                 }
 
-                if (shaderType == BSLSP_HAIRTINT && PGNIFUtil::hasShaderFlag(shaderBSSP, SLSF2_BACK_LIGHTING)) {
+                if (shaderType == BSLSP_HAIRTINT && shape.hasShaderFlag(SLSF2_BACK_LIGHTING)) {
                     // Hair tint map
                     textureType = PGEnums::TextureType::HAIR_FLOWMAP;
                     break;
                 }
 
-                if (shaderType == BSLSP_SKINTINT && PGNIFUtil::hasShaderFlag(shaderBSSP, SLSF1_FACEGEN_RGB_TINT)) {
+                if (shaderType == BSLSP_SKINTINT && shape.hasShaderFlag(SLSF1_FACEGEN_RGB_TINT)) {
                     textureType = PGEnums::TextureType::SPECULAR;
                     break;
                 }
 
-                if (PGNIFUtil::hasShaderFlag(shaderBSSP, SLSF2_BACK_LIGHTING)) {
+                if (shape.hasShaderFlag(SLSF2_BACK_LIGHTING)) {
                     textureType = PGEnums::TextureType::BACKLIGHT;
                     break;
                 }
@@ -513,21 +544,19 @@ auto PGDirectory::mapTexturesFromNIF(const filesystem::path& nifPath,
                 textureType = PGEnums::TextureType::UNKNOWN;
             }
 
-            // Update unconfirmed textures map
-            updateUnconfirmedTexturesMap(texture, static_cast<PGEnums::TextureSlots>(slot), textureType);
+            // Vote for the slot and type of this texture
+            addTextureVote(texture, static_cast<PGEnums::TextureSlots>(slot), textureType);
         }
     }
 
     if (multithreading) {
-        m_meshUseMappingQueue.queueTask([this, nifPath]() -> void {
+        m_meshUseMappingQueue.queueTask([this, nifPath, meshShapes = std::move(meshShapes)]() mutable -> void {
             // send job to find mesh uses for this mesh
-            const auto modelUses = PGPlugin::getModelUses(nifPath);
-            updateNifCache(nifPath, modelUses);
+            updateNifCache(nifPath, PGPlugin::getModelUses(nifPath), std::move(meshShapes));
         });
     } else {
         // send job to find mesh uses for this mesh
-        const auto modelUses = PGPlugin::getModelUses(nifPath);
-        updateNifCache(nifPath, modelUses);
+        updateNifCache(nifPath, PGPlugin::getModelUses(nifPath), std::move(meshShapes));
     }
 
     // find mod of this mesh
@@ -542,19 +571,73 @@ auto PGDirectory::mapTexturesFromNIF(const filesystem::path& nifPath,
     return result;
 }
 
-auto PGDirectory::updateUnconfirmedTexturesMap(const filesystem::path& path,
-                                               const PGEnums::TextureSlots& slot,
-                                               const PGEnums::TextureType& type) -> void
+auto PGDirectory::addTextureVote(const filesystem::path& path,
+                                 const PGEnums::TextureSlots& slot,
+                                 const PGEnums::TextureType& type) -> void
 {
-    // Use mutex to make this thread safe
-    const lock_guard<mutex> lock(m_unconfirmedTexturesMutex);
+    // ID map is not modified while mapping, no lock needed
+    const auto idIt = m_unconfirmedTextureIDs.find(path);
+    if (idIt == m_unconfirmedTextureIDs.end()) {
+        return;
+    }
+
+    thread_local shared_ptr<TextureVoteMap> buffer;
+    thread_local uint64_t bufferGeneration = 0;
+
+    const auto curGeneration = s_textureVoteGeneration.load();
+    if (buffer == nullptr || bufferGeneration != curGeneration) {
+        // first vote on this thread since mapFiles started
+        buffer = make_shared<TextureVoteMap>();
+        bufferGeneration = curGeneration;
+
+        const lock_guard lock(m_textureVoteBuffersMutex);
+        m_textureVoteBuffers.push_back(buffer);
+    }
+
+    auto& votes = (*buffer)[idIt->second];
+    votes.slots.at(static_cast<size_t>(slot))++;
+    votes.types.at(static_cast<size_t>(type))++;
+}
+
+auto PGDirectory::reduceTextureVotes(const bool& multithreading) -> TextureVoteMap
+{
+    vector<shared_ptr<TextureVoteMap>> buffers;
+    {
+        const lock_guard lock(m_textureVoteBuffersMutex);
+        buffers.swap(m_textureVoteBuffers);
+    }
+
+    if (buffers.empty()) {
+        return {};
+    }
+
+    // each round merges every second remaining buffer into its neighbour
+    for (size_t stride = 1; stride < buffers.size(); stride *= 2) {
+        TaskPoolRunner runner(multithreading);
+        for (size_t targetIdx = 0; targetIdx + stride < buffers.size(); targetIdx += 2 * stride) {
+            runner.addTask([&buffers, targetIdx, stride] {
+                auto& target = *buffers[targetIdx];
+                auto& source = *buffers[targetIdx + stride];
+                for (const auto& [textureID, votes] : source) {
+                    auto& targetVotes = target[textureID];
+                    for (size_t slot = 0; slot < votes.slots.size(); slot++) {
+                        targetVotes.slots.at(slot) += votes.slots.at(slot);
+                    }
+                    for (size_t type = 0; type < votes.types.size(); type++) {
+                        targetVotes.types.at(type) += votes.types.at(type);
+                    }
+                }
 
-    // Check if texture is already in map
-    if (m_unconfirmedTextures.contains(path)) {
-        // Texture is present
-        m_unconfirmedTextures[path].slots[slot]++;
-        m_unconfirmedTextures[path].types[type]++;
+                // the mapping thread may still hold the buffer, free its contents now
+                source.clear();
+            });
+        }
+        runner.runTasks();
     }
+
+    auto result = std::move(*buffers.front());
+    buffers.front()->clear();
+    return result;
 }
 
 auto PGDirectory::addToTextureMaps(const filesystem::path& path,
@@ -562,52 +645,69 @@ auto PGDirectory::addToTextureMaps(const filesystem::path& path,
                                    const PGEnums::TextureType& type,
                                    const unordered_set<PGEnums::TextureAttribute>& attributes) -> void
 {
-    // Log result
-    Logger::trace(L"Mapping Texture: {} / Slot: {} / Type: {}",
-                  path.wstring(),
-                  static_cast<size_t>(slot),
-                  utf8toUTF16(PGEnums::getStrFromTexType(type)));
+    addToTextureMaps({{.path = path, .slot = slot, .type = type, .attributes = attributes}});
+}
+
+auto PGDirectory::addToTextureMaps(const vector<TextureMapping>& mappings) -> void
+{
+    if (mappings.empty()) {
+        return;
+    }
 
-    // Get texture base
-    const auto& base = PGNIFUtil::getTexBase(path, slot);
-    const auto& slotInt = static_cast<size_t>(slot);
+    // Get texture bases outside of the lock
+    vector<wstring> bases;
+    bases.reserve(mappings.size());
+    for (const auto& mapping : mappings) {
+        // Log result
+        Logger::trace(L"Mapping Texture: {} / Slot: {} / Type: {}",
+                      mapping.path.wstring(),
+                      static_cast<size_t>(mapping.slot),
+                      utf8toUTF16(PGEnums::getStrFromTexType(mapping.type)));
+
+        bases.push_back(PGNIFUtil::getTexBase(mapping.path, mapping.slot));
+    }
 
     // Add to texture map
-    const PGTypes::PGTexture newPGTexture = {.path = path, .type = type};
     {
         const unique_lock lock(m_textureMapsMutex);
-        m_textureMaps.at(slotInt)[base].insert(newPGTexture);
+        for (size_t mappingIdx = 0; mappingIdx < mappings.size(); mappingIdx++) {
+            const auto& mapping = mappings[mappingIdx];
+            const PGTypes::PGTexture newPGTexture = {.path = mapping.path, .type = mapping.type};
+            m_textureMaps.at(static_cast<size_t>(mapping.slot))[bases[mappingIdx]].insert(newPGTexture);
+        }
     }
 
     {
-        const TextureDetails details = {.type = type, .attributes = attributes};
-
         const unique_lock lock(m_textureTypesMutex);
-        m_textureTypes[path] = details;
+        m_textureTypes.reserve(m_textureTypes.size() + mappings.size());
+        for (const auto& mapping : mappings) {
+            m_textureTypes[mapping.path] = {.type = mapping.type, .attributes = mapping.attributes};
+        }
+    }
+
+    if (!PGGlobals::isPGMMSet()) {
+        return;
     }
 
     // Add shader types to mod given certain types
-    if (type == PGEnums::TextureType::HEIGHT) {
-        // parallax
-        if (PGGlobals::isPGMMSet()) {
-            PGGlobals::getPGMM()->addShaderToModByFile(path, PGEnums::ShapeShader::VANILLAPARALLAX);
-        }
-    } else if (type == PGEnums::TextureType::COMPLEXMATERIAL) {
-        // PBR parallax
-        if (PGGlobals::isPGMMSet()) {
-            PGGlobals::getPGMM()->addShaderToModByFile(path, PGEnums::ShapeShader::COMPLEXMATERIAL);
-        }
-    } else {
-        // Default shader for all other types
-        if (PGGlobals::isPGMMSet()) {
-            PGGlobals::getPGMM()->addShaderToModByFile(path, PGEnums::ShapeShader::NONE);
+    for (const auto& mapping : mappings) {
+        if (mapping.type == PGEnums::TextureType::HEIGHT) {
+            // parallax
+            PGGlobals::getPGMM()->addShaderToModByFile(mapping.path, PGEnums::ShapeShader::VANILLAPARALLAX);
+        } else if (mapping.type == PGEnums::TextureType::COMPLEXMATERIAL) {
+            // PBR parallax
+            PGGlobals::getPGMM()->addShaderToModByFile(mapping.path, PGEnums::ShapeShader::COMPLEXMATERIAL);
+        } else {
+            // Default shader for all other types
+            PGGlobals::getPGMM()->addShaderToModByFile(mapping.path, PGEnums::ShapeShader::NONE);
         }
     }
 }
 
 void PGDirectory::updateNifCache(const filesystem::path& path,
-                                 const vector<pair<PGMeshPermutationTracker::FormKey,
-                                                   PGPlugin::MeshUseAttributes>>& meshUses)
+                                 vector<pair<PGMeshPermutationTracker::FormKey,
+                                             PGPlugin::MeshUseAttributes>>&& meshUses,
+                                 PGNIFScanner::MeshShapes&& meshShapes)
 {
     const unique_lock lock(m_meshesMutex);
 
@@ -615,7 +715,9 @@ void PGDirectory::updateNifCache(const filesystem::path& path,
         m_meshes[path] = NifCache {};
     }
 
-    m_meshes.at(path).meshUses = meshUses;
+    auto& nifCache = m_meshes.at(path);
+    nifCache.meshUses = std::move(meshUses);
+    nifCache.meshShapes = std::move(meshShapes);
 }
 
 auto PGDirectory::getTextureMap(const PGEnums::TextureSlots& slot) -> map<wstring,
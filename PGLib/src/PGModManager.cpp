@@ -6,6 +6,7 @@
 #include "pgutil/PGEnums.hpp"
 #include "util/Logger.hpp"
 #include "util/StringUtil.hpp"
+#include "util/TaskPoolRunner.hpp"
 
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/case_conv.hpp>
@@ -28,6 +29,7 @@
 #include <ranges>
 #include <regex>
 #include <shared_mutex>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
@@ -37,6 +39,138 @@
 
 using namespace std;
 
+namespace {
+
+/**
+ * @brief SAX handler for vortex.deployment.json that only keeps stagingPath and the relPath/source of each file.
+ *
+ * The deployment file can be hundreds of MB, this avoids building a DOM for it. Each file entry is handed to the
+ * callback as soon as its object closes, the strings are reused between entries.
+ */
+class VortexDeploymentSAX : public nlohmann::json_sax<nlohmann::json> {
+public:
+    using FileCallback = function<void(std::string& relPath, std::string& source)>;
+
+private:
+    // depth of the containers, root object is 1, files array is 2 and each file object is 3
+    static constexpr int ROOT_DEPTH = 1;
+    static constexpr int FILES_DEPTH = 2;
+    static constexpr int FILE_DEPTH = 3;
+
+    FileCallback m_fileCallback;
+
+    int m_depth = 0;
+    std::string m_rootKey;
+    std::string m_fileKey;
+    bool m_inFiles = false;
+    bool m_inFile = false;
+    bool m_hasFiles = false;
+    bool m_hasStagingPath = false;
+    std::string m_stagingPath;
+    std::string m_relPath;
+    std::string m_source;
+    std::string m_error;
+
+public:
+    VortexDeploymentSAX(FileCallback fileCallback)
+        : m_fileCallback(std::move(fileCallback))
+    {
+    }
+
+    [[nodiscard]] auto hasFiles() const -> bool { return m_hasFiles; }
+    [[nodiscard]] auto hasStagingPath() const -> bool { return m_hasStagingPath; }
+    [[nodiscard]] auto getStagingPath() const -> const std::string& { return m_stagingPath; }
+    [[nodiscard]] auto getError() const -> const std::string& { return m_error; }
+
+    auto null() -> bool override { return true; }
+    auto boolean(bool /*val*/) -> bool override { return true; }
+    auto number_integer(number_integer_t /*val*/) -> bool override { return true; }
+    auto number_unsigned(number_unsigned_t /*val*/) -> bool override { return true; }
+    auto number_float(number_float_t /*val*/,
+                      const string_t& /*s*/) -> bool override
+    {
+        return true;
+    }
+    auto binary(binary_t& /*val*/) -> bool override { return true; }
+
+    auto string(string_t& val) -> bool override
+    {
+        if (m_depth == ROOT_DEPTH && m_rootKey == "stagingPath") {
+            m_stagingPath = val;
+            m_hasStagingPath = true;
+        } else if (m_inFile && m_depth == FILE_DEPTH) {
+            if (m_fileKey == "relPath") {
+                m_relPath.swap(val);
+            } else if (m_fileKey == "source") {
+                m_source.swap(val);
+            }
+        }
+        return true;
+    }
+
+    auto key(string_t& val) -> bool override
+    {
+        if (m_depth == ROOT_DEPTH) {
+            m_rootKey.swap(val);
+        } else if (m_inFile && m_depth == FILE_DEPTH) {
+            m_fileKey.swap(val);
+        }
+        return true;
+    }
+
+    auto start_object(size_t /*elements*/) -> bool override
+    {
+        m_depth++;
+        if (m_inFiles && m_depth == FILE_DEPTH) {
+            m_inFile = true;
+            m_relPath.clear();
+            m_source.clear();
+        }
+        return true;
+    }
+
+    auto end_object() -> bool override
+    {
+        if (m_inFile && m_depth == FILE_DEPTH) {
+            m_inFile = false;
+            if (!m_relPath.empty()) {
+                m_fileCallback(m_relPath, m_source);
+            }
+        }
+        m_depth--;
+        return true;
+    }
+
+    auto start_array(size_t /*elements*/) -> bool override
+    {
+        m_depth++;
+        if (m_depth == FILES_DEPTH && m_rootKey == "files") {
+            m_inFiles = true;
+            m_hasFiles = true;
+        }
+        return true;
+    }
+
+    auto end_array() -> bool override
+    {
+        if (m_inFiles && m_depth == FILES_DEPTH) {
+            m_inFiles = false;
+        }
+        m_depth--;
+        return true;
+    }
+
+    auto parse_error(size_t /*position*/,
+                     const std::string& /*last_token*/,
+                     const nlohmann::json::exception& ex) -> bool override
+    {
+        m_error = ex.what();
+        return false;
+    }
+};
+
+}
+
 auto PGModManager::fromHexDigit(char c) -> uint8_t
 {
     if (c >= '0' && c <= '9') {
@@ -94,25 +228,38 @@ PGModManager::PGModManager(const ModManagerType& mmType)
 {
 }
 
-auto PGModManager::getModFileMap() const -> const unordered_map<filesystem::path,
-                                                                shared_ptr<Mod>>&
-{
-    return m_modFileMap;
-}
+auto PGModManager::getModFileMap() const -> const ModFileMap& { return m_modFileMap; }
 
 auto PGModManager::getModByFile(const filesystem::path& relPath) const -> shared_ptr<Mod>
 {
-    if (m_modFileMap.contains(relPath)) {
-        return m_modFileMap.at(relPath);
+    const auto it = m_modFileMap.find(relPath);
+    if (it != m_modFileMap.end()) {
+        return it->second.mod;
     }
 
     return nullptr;
 }
 
+auto PGModManager::getLosingModsByFile(const filesystem::path& relPath) const -> span<const shared_ptr<Mod>>
+{
+    const auto it = m_modFileMap.find(relPath);
+    if (it == m_modFileMap.end() || it->second.losersCount == 0) {
+        return {};
+    }
+
+    return {m_modFileLosers.data() + it->second.losersBegin, it->second.losersCount};
+}
+
 auto PGModManager::getModByFileSmart(const filesystem::path& relPath) const -> shared_ptr<Mod>
 {
     // accounts for files in BSAs
 
+    // loose files in a mod folder always win over BSAs, so a direct hit does not need the PGD lookup
+    const auto it = m_modFileMap.find(relPath);
+    if (it != m_modFileMap.end()) {
+        return it->second.mod;
+    }
+
     // get mod searchable file from PGD
     auto* pgd = PGGlobals::getPGD();
     if (pgd == nullptr) {
@@ -256,53 +403,38 @@ void PGModManager::populateModFileMapVortex(const filesystem::path& deploymentDi
                             + StringUtil::utf16toUTF8(deploymentFile.wstring()));
     }
 
-    ifstream vortexDepFileF(deploymentFile);
-    nlohmann::json vortexDeployment = nlohmann::json::parse(vortexDepFileF);
-    vortexDepFileF.close();
-
-    // Check that files field exists
-    if (!vortexDeployment.contains("files")) {
-        throw runtime_error("Vortex deployment file does not contain 'files' field: "
-                            + StringUtil::utf16toUTF8(deploymentFile.wstring()));
+    // first path components that are mapped, in the form they appear in relPath
+    unordered_set<string> foldersToMap;
+    for (const auto& folder : PGGlobals::s_foldersToMap) {
+        foldersToMap.insert(StringUtil::toLowerASCIIFast(folder.string()));
     }
 
-    // Extract staging path where all Vortex mods are stored
-    if (!vortexDeployment.contains("stagingPath")) {
-        throw runtime_error("Vortex deployment file does not contain 'stagingPath' field: "
-                            + StringUtil::utf16toUTF8(deploymentFile.wstring()));
-    }
-
-    const auto stagingPath = filesystem::path(StringUtil::utf8toUTF16(vortexDeployment["stagingPath"].get<string>()));
-    m_stagingLocation = stagingPath;
-
-    // loop through files
+    filesystem::path stagingPath;
     unordered_set<wstring> foundMods;
-    for (const auto& file : vortexDeployment["files"]) {
-        auto relPath = filesystem::path(StringUtil::utf8toUTF16(file["relPath"].get<string>()));
 
-        // Check if relPath is within s_foldersToMap
-        // Get the first path component of relPath
-        const auto relPathStr = boost::to_lower_copy(relPath.begin()->wstring());
-        if (!PGGlobals::s_foldersToMap.contains(relPathStr)) {
-            // skip if not mapping from this folder
-            continue;
+    // sources resolve to the same mod for every file, so the directory check and name normalization only run once
+    // per source. nullptr marks sources whose mod directory does not exist
+    unordered_map<string, shared_ptr<Mod>> sourceModCache;
+    const auto resolveSource = [&](const string& source) -> shared_ptr<Mod> {
+        const auto cached = sourceModCache.find(source);
+        if (cached != sourceModCache.end()) {
+            return cached->second;
         }
 
         // Get the mod identifier from source field (e.g., "1DwemerArmorSE-81043-1-1671541249")
-        const auto sourceId = StringUtil::utf8toUTF16(file["source"].get<string>());
+        const auto sourceId = StringUtil::utf8toUTF16(source);
         const auto curModDir = stagingPath / sourceId;
 
         // Check if mod folder exists
         if (!filesystem::exists(curModDir)) {
             Logger::debug(L"Mod directory from vortex.deployment.json does not exist: {}", curModDir.wstring());
-            continue;
+            sourceModCache.emplace(source, nullptr);
+            return nullptr;
         }
 
-        auto modName = sourceId;
-
         // filter out modname suffix (e.g., remove "-81043-1-1671541249" from "1DwemerArmorSE-81043-1-1671541249")
         const static wregex vortexSuffixRe(L"-[0-9]+-.*");
-        modName = regex_replace(modName, vortexSuffixRe, L"");
+        const auto modName = regex_replace(sourceId, vortexSuffixRe, L"");
 
         shared_ptr<Mod> modPtr = nullptr;
         if (m_modMap.contains(modName)) {
@@ -318,12 +450,86 @@ void PGModManager::populateModFileMapVortex(const filesystem::path& deploymentDi
         modPtr->modManagerOrder = 0; // Vortex does not have a mod manager order system by default
         modPtr->folder = curModDir; // Store the actual mod folder path
 
-        // Update file map
-        Logger::trace(L"Mapping file to mod: {} -> {}", relPath.wstring(), modName);
-
         m_modMap[modName] = modPtr;
         foundMods.insert(modName);
-        m_modFileMap[StringUtil::toLowerASCII(relPath.wstring())] = modPtr;
+        sourceModCache.emplace(source, modPtr);
+        return modPtr;
+    };
+
+    // file map updates are collected and inserted in one go after parsing
+    vector<pair<wstring, shared_ptr<Mod>>> fileBatch;
+    const auto mapFile = [&](string& relPath,
+                             const string& source) {
+        const auto modPtr = resolveSource(source);
+        if (modPtr == nullptr) {
+            return;
+        }
+
+        StringUtil::toLowerASCIIFastInPlace(relPath);
+        auto relPathLower = StringUtil::utf8toUTF16(relPath);
+
+        // Update file map
+        Logger::trace(L"Mapping file to mod: {} -> {}", relPathLower, modPtr->name);
+        fileBatch.emplace_back(std::move(relPathLower), modPtr);
+    };
+
+    // files listed before stagingPath (not the case for files written by Vortex) wait until it is known
+    vector<pair<string, string>> pendingFiles;
+    VortexDeploymentSAX deploymentSAX([&](string& relPath,
+                                          string& source) {
+        // Check if relPath is within s_foldersToMap
+        // Get the first path component of relPath
+        auto firstComponent = relPath.substr(0, relPath.find_first_of("/\\"));
+        StringUtil::toLowerASCIIFastInPlace(firstComponent);
+        if (!foldersToMap.contains(firstComponent)) {
+            // skip if not mapping from this folder
+            return;
+        }
+
+        if (!deploymentSAX.hasStagingPath()) {
+            pendingFiles.emplace_back(std::move(relPath), std::move(source));
+            return;
+        }
+
+        if (stagingPath.empty()) {
+            stagingPath = filesystem::path(StringUtil::utf8toUTF16(deploymentSAX.getStagingPath()));
+        }
+        mapFile(relPath, source);
+    });
+
+    ifstream vortexDepFileF(deploymentFile, ios::binary);
+    const bool parsed = nlohmann::json::sax_parse(vortexDepFileF, &deploymentSAX);
+    vortexDepFileF.close();
+
+    if (!parsed) {
+        throw runtime_error("Unable to parse Vortex deployment file "
+                            + StringUtil::utf16toUTF8(deploymentFile.wstring()) + ": " + deploymentSAX.getError());
+    }
+
+    // Check that files field exists
+    if (!deploymentSAX.hasFiles()) {
+        throw runtime_error("Vortex deployment file does not contain 'files' field: "
+                            + StringUtil::utf16toUTF8(deploymentFile.wstring()));
+    }
+
+    // Extract staging path where all Vortex mods are stored
+    if (!deploymentSAX.hasStagingPath()) {
+        throw runtime_error("Vortex deployment file does not contain 'stagingPath' field: "
+                            + StringUtil::utf16toUTF8(deploymentFile.wstring()));
+    }
+
+    stagingPath = filesystem::path(StringUtil::utf8toUTF16(deploymentSAX.getStagingPath()));
+    m_stagingLocation = stagingPath;
+
+    for (auto& [relPath, source] : pendingFiles) {
+        mapFile(relPath, source);
+    }
+    pendingFiles = {};
+
+    // later entries win, same as assigning one by one
+    m_modFileMap.reserve(m_modFileMap.size() + fileBatch.size());
+    for (auto& [relPath, modPtr] : fileBatch) {
+        m_modFileMap.insert_or_assign(filesystem::path(std::move(relPath)), ModFileEntry {.mod = std::move(modPtr)});
     }
 
     // delete any mods from file map that were not found
@@ -337,7 +543,8 @@ void PGModManager::populateModFileMapVortex(const filesystem::path& deploymentDi
 }
 
 void PGModManager::populateModFileMapMO2(const filesystem::path& instanceDir,
-                                         const filesystem::path& outputDir)
+                                         const filesystem::path& outputDir,
+                                         const bool& multithread)
 {
     // required file is modlist.txt in the profile folder
 
@@ -351,9 +558,10 @@ void PGModManager::populateModFileMapMO2(const filesystem::path& instanceDir,
     }
 
     auto mo2Paths = getMO2FilePaths(instanceDir);
-    const auto profileDir = mo2Paths.first;
-    const auto modDir = mo2Paths.second;
+    const auto profileDir = mo2Paths.profileDir;
+    const auto modDir = mo2Paths.modDir;
     m_stagingLocation = modDir;
+    m_overwriteLocation = mo2Paths.overwriteDir;
 
     // Find location of modlist.txt
     const auto curProfile = getSelectedProfileFromInstanceDir(instanceDir);
@@ -363,13 +571,19 @@ void PGModManager::populateModFileMapMO2(const filesystem::path& instanceDir,
                             + StringUtil::utf16toUTF8(modListFile.wstring()));
     }
 
+    struct ModScan {
+        shared_ptr<Mod> mod;
+        filesystem::path folder;
+        vector<wstring> files;
+    };
+
     ifstream modListFileF(modListFile);
-    bool foundOneMod = false;
 
-    // loop through modlist.txt
+    // loop through modlist.txt, mods are listed from highest to lowest priority
     string modStr;
     int basePriority = 0;
     unordered_set<wstring> foundMods;
+    vector<ModScan> modScans;
     while (getline(modListFileF, modStr)) {
         wstring mod = StringUtil::utf8toUTF16(modStr);
         if (mod.empty()) {
@@ -392,7 +606,6 @@ void PGModManager::populateModFileMapMO2(const filesystem::path& instanceDir,
             continue;
         }
 
-        // loop through all files in mod
         mod.erase(0, 1); // remove +
         const auto curModDir = modDir / mod;
 
@@ -411,8 +624,6 @@ void PGModManager::populateModFileMapMO2(const filesystem::path& instanceDir,
             return;
         }
 
-        foundOneMod = true;
-
         shared_ptr<Mod> modPtr = nullptr;
         if (m_modMap.contains(mod)) {
             // skip if already in map
@@ -429,68 +640,54 @@ void PGModManager::populateModFileMapMO2(const filesystem::path& instanceDir,
         foundMods.insert(mod);
 
         m_modMap[mod] = modPtr;
-        for (const auto& folder : PGGlobals::s_foldersToMap) {
-            const auto curSearchDir = curModDir / folder;
-            if (!filesystem::exists(curSearchDir)) {
-                // skip if folder doesn't exist
-                continue;
-            }
-
-            try {
-                for (auto it = filesystem::recursive_directory_iterator(
-                         curSearchDir, filesystem::directory_options::skip_permission_denied);
-                     it != filesystem::recursive_directory_iterator();
-                     ++it) {
-                    const auto file = *it;
-
-                    if (BethesdaDirectory::isHidden(file.path())) {
-                        if (file.is_directory()) {
-                            // If it's a directory, don't recurse into it
-                            it.disable_recursion_pending();
-                        }
-                        continue;
-                    }
-
-                    if (!filesystem::is_regular_file(file)) {
-                        continue;
-                    }
-
-                    // skip meta.ini file
-                    if (boost::iequals(file.path().filename().wstring(), L"meta.ini")) {
-                        continue;
-                    }
-
-                    auto relPath = filesystem::relative(file, curModDir);
-                    const filesystem::path relPathLower = StringUtil::toLowerASCII(relPath.wstring());
-                    // check if already in map
-                    if (m_modFileMap.contains(relPathLower)) {
-                        continue;
-                    }
+        modScans.push_back({.mod = modPtr, .folder = curModDir, .files = {}});
+    }
+    modListFileF.close();
 
-                    Logger::trace(L"Mapping file to mod: {} -> {}", relPathLower.wstring(), mod);
+    // scan all mod folders, each task only writes to its own file list
+    TaskPoolRunner scanRunner(multithread);
+    for (auto& modScan : modScans) {
+        scanRunner.addTask([&modScan] { modScan.files = scanMO2ModFolder(modScan.folder, modScan.mod->name); });
+    }
+    scanRunner.runTasks();
 
-                    m_modFileMap[relPathLower] = modPtr;
-                }
-            } catch (const filesystem::filesystem_error& e) {
-                Logger::error(L"Error reading mod directory {}: {}", mod, StringUtil::asciitoUTF16(e.what()));
+    // merge in modlist order so the highest priority mod wins every file, the rest are recorded as losers
+    size_t totalFiles = 0;
+    for (const auto& modScan : modScans) {
+        totalFiles += modScan.files.size();
+    }
+    m_modFileMap.clear();
+    m_modFileMap.reserve(totalFiles);
+
+    vector<pair<ModFileEntry*, const shared_ptr<Mod>*>> losers;
+    for (auto& modScan : modScans) {
+        for (auto& file : modScan.files) {
+            auto [it, inserted] = m_modFileMap.try_emplace(filesystem::path(std::move(file)));
+            if (!inserted) {
+                // already provided by a higher priority mod
+                it->second.losersCount++;
+                losers.emplace_back(&it->second, &modScan.mod);
+                continue;
             }
-        }
 
-        // map any BSAs
-        for (const auto& file : filesystem::directory_iterator(curModDir)) {
-            if (file.is_regular_file() && boost::iequals(file.path().extension().wstring(), ".bsa")) {
-                const auto relPath = filesystem::relative(file, curModDir);
-                const filesystem::path relPathLower = StringUtil::toLowerASCII(relPath.wstring());
-                // check if already in map
-                if (m_modFileMap.contains(relPathLower)) {
-                    continue;
-                }
+            Logger::trace(L"Mapping file to mod: {} -> {}", it->first.wstring(), modScan.mod->name);
 
-                Logger::trace(L"Mapping file to mod: {} -> {}", relPathLower.wstring(), mod);
-
-                m_modFileMap[relPathLower] = modPtr;
-            }
+            it->second.mod = modScan.mod;
         }
+        modScan.files = {};
+    }
+
+    // lay losers out contiguously per file, filling in the same order keeps them sorted by priority
+    m_modFileLosers.clear();
+    m_modFileLosers.resize(losers.size());
+    uint32_t loserOffset = 0;
+    for (auto& entry : m_modFileMap | views::values) {
+        entry.losersBegin = loserOffset;
+        loserOffset += entry.losersCount;
+        entry.losersCount = 0;
+    }
+    for (const auto& [entry, mod] : losers) {
+        m_modFileLosers[entry->losersBegin + entry->losersCount++] = *mod;
     }
 
     // delete any mods from file map that were not found
@@ -502,12 +699,67 @@ void PGModManager::populateModFileMapMO2(const filesystem::path& instanceDir,
         }
     }
 
-    if (!foundOneMod) {
+    if (modScans.empty()) {
         Logger::critical(L"MO2 modlist.txt was empty, no mods found");
         return;
     }
+}
 
-    modListFileF.close();
+auto PGModManager::scanMO2ModFolder(const filesystem::path& modDir,
+                                    const wstring& modName) -> vector<wstring>
+{
+    vector<wstring> files;
+
+    for (const auto& folder : PGGlobals::s_foldersToMap) {
+        const auto curSearchDir = modDir / folder;
+        if (!filesystem::exists(curSearchDir)) {
+            // skip if folder doesn't exist
+            continue;
+        }
+
+        try {
+            for (auto it = filesystem::recursive_directory_iterator(
+                     curSearchDir, filesystem::directory_options::skip_permission_denied);
+                 it != filesystem::recursive_directory_iterator();
+                 ++it) {
+                const auto& file = *it;
+
+                if (BethesdaDirectory::isHidden(file.path())) {
+                    if (file.is_directory()) {
+                        // If it's a directory, don't recurse into it
+                        it.disable_recursion_pending();
+                    }
+                    continue;
+                }
+
+                if (!file.is_regular_file()) {
+                    continue;
+                }
+
+                // skip meta.ini file
+                if (boost::iequals(file.path().filename().wstring(), L"meta.ini")) {
+                    continue;
+                }
+
+                auto relPath = file.path().lexically_relative(modDir).wstring();
+                StringUtil::toLowerASCIIFastInPlace(relPath);
+                files.push_back(std::move(relPath));
+            }
+        } catch (const filesystem::filesystem_error& e) {
+            Logger::error(L"Error reading mod directory {}: {}", modName, StringUtil::asciitoUTF16(e.what()));
+        }
+    }
+
+    // map any BSAs
+    for (const auto& file : filesystem::directory_iterator(modDir)) {
+        if (file.is_regular_file() && boost::iequals(file.path().extension().wstring(), ".bsa")) {
+            auto relPath = file.path().lexically_relative(modDir).wstring();
+            StringUtil::toLowerASCIIFastInPlace(relPath);
+            files.push_back(std::move(relPath));
+        }
+    }
+
+    return files;
 }
 
 auto PGModManager::getModManagerTypes() -> vector<ModManagerType>
@@ -531,6 +783,28 @@ auto PGModManager::getStrFromModManagerType(const ModManagerType& type) -> strin
 
 auto PGModManager::getStagingLocation() const -> const filesystem::path& { return m_stagingLocation; }
 
+auto PGModManager::getMO2OverlayFolders() const -> vector<filesystem::path>
+{
+    if (m_mmType != ModManagerType::MODORGANIZER2 || m_stagingLocation.empty()) {
+        return {};
+    }
+
+    // modlist.txt is highest priority first and only enabled mods are left in the mod map
+    const auto mods = getModsByDefaultOrder();
+
+    vector<filesystem::path> folders;
+    folders.reserve(mods.size() + 1);
+    for (const auto& mod : mods | views::reverse) {
+        folders.push_back(mod->folder);
+    }
+
+    if (filesystem::exists(m_overwriteLocation)) {
+        folders.push_back(m_overwriteLocation);
+    }
+
+    return folders;
+}
+
 auto PGModManager::getModManagerTypeFromStr(const string& type) -> ModManagerType
 {
     const static auto modManagerStrToTypeMap
@@ -702,17 +976,17 @@ auto PGModManager::getGameTypeFromInstanceDir(const std::filesystem::path& insta
     return BethesdaGame::GameType::UNKNOWN; // default to unknown if not found
 }
 
-auto PGModManager::getMO2FilePaths(const std::filesystem::path& instanceDir) -> std::pair<std::filesystem::path,
-                                                                                          std::filesystem::path>
+auto PGModManager::getMO2FilePaths(const std::filesystem::path& instanceDir) -> MO2Paths
 {
     // Find MO2 paths from ModOrganizer.ini
     const filesystem::path mo2IniFile = instanceDir / L"modorganizer.ini";
     if (!filesystem::exists(mo2IniFile)) {
-        return {{}, {}};
+        return {};
     }
 
     auto profileDirField = getMO2INIField(instanceDir, MO2INI_PROFILESDIR_KEY, true);
     auto modDirField = getMO2INIField(instanceDir, MO2INI_MODDIR_KEY, true);
+    auto overwriteDirField = getMO2INIField(instanceDir, MO2INI_OVERWRITEDIR_KEY, true);
     filesystem::path baseDir = getMO2INIField(instanceDir, MO2INI_BASEDIR_KEY, true);
 
     if (baseDir.empty()) {
@@ -724,9 +998,11 @@ auto PGModManager::getMO2FilePaths(const std::filesystem::path& instanceDir) ->
     const auto baseDirWildcardW = StringUtil::utf8toUTF16(MO2INI_BASEDIR_WILDCARD);
     boost::replace_all(profileDirField, baseDirWildcardW, baseDir.wstring());
     boost::replace_all(modDirField, baseDirWildcardW, baseDir.wstring());
+    boost::replace_all(overwriteDirField, baseDirWildcardW, baseDir.wstring());
 
     filesystem::path profileDir = profileDirField;
     filesystem::path modDir = modDirField;
+    filesystem::path overwriteDir = overwriteDirField;
 
     if (profileDir.empty()) {
         profileDir = baseDir / "profiles";
@@ -736,7 +1012,11 @@ auto PGModManager::getMO2FilePaths(const std::filesystem::path& instanceDir) ->
         modDir = baseDir / "mods";
     }
 
-    return {profileDir, modDir};
+    if (overwriteDir.empty()) {
+        overwriteDir = baseDir / "overwrite";
+    }
+
+    return {.profileDir = profileDir, .modDir = modDir, .overwriteDir = overwriteDir};
 }
 
 auto PGModManager::compareMods(const std::shared_ptr<Mod>& a,
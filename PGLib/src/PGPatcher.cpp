@@ -15,7 +15,9 @@
 #include "pgutil/PGNIFUtil.hpp"
 #include "pgutil/PGTypes.hpp"
 #include "util/Logger.hpp"
+#include "util/MemoryGovernor.hpp"
 #include "util/StringUtil.hpp"
+#include "util/TaskPipeline.hpp"
 #include "util/TaskPoolRunner.hpp"
 #include "util/TaskTracker.hpp"
 
@@ -28,20 +30,26 @@
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/asio.hpp>
-#include <boost/crc.hpp>
 #include <boost/iostreams/device/array.hpp>
 #include <boost/iostreams/stream.hpp>
 #include <boost/thread.hpp>
+#include <nlohmann/json.hpp>
 #include <nlohmann/json_fwd.hpp>
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <array>
+#include <charconv>
+#include <climits>
 #include <cstddef>
+#include <cstdint>
 #include <d3d11.h>
 #include <exception>
 #include <filesystem>
 #include <fmt/xchar.h>
+#include <fstream>
 #include <functional>
+#include <ios>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -49,6 +57,8 @@
 #include <shared_mutex>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -63,15 +73,18 @@ using namespace nifly;
 // statics
 PatcherUtil::PatcherMeshSet PGPatcher::s_meshPatchers;
 PatcherUtil::PatcherTextureSet PGPatcher::s_texPatchers;
-
-std::shared_mutex PGPatcher::s_diffJSONMutex;
-nlohmann::json PGPatcher::s_diffJSON;
+thread_local unique_ptr<PatcherUtil::PatcherMeshObjectSet> PGPatcher::s_patcherObjectPool;
+thread_local uint64_t PGPatcher::s_patcherObjectPoolGeneration = 0;
+array<PGPatcher::ShaderMatchMemoShard, 1ULL << PGPatcher::SHADER_MATCH_MEMO_SHARD_BITS> PGPatcher::s_shaderMatchMemo;
 
 void PGPatcher::loadPatchers(const PatcherUtil::PatcherMeshSet& meshPatchers,
                              const PatcherUtil::PatcherTextureSet& texPatchers)
 {
     s_meshPatchers = meshPatchers;
     s_texPatchers = texPatchers;
+    s_meshPatchersGeneration.fetch_add(1);
+
+    clearShaderMatchMemo();
 }
 
 void PGPatcher::patchMeshes(const bool& multiThread,
@@ -87,10 +100,17 @@ void PGPatcher::patchMeshes(const bool& multiThread,
     pgd->waitForCMClassification();
 
     // Init Handlers
-    HandlerLightPlacerTracker::init(pgd->getLightPlacerJSONs());
+    HandlerLightPlacerTracker::init(pgd->getLightPlacerJSONs(), multiThread);
     PatcherTextureHookConvertToCM::reset();
     PatcherTextureHookFixSSS::reset();
 
+    // configs and the data directory might have changed since the last run
+    clearShaderMatchMemo();
+    s_shaderMatchMemoHits = 0;
+    s_shaderMatchMemoMisses = 0;
+    s_meshPrefilterSkipped = 0;
+    s_meshPrefilterMisses = 0;
+
     //
     // MESH PATCHING
     //
@@ -111,23 +131,69 @@ void PGPatcher::patchMeshes(const bool& multiThread,
     }
 
     for (auto& [mesh, nifCache] : meshes) {
+        // _0/_1 weight variants run in one task so that they are validated against each other without a global cache
+        auto otherVariant = PGMeshPermutationTracker::getOtherWeightVariant(mesh);
+        const bool hasOtherVariant = otherVariant != mesh && meshes.contains(otherVariant);
+        if (hasOtherVariant && otherVariant < mesh) {
+            // scheduled with the other variant
+            continue;
+        }
+
         meshRunner.addTask([&taskTracker,
+                            &meshes,
                             &mesh,
+                            &nifCache,
+                            otherVariant = std::move(otherVariant),
+                            hasOtherVariant,
                             &setModelUsesQueue,
                             &forceBasePatch,
                             &allowedModelRecTypes,
                             &checkAllowedRecTypes,
                             &excludeFacegens] {
-            taskTracker.completeJob(patchNIF(
-                mesh, setModelUsesQueue, forceBasePatch, allowedModelRecTypes, checkAllowedRecTypes, excludeFacegens));
+            // weight variants are only skipped together, so that they are never validated against an unpatched mesh
+            const bool prefiltered = s_meshPrefilterEnabled.load() && !mayPatchNIF(mesh, nifCache)
+                && (!hasOtherVariant || !mayPatchNIF(otherVariant, meshes.at(otherVariant)));
+
+            PGMeshPermutationTracker::WeightVariantFingerprints weightVariants;
+            taskTracker.completeJob(patchNIF(mesh,
+                                             setModelUsesQueue,
+                                             forceBasePatch,
+                                             allowedModelRecTypes,
+                                             checkAllowedRecTypes,
+                                             excludeFacegens,
+                                             &weightVariants,
+                                             prefiltered));
+            if (hasOtherVariant) {
+                taskTracker.completeJob(patchNIF(otherVariant,
+                                                 setModelUsesQueue,
+                                                 forceBasePatch,
+                                                 allowedModelRecTypes,
+                                                 checkAllowedRecTypes,
+                                                 excludeFacegens,
+                                                 &weightVariants,
+                                                 prefiltered));
+            }
+
+            // final validation for weight variants
+            PGMeshPermutationTracker::reportUnmatchedWeightVariants(weightVariants);
         });
     }
 
     // Blocks until all tasks are done
     meshRunner.runTasks();
 
-    // final validation for weight variants
-    PGMeshPermutationTracker::validateWeightedVariants();
+    // mod conflicts were collected per thread
+    mergeModConflicts();
+
+    const auto memoStats = getShaderMatchMemoStats();
+    Logger::debug("Shader match memo: {} hits, {} misses", memoStats.hits, memoStats.misses);
+    clearShaderMatchMemo();
+
+    const auto prefilterStats = getMeshPrefilterStats();
+    Logger::debug("Mesh prefilter: {} of {} meshes skipped without loading", prefilterStats.skipped, meshes.size());
+    if (s_meshPrefilterVerify.load()) {
+        Logger::info("Mesh prefilter verification: {} skipped meshes were changed by patching", prefilterStats.misses);
+    }
 
     // Finalize handlers
     HandlerLightPlacerTracker::finalize();
@@ -138,6 +204,9 @@ void PGPatcher::patchMeshes(const bool& multiThread,
         Logger::info("Waiting for setting plugin model uses to complete...");
         setModelUsesQueue.waitForCompletion();
     }
+
+    // submit what is left of the batched model uses
+    PGPlugin::flushModelUses();
 }
 
 void PGPatcher::patchTextures(const bool& multiThread,
@@ -149,40 +218,120 @@ void PGPatcher::patchTextures(const bool& multiThread,
     pgd->waitForCMClassification();
 
     // Init Handlers
-    HandlerLightPlacerTracker::init(pgd->getLightPlacerJSONs());
+    HandlerLightPlacerTracker::init(pgd->getLightPlacerJSONs(), multiThread);
 
     //
     // TEXTURE PATCHING
     //
 
-    // texture runner
+    // texture pipeline
     auto textures = pgd->getTextures();
 
     // Create task tracker
     TaskTracker textureTaskTracker("Texture Patcher", textures.size());
-
-    // Create runner
-    TaskPoolRunner textureRunner(multiThread);
     if (progressCallback) {
         textureTaskTracker.setCallbackFunc(progressCallback);
     }
 
+    // Create pipeline, each stage gets its own bounded queue so that only a handful of decoded textures are in
+    // flight at once and file IO overlaps with GPU and compression work
+    auto availableThreads = static_cast<size_t>(std::thread::hardware_concurrency());
+    if (availableThreads == 0) {
+        availableThreads = 4;
+    }
+    const size_t cpuWorkers = std::max<size_t>(1, availableThreads / 4);
+
+    TaskPipeline<TextureJob> texturePipeline(multiThread);
+    texturePipeline.addStage("Read", TEXTURE_IO_WORKERS, TEXTURE_QUEUE_CAPACITY, readDDS);
+    texturePipeline.addStage("Decode", cpuWorkers, TEXTURE_QUEUE_CAPACITY, decodeDDS);
+    texturePipeline.addStage("Kernel", TEXTURE_KERNEL_WORKERS, TEXTURE_QUEUE_CAPACITY, runDDSKernels);
+    texturePipeline.addStage("Encode", cpuWorkers, TEXTURE_QUEUE_CAPACITY, encodeDDS);
+    texturePipeline.addStage("Write", TEXTURE_WRITE_WORKERS, TEXTURE_QUEUE_CAPACITY, writeDDS);
+    texturePipeline.setFinishFunc([&textureTaskTracker](TextureJob& job) {
+        // drop all image data before releasing its reservation
+        job.hookOutputs.clear();
+        job.ddsImage.Release();
+        job.ddsBytes = {};
+        s_texturePixelBudget.release(job.reservedBytes);
+        job.reservedBytes = 0;
+
+        textureTaskTracker.completeJob(job.result);
+    });
+    texturePipeline.setAbortFunc([]() { s_texturePixelBudget.cancel(); });
+
     // Add tasks
+    vector<TextureJob> jobs(textures.size());
+    size_t jobIdx = 0;
     for (const auto& texture : textures) {
-        textureRunner.addTask([&textureTaskTracker, &texture] { textureTaskTracker.completeJob(patchDDS(texture)); });
+        jobs[jobIdx++].ddsPath = texture;
     }
 
     // Blocks until all tasks are done
-    textureRunner.runTasks();
+    MemoryGovernor::attachBudget(&s_texturePixelBudget);
+    s_texturePixelBudget.resetPeak();
+    texturePipeline.run(std::move(jobs));
+    s_texturePixelBudget.resume();
+
+    texturePipeline.logStats("Texture Patcher");
+    Logger::debug("Texture Patcher peak decoded pixel memory: {} MiB of {} MiB budget",
+                  s_texturePixelBudget.getPeak() >> 20U,
+                  s_texturePixelBudget.getBudget() >> 20U);
 }
 
-auto PGPatcher::getPatchMeta() -> std::map<std::filesystem::path,
-                                           MeshMeta>
+void PGPatcher::setTexturePixelBudget(const size_t& bytes) { s_texturePixelBudget.setBudget(bytes); }
+
+void PGPatcher::setShaderMatchMemoEnabled(const bool& enabled)
 {
-    const shared_lock lock(s_meshPatchInfoMutex);
-    return s_meshPatchInfo;
+    s_shaderMatchMemoEnabled = enabled;
+    if (!enabled) {
+        clearShaderMatchMemo();
+    }
 }
 
+void PGPatcher::setMeshPrefilter(const bool& enabled,
+                                 const bool& verify)
+{
+    s_meshPrefilterEnabled = enabled;
+    s_meshPrefilterVerify = verify;
+}
+
+auto PGPatcher::getMeshPrefilterStats() -> MeshPrefilterStats
+{
+    return {.skipped = s_meshPrefilterSkipped.load(), .misses = s_meshPrefilterMisses.load()};
+}
+
+auto PGPatcher::getShaderMatchMemoStats() -> ShaderMatchMemoStats
+{
+    return {.hits = s_shaderMatchMemoHits.load(), .misses = s_shaderMatchMemoMisses.load()};
+}
+
+void PGPatcher::clearShaderMatchMemo()
+{
+    for (auto& shard : s_shaderMatchMemo) {
+        const unique_lock lock(shard.mutex);
+        shard.entries.clear();
+        MemoryGovernor::release(getShaderMatchMemoMemory(), shard.bytes);
+        shard.bytes = 0;
+    }
+}
+
+auto PGPatcher::getShaderMatchMemoMemory() -> MemoryGovernor::Subsystem*
+{
+    static auto* const subsystem = MemoryGovernor::registerSubsystem(
+        "Shader Match Memo", [](size_t /*bytes*/) -> void { clearShaderMatchMemo(); });
+    return subsystem;
+}
+
+auto PGPatcher::ShaderMatchKeyHash::operator()(const ShaderMatchKey& key) const -> size_t
+{
+    size_t seed = PGTypes::TextureSetHash {}(key.slots);
+    boost::hash_combine(seed, key.context);
+    boost::hash_combine(seed, key.shaderMask);
+    return seed;
+}
+
+auto PGPatcher::getPatchMeta() -> shared_ptr<const PGMeshPatchStore::View> { return s_meshPatchStore.getView(); }
+
 void PGPatcher::sortMatches(std::vector<PatcherUtil::ShaderPatcherMatch>& matches)
 {
     std::ranges::sort(
@@ -259,22 +408,22 @@ void PGPatcher::sortMatches(std::vector<MatchMeta>& matches,
     });
 }
 
-auto PGPatcher::hasConflictData() -> bool
-{
-    const shared_lock lock(s_meshPatchInfoMutex);
-    return !s_meshPatchInfo.empty();
-}
+auto PGPatcher::hasConflictData() -> bool { return !s_meshPatchStore.empty(); }
 
 void PGPatcher::resetRunState()
 {
+    s_meshPatchStore.clear();
+
     {
-        const unique_lock lock(s_meshPatchInfoMutex);
-        s_meshPatchInfo.clear();
+        const lock_guard lock(s_diffBuffersMutex);
+        s_diffBuffers.clear();
+        s_diffGeneration.fetch_add(1);
     }
 
     {
-        const unique_lock lock(s_diffJSONMutex);
-        s_diffJSON.clear();
+        const lock_guard lock(s_modConflictBuffersMutex);
+        s_modConflictBuffers.clear();
+        s_modConflictGeneration.fetch_add(1);
     }
 }
 
@@ -379,10 +528,89 @@ auto PGPatcher::isOutputEmpty() -> bool
     return true;
 }
 
+auto PGPatcher::hasDiffData() -> bool
+{
+    const lock_guard lock(s_diffBuffersMutex);
+    return ranges::any_of(s_diffBuffers, [](const auto& buffer) -> bool { return !buffer->records.empty(); });
+}
+
 auto PGPatcher::getDiffJSON() -> nlohmann::json
 {
-    const shared_lock lock(s_diffJSONMutex);
-    return s_diffJSON;
+    nlohmann::json diffJSON;
+    for (const auto& entry : getDiffEntries()) {
+        auto& meshJSON = diffJSON[string(entry.path)];
+        meshJSON["crc32original"] = entry.crc32original;
+        meshJSON["crc32patched"] = entry.crc32patched;
+    }
+
+    return diffJSON;
+}
+
+auto PGPatcher::saveDiffJSON(const filesystem::path& filePath) -> bool
+{
+    static constexpr size_t FLUSH_SIZE = 1ULL << 20ULL;
+
+    const auto entries = getDiffEntries();
+
+    ofstream outputFile;
+    outputFile.exceptions(std::ios::failbit | std::ios::badbit);
+    outputFile.open(filePath, ios::binary);
+    if (!outputFile.is_open()) {
+        // Unable to open file
+        return false;
+    }
+
+    if (entries.empty()) {
+        outputFile << "{}";
+        outputFile.close();
+        return true;
+    }
+
+    string out;
+    out.reserve(FLUSH_SIZE + 4096);
+
+    const auto appendNumber = [&out](const uint32_t& value) -> void {
+        array<char, 16> digits {};
+        const auto result = to_chars(digits.data(), digits.data() + digits.size(), value);
+        out.append(digits.data(), result.ptr);
+    };
+
+    // mirrors nlohmann::json::dump(2) of the document getDiffJSON builds, keys are already sorted like json objects
+    out += "{\n";
+    for (size_t entryIdx = 0; entryIdx < entries.size(); entryIdx++) {
+        const auto& entry = entries[entryIdx];
+
+        out += "  ";
+        const bool plainKey = ranges::all_of(entry.path, [](const char& c) -> bool {
+            const auto byte = static_cast<unsigned char>(c);
+            return byte >= 0x20 && byte < 0x80 && c != '"' && c != '\\';
+        });
+        if (plainKey) {
+            out += '"';
+            out += entry.path;
+            out += '"';
+        } else {
+            // escaping and invalid UTF-8 replacement are left to nlohmann
+            out += nlohmann::json(string(entry.path))
+                       .dump(-1, ' ', false, nlohmann::detail::error_handler_t::replace);
+        }
+
+        out += ": {\n    \"crc32original\": ";
+        appendNumber(entry.crc32original);
+        out += ",\n    \"crc32patched\": ";
+        appendNumber(entry.crc32patched);
+        out += entryIdx + 1 < entries.size() ? "\n  },\n" : "\n  }\n";
+
+        if (out.size() >= FLUSH_SIZE) {
+            outputFile.write(out.data(), static_cast<streamsize>(out.size()));
+            out.clear();
+        }
+    }
+    out += "}";
+
+    outputFile.write(out.data(), static_cast<streamsize>(out.size()));
+    outputFile.close();
+    return true;
 }
 
 auto PGPatcher::patchNIF(const std::filesystem::path& nifPath,
@@ -390,9 +618,11 @@ auto PGPatcher::patchNIF(const std::filesystem::path& nifPath,
                          const bool& forceBasePatch,
                          const std::unordered_set<PGPlugin::ModelRecordType>& allowedModelRecTypes,
                          const bool& checkAllowedRecTypes,
-                         const bool& excludeFacegens) -> TaskTracker::Result
+                         const bool& excludeFacegens,
+                         PGMeshPermutationTracker::WeightVariantFingerprints* weightVariants,
+                         const bool& prefiltered) -> TaskTracker::Result
 {
-    const Logger::Prefix nifPrefix(nifPath.wstring());
+    const Logger::Prefix nifPrefix(nifPath.native());
 
     // Get mod of nif
     if (PGGlobals::isPGMMSet()) {
@@ -407,7 +637,7 @@ auto PGPatcher::patchNIF(const std::filesystem::path& nifPath,
     }
 
     // Create mesh tracker for this NIF
-    auto meshTracker = PGMeshPermutationTracker(nifPath);
+    auto meshTracker = PGMeshPermutationTracker(nifPath, weightVariants);
 
     // check if we have the nif in cache
     auto* const pgd = PGGlobals::getPGD();
@@ -416,7 +646,7 @@ auto PGPatcher::patchNIF(const std::filesystem::path& nifPath,
         throw runtime_error("NIF not found in cache: " + nifPath.string());
     }
 
-    auto nifCache = meshes.at(nifPath);
+    const auto& nifCache = meshes.at(nifPath);
     const bool isFacegen = PGNIFUtil::isFacegenMesh(nifPath);
     if (isFacegen && excludeFacegens) {
         Logger::trace(L"Skipping NIF patching for facegen mesh (facegens excluded): {}", nifPath.wstring());
@@ -428,16 +658,17 @@ auto PGPatcher::patchNIF(const std::filesystem::path& nifPath,
         return TaskTracker::Result::SUCCESS;
     }
 
-    meshTracker.load();
-
     // Prepare meta
     MeshMeta meshMeta;
 
+    // points at the cached uses unless a dummy use is needed, which avoids copying the cache entry per mesh
+    const auto* meshUses = &nifCache.meshUses;
+    vector<pair<PGMeshPermutationTracker::FormKey, PGPlugin::MeshUseAttributes>> dummyUses;
     if (nifCache.meshUses.empty() && (forceBasePatch || isFacegen)) {
         // add a dummy mesh use to trigger base patching (pgtools uses this since no plugins)
         // always trigger dummy for facegen meshes since they never appear in plugins
         Logger::debug(L"Forcing non-plugin patching context for mesh: {}", nifPath.wstring());
-        const PGMeshPermutationTracker::FormKey dummyFormKey = {.modKey = L"", .formID = 0, .subMODL = ""};
+        const PGMeshPermutationTracker::FormKey dummyFormKey {};
         const PGPlugin::MeshUseAttributes dummyUse = {.isWeighted = false,
                                                       .singlepassMATO = false,
                                                       .isFacegen = isFacegen,
@@ -445,15 +676,30 @@ auto PGPatcher::patchNIF(const std::filesystem::path& nifPath,
                                                       .isDummyUse = true,
                                                       .recType = PGPlugin::ModelRecordType::UNKNOWN,
                                                       .alternateTextures = {}};
-        nifCache.meshUses.insert(nifCache.meshUses.begin(), make_pair(dummyFormKey, dummyUse));
+        dummyUses.emplace_back(dummyFormKey, dummyUse);
+        meshUses = &dummyUses;
     } else if (isFacegen) {
         // if this is true then there are mesh uses but this is a facegen mesh so we should throw a warning
         Logger::warn(L"NIF has mesh uses but is detected as a facegen mesh: {}", nifPath.wstring());
         return TaskTracker::Result::FAILURE;
     }
 
+    if (prefiltered) {
+        s_meshPrefilterSkipped.fetch_add(1, memory_order_relaxed);
+        if (!s_meshPrefilterVerify.load()) {
+            Logger::trace(L"Skipping NIF patching for mesh that no patcher would change: {}", nifPath.wstring());
+            s_meshPatchStore.add(
+                nifPath,
+                getPrefilteredMeta(nifPath, nifCache, *meshUses, allowedModelRecTypes, checkAllowedRecTypes));
+            return TaskTracker::Result::SUCCESS;
+        }
+    }
+
+    meshTracker.load();
+
     // loop through each use
-    for (auto use : nifCache.meshUses) {
+    unordered_map<unsigned int, PGTypes::TextureSet> alternateTextures;
+    for (const auto& use : *meshUses) {
         // process mesh patch for each and every occurance of the mesh in plugins
         if (use.second.isIgnored) {
             // This record is ignored, trigger tracker to ignore the base mesh and skip this patch
@@ -468,10 +714,16 @@ auto PGPatcher::patchNIF(const std::filesystem::path& nifPath,
             continue;
         }
 
-        const auto formKey = use.first;
+        const auto& formKey = use.first;
+
+        // subMODL is converted by the prefix, only when the prefix is logged
+        const Logger::Prefix dupPrefix(L"{}:{:06X}:{}", formKey.getModKey(), formKey.formID, formKey.getSubMODL());
 
-        const Logger::Prefix dupPrefix(
-            fmt::format(L"{}:{:06X}:{}", formKey.modKey, formKey.formID, StringUtil::utf8toUTF16(formKey.subMODL)));
+        // the cache holds interned paths, resolve them for this use only
+        alternateTextures.clear();
+        for (const auto& [slotID, textureIDs] : use.second.alternateTextures) {
+            alternateTextures.insert_or_assign(slotID, PGTypes::resolveTextureSet(textureIDs));
+        }
 
         // alternate textures do exist so we need to do some processing
         // stage a new mesh
@@ -479,15 +731,16 @@ auto PGPatcher::patchNIF(const std::filesystem::path& nifPath,
         unordered_set<unsigned int> enforceCheckBlocks;
         if (!processNIF(nifPath,
                         stagedNIF,
+                        meshTracker.getStagedBlockIndex(),
                         meshMeta,
                         use.second.singlepassMATO,
                         formKey,
                         use.second.recType,
-                        use.second.alternateTextures,
+                        alternateTextures,
                         enforceCheckBlocks)) {
             return TaskTracker::Result::FAILURE;
         }
-        if (meshTracker.commitMesh(formKey, use.second.isWeighted, use.second.alternateTextures, enforceCheckBlocks)) {
+        if (meshTracker.commitMesh(formKey, use.second.isWeighted, alternateTextures, enforceCheckBlocks)) {
             Logger::trace("Mesh committed");
         } else {
             Logger::trace("Mesh not committed (already exists or no changes)");
@@ -496,36 +749,144 @@ auto PGPatcher::patchNIF(const std::filesystem::path& nifPath,
 
     // Save meshes
     const auto saveResults = meshTracker.saveMeshes();
+    if (prefiltered && !saveResults.first.empty()) {
+        Logger::error(L"Mesh prefilter skipped a mesh that was changed by patching: {}", nifPath.wstring());
+        s_meshPrefilterMisses.fetch_add(1, memory_order_relaxed);
+    }
     setModelUsesQueue.queueTask([saveResults]() -> void { PGPlugin::setModelUses(saveResults.first); });
 
     // run handlers
     for (const auto& meshResult : saveResults.first) {
-        Logger::Prefix(L"Handler: " + meshResult.meshPath.wstring());
+        const Logger::Prefix handlerPrefix(L"Handler: {}", meshResult.meshPath.wstring());
         HandlerLightPlacerTracker::handleNIFCreated(nifPath, meshResult.meshPath);
     }
     // Add to diff JSON
-    const auto diffJSONKey = utf16toUTF8(nifPath.wstring());
     if (saveResults.second.second != 0) {
         // only add to diff if the base mesh actually saved, which is indicated by a non-zero patched crc32
         Logger::trace(
             "Base mesh was updated, saving diff CRC32: {} -> {}", saveResults.second.first, saveResults.second.second);
 
-        const unique_lock lock(s_diffJSONMutex);
-        s_diffJSON[diffJSONKey]["crc32original"] = saveResults.second.first;
-        s_diffJSON[diffJSONKey]["crc32patched"] = saveResults.second.second;
+        recordDiff(nifPath,
+                   static_cast<uint32_t>(saveResults.second.first),
+                   static_cast<uint32_t>(saveResults.second.second));
     }
 
     // Save mesh meta
-    {
-        const unique_lock lock(s_meshPatchInfoMutex);
-        s_meshPatchInfo[nifPath] = meshMeta;
-    }
+    s_meshPatchStore.add(nifPath, std::move(meshMeta));
 
     return TaskTracker::Result::SUCCESS;
 }
 
+auto PGPatcher::mayPatchNIF(const std::filesystem::path& nifPath,
+                            const PGDirectory::NifCache& nifCache) -> bool
+{
+    const auto& meshShapes = nifCache.meshShapes;
+
+    // the patchers only look at their configs and the slots here, they are not pointed at a NIF
+    const PatcherObjectLease patcherLease(nifPath, nullptr);
+    const auto& patchers = patcherLease.get();
+
+    for (const auto& globalPatcher : patchers.globalPatchers) {
+        if (globalPatcher->mayApply(meshShapes)) {
+            return true;
+        }
+    }
+
+    for (const auto& shape : meshShapes.shapes) {
+        for (const auto& prePatcher : patchers.prePatchers) {
+            if (prePatcher->mayApply(shape)) {
+                return true;
+            }
+        }
+
+        for (const auto& postPatcher : patchers.postPatchers) {
+            if (postPatcher->mayApply(shape)) {
+                return true;
+            }
+        }
+
+        if (shape.shaderPatchable && hasModifyingShaderMatch(PGTypes::resolveTextureSet(shape.textureSet), patchers)) {
+            return true;
+        }
+    }
+
+    // alternate textures are keyed by 3D index, which the scanner does not know, so the matches of these meshes can
+    // only be recorded for the conflict view by patching them
+    return ranges::any_of(nifCache.meshUses,
+                          [](const auto& use) -> bool { return !use.second.alternateTextures.empty(); });
+}
+
+auto PGPatcher::hasModifyingShaderMatch(const PGTypes::TextureSet& slots,
+                                        const PatcherUtil::PatcherMeshObjectSet& patchers) -> bool
+{
+    const auto matches = getShaderMatches(slots, patchers);
+    return ranges::any_of(matches, [&patchers](const PatcherUtil::ShaderPatcherMatch& match) -> bool {
+        return patchers.shaderPatchers.at(match.shader)->modifiesShapes()
+            || patchers.shaderTransformPatchers.contains(match.shader);
+    });
+}
+
+auto PGPatcher::getPrefilteredMeta(
+    const std::filesystem::path& nifPath,
+    const PGDirectory::NifCache& nifCache,
+    const std::vector<std::pair<PGMeshPermutationTracker::FormKey,
+                                PGPlugin::MeshUseAttributes>>& meshUses,
+    const std::unordered_set<PGPlugin::ModelRecordType>& allowedModelRecTypes,
+    const bool& checkAllowedRecTypes) -> MeshMeta
+{
+    MeshMeta meshMeta;
+    for (const auto& [formKey, use] : meshUses) {
+        if (use.isIgnored || (checkAllowedRecTypes && !use.isDummyUse && !allowedModelRecTypes.contains(use.recType))) {
+            continue;
+        }
+
+        meshMeta.formKeys.push_back(formKey);
+    }
+
+    // without patcher objects getMatches skips canApply, which is always true for the default shader, the only one
+    // that can match here. The matches do not depend on the use since mayPatchNIF rejects alternate textures
+    const PatcherObjectLease patcherLease(nifPath, nullptr);
+    for (const auto& shape : nifCache.meshShapes.shapes) {
+        MeshShapeMeta shapeMeta;
+        shapeMeta.blockID = shape.blockID;
+        shapeMeta.shapeName = PGMeshPatchStore::internShapeName(shape.name);
+
+        if (shape.shaderPatchable && !meshMeta.formKeys.empty()) {
+            const auto matches = getMatches(PGTypes::resolveTextureSet(shape.textureSet),
+                                            patcherLease.get(),
+                                            false,
+                                            PGPlugin::ModelRecordType::UNKNOWN);
+
+            vector<MatchMeta> matchMetas;
+            matchMetas.reserve(matches.size());
+            for (const auto& match : matches) {
+                matchMetas.push_back(getMatchMeta(match));
+            }
+
+            for (const auto& formKey : meshMeta.formKeys) {
+                shapeMeta.matches[formKey] = matchMetas;
+            }
+        }
+
+        meshMeta.shapeMeta.push_back(std::move(shapeMeta));
+    }
+
+    for (const auto& shape : nifCache.meshShapes.otherShapes) {
+        MeshShapeMeta shapeMeta;
+        shapeMeta.blockID = shape.blockID;
+        shapeMeta.shapeName = PGMeshPatchStore::internShapeName(shape.name);
+        meshMeta.shapeMeta.push_back(std::move(shapeMeta));
+    }
+
+    // the 3D index order processNIF uses is not known without loading the NIF, block order is the closest stable one
+    ranges::sort(meshMeta.shapeMeta, {}, &MeshShapeMeta::blockID);
+
+    return meshMeta;
+}
+
 auto PGPatcher::processNIF(const std::filesystem::path& nifPath,
                            nifly::NifFile* nif,
+                           PGNIFBlockIndex& blockIndex,
                            MeshMeta& meshMeta,
                            bool singlepassMATO,
                            const PGMeshPermutationTracker::FormKey& formKey,
@@ -534,19 +895,24 @@ auto PGPatcher::processNIF(const std::filesystem::path& nifPath,
                                               PGTypes::TextureSet>& alternateTextures,
                            std::unordered_set<unsigned int>& nonAltTexShapes) -> bool
 {
-    // Create patcher objects
-    const auto patcherObjects = createNIFPatcherObjects(nifPath, nif);
+    // Borrow the patcher objects of this thread, they pick up the block index of this NIF instead of walking the tree
+    const PGNIFBlockIndex::Scope blockIndexScope(blockIndex);
+    const PatcherObjectLease patcherLease(nifPath, nif);
+    const auto& patcherObjects = patcherLease.get();
 
-    // Get shapes and index 3ds (this is in the order as they would show up as 3d indices in plugins)
-    const auto shapes = PGNIFUtil::getShapesWith3DIdx(nif);
+    // Get shapes and index 3ds (this is in the order as they would show up as 3d indices in plugins). Copied since
+    // patchers may change the block structure while we loop
+    const auto shapes = blockIndex.getShapes();
 
     meshMeta.formKeys.push_back(formKey);
 
     size_t shapeMetaIdx = 0;
-    for (const auto& [nifShape, oldIndex3D] : shapes) {
+    for (const auto& shapeEntry : shapes) {
+        auto* const nifShape = shapeEntry.shape;
+        const auto oldIndex3D = shapeEntry.index3D;
         const auto shapeBlockID = nif->GetBlockID(nifShape);
-        const auto shapeName = nifShape->name.get();
-        const Logger::Prefix shapePrefix(to_string(shapeBlockID) + "/" + shapeName + "/" + to_string(oldIndex3D));
+        const auto& shapeName = nifShape->name.get();
+        const Logger::Prefix shapePrefix("{}/{}/{}", shapeBlockID, shapeName, oldIndex3D);
 
         if (nifShape == nullptr) {
             // Skip if shape is null (invalid shapes)
@@ -560,9 +926,13 @@ auto PGPatcher::processNIF(const std::filesystem::path& nifPath,
             continue;
         }
 
+        // shape indices repeat for every form key of the mesh
+        if (meshMeta.shapeMeta.size() <= shapeMetaIdx) {
+            meshMeta.shapeMeta.resize(shapeMetaIdx + 1);
+        }
         auto& curMeshShapeMeta = meshMeta.shapeMeta[shapeMetaIdx++];
         curMeshShapeMeta.blockID = shapeBlockID;
-        curMeshShapeMeta.shapeName = shapeName;
+        curMeshShapeMeta.shapeName = PGMeshPatchStore::internShapeName(shapeName);
 
         PGTypes::TextureSet* ptrAltTex = nullptr;
         if (alternateTextures.contains(oldIndex3D)) {
@@ -586,9 +956,9 @@ auto PGPatcher::processNIF(const std::filesystem::path& nifPath,
 
     // Run global patchers
     for (const auto& globalPatcher : patcherObjects.globalPatchers) {
-        const Logger::Prefix prefixPatches(utf8toUTF16(globalPatcher->getPatcherName()));
+        const Logger::Prefix prefixPatches(globalPatcher->getPatcherName());
         if (globalPatcher->applyPatch()) {
-            meshMeta.globalPatchersApplied.push_back(globalPatcher->getPatcherName());
+            meshMeta.globalPatchersApplied |= PGMeshPatchStore::getPatcherBit(globalPatcher->getPatcherName());
         }
     }
 
@@ -626,13 +996,15 @@ auto PGPatcher::processNIFShape(const std::filesystem::path& nifPath,
     }
 
     // log slots
-    Logger::trace("Texture Slots: {}", PGTypes::getStrFromTextureSlots(slots));
+    if (Logger::shouldLog(spdlog::level::trace)) {
+        Logger::trace("Texture Slots: {}", PGTypes::getStrFromTextureSlots(slots));
+    }
 
     // apply prepatchers
     for (const auto& prePatcher : patchers.prePatchers) {
         const Logger::Prefix prefixPatches(prePatcher->getPatcherName());
         if (prePatcher->applyPatch(slots, *nifShape)) {
-            meshShapeMeta.prePatchersApplied.push_back(prePatcher->getPatcherName());
+            meshShapeMeta.prePatchersApplied |= PGMeshPatchStore::getPatcherBit(prePatcher->getPatcherName());
 
             if (nif->GetBlockID(nifShape) == NIF_NPOS) {
                 // shape was deleted, nothing else to do
@@ -648,12 +1020,7 @@ auto PGPatcher::processNIFShape(const std::filesystem::path& nifPath,
 
         // Add matches to mesh shape meta
         for (const auto& match : matches) {
-            MatchMeta matchMeta;
-            matchMeta.mod = match.mod;
-            matchMeta.shader = match.shader;
-            matchMeta.shaderTransformTo = match.shaderTransformTo;
-            matchMeta.matchedPath = match.match.matchedPath;
-            meshShapeMeta.matches[formKey].push_back(matchMeta);
+            meshShapeMeta.matches[formKey].push_back(getMatchMeta(match));
 
             if (match.mod != nullptr) {
                 const std::shared_lock lk(match.mod->mutex);
@@ -675,10 +1042,12 @@ auto PGPatcher::processNIFShape(const std::filesystem::path& nifPath,
                 Logger::trace("Shader transform was applied");
             }
 
-            Logger::trace(L"Winning Match: {} / {} / {}",
-                          utf8toUTF16(PGEnums::getStrFromShader(winningShaderMatch.shader)),
-                          winningShaderMatch.mod == nullptr ? L"" : winningShaderMatch.mod->name,
-                          winningShaderMatch.match.matchedPath);
+            if (Logger::shouldLog(spdlog::level::trace)) {
+                Logger::trace(L"Winning Match: {} / {} / {}",
+                              utf8toUTF16(PGEnums::getStrFromShader(winningShaderMatch.shader)),
+                              winningShaderMatch.mod == nullptr ? L"" : winningShaderMatch.mod->name,
+                              winningShaderMatch.match.matchedPath);
+            }
 
             // loop through patchers
             patchers.shaderPatchers.at(winningShaderMatch.shader)
@@ -711,7 +1080,7 @@ auto PGPatcher::processNIFShape(const std::filesystem::path& nifPath,
     for (const auto& postPatcher : patchers.postPatchers) {
         const Logger::Prefix prefixPatches(postPatcher->getPatcherName());
         if (postPatcher->applyPatch(slots, *nifShape)) {
-            meshShapeMeta.postPatchersApplied.push_back(postPatcher->getPatcherName());
+            meshShapeMeta.postPatchersApplied |= PGMeshPatchStore::getPatcherBit(postPatcher->getPatcherName());
 
             if (nif->GetBlockID(nifShape) == NIF_NPOS) {
                 // shape was deleted, nothing else to do
@@ -728,11 +1097,23 @@ auto PGPatcher::processNIFShape(const std::filesystem::path& nifPath,
         *alternateTexture = slots;
     }
 
-    Logger::trace("Texture Slots Modified: {}", PGTypes::getStrFromTextureSlots(slots));
+    if (Logger::shouldLog(spdlog::level::trace)) {
+        Logger::trace("Texture Slots Modified: {}", PGTypes::getStrFromTextureSlots(slots));
+    }
 
     return true;
 }
 
+auto PGPatcher::getMatchMeta(const PatcherUtil::ShaderPatcherMatch& match) -> MatchMeta
+{
+    MatchMeta matchMeta;
+    matchMeta.mod = match.mod;
+    matchMeta.shader = match.shader;
+    matchMeta.shaderTransformTo = match.shaderTransformTo;
+    matchMeta.matchedPath = match.match.matchedPath;
+    return matchMeta;
+}
+
 auto PGPatcher::getMatches(const PGTypes::TextureSet& slots,
                            const PatcherUtil::PatcherMeshObjectSet& patchers,
                            bool singlepassMATO,
@@ -740,9 +1121,6 @@ auto PGPatcher::getMatches(const PGTypes::TextureSet& slots,
                            const PatcherUtil::PatcherMeshObjectSet* patcherObjects,
                            nifly::NiShape* shape) -> std::vector<PatcherUtil::ShaderPatcherMatch>
 {
-    vector<PatcherUtil::ShaderPatcherMatch> matches;
-
-    unordered_set<shared_ptr<PGModManager::Mod>, PGModManager::Mod::ModHash> modSet;
     if (patcherObjects != nullptr && patchers.shaderPatchers.size() != patcherObjects->shaderPatchers.size()) {
         throw runtime_error("Patcher objects size mismatch");
     }
@@ -751,56 +1129,18 @@ auto PGPatcher::getMatches(const PGTypes::TextureSet& slots,
         throw runtime_error("If shape or patcherObjects is set, both must be set");
     }
 
-    for (const auto& [shader, patcher] : patchers.shaderPatchers) {
-        // note: name is defined in source code in UTF8-encoded files
-        const Logger::Prefix prefixPatches(patcher->getPatcherName());
+    auto matches = getShaderMatches(slots, patchers);
 
-        // Check if shader should be applied
-        vector<PatcherMeshShader::PatcherMatch> curMatches;
-        if (!patcher->shouldApply(slots, curMatches)) {
-            Logger::trace(L"Rejecting: Shader not applicable");
-            continue;
-        }
-
-        for (const auto& match : curMatches) {
-            if (!PGGlobals::getPGD()->isFile(match.matchedPath)) {
-                Logger::trace(L"Rejecting: Matched path '{}' is not a file", match.matchedPath);
-                continue;
-            }
-
-            PatcherUtil::ShaderPatcherMatch curMatch;
-            if (PGGlobals::isPGMMSet()) {
-                curMatch.mod = PGGlobals::getPGMM()->getModByFileSmart(match.matchedPath);
-            }
-
-            curMatch.shader = shader;
-            curMatch.match = match;
-            curMatch.shaderTransformTo = PGEnums::ShapeShader::UNKNOWN;
-
-            matches.push_back(curMatch);
-            if (curMatch.mod != nullptr) {
-                // add mod to set
-                modSet.insert(curMatch.mod);
-            }
+    // Populate conflict mods if more than one mod matched, distinct mods are usually only a handful
+    vector<const shared_ptr<PGModManager::Mod>*> matchedMods;
+    for (const auto& match : matches) {
+        if (match.mod != nullptr
+            && ranges::none_of(matchedMods, [&match](const auto* mod) -> bool { return *mod == match.mod; })) {
+            matchedMods.push_back(&match.mod);
         }
     }
-
-    // Populate conflict mods if set
-    if (!modSet.empty()) {
-        // add mods to conflict set
-        for (const auto& match : matches) {
-            if (match.mod == nullptr) {
-                continue;
-            }
-
-            const unique_lock lock(match.mod->mutex);
-
-            for (const auto& conflictMod : modSet) {
-                if (conflictMod != match.mod) {
-                    match.mod->conflicts.insert(conflictMod);
-                }
-            }
-        }
+    if (matchedMods.size() > 1) {
+        recordModConflicts(matchedMods);
     }
 
     // Loop through matches and delete any that cannot apply
@@ -859,6 +1199,99 @@ auto PGPatcher::getMatches(const PGTypes::TextureSet& slots,
     return matches;
 }
 
+auto PGPatcher::getShaderMatches(const PGTypes::TextureSet& slots,
+                                 const PatcherUtil::PatcherMeshObjectSet& patchers)
+    -> vector<PatcherUtil::ShaderPatcherMatch>
+{
+    if (!s_shaderMatchMemoEnabled.load()
+        || !ranges::all_of(patchers.shaderPatchers,
+                           [](const auto& patcher) -> bool { return patcher.second->canMemoizeMatches(); })) {
+        return findShaderMatches(slots, patchers);
+    }
+
+    ShaderMatchKey key;
+    key.slots = slots;
+    for (const auto& [shader, patcher] : patchers.shaderPatchers) {
+        key.shaderMask |= 1U << static_cast<uint32_t>(shader);
+        key.context += patcher->getMatchContext();
+    }
+
+    // shard by the high bits, the maps use the low bits for their buckets
+    const size_t keyHash = ShaderMatchKeyHash {}(key);
+    auto& shard = s_shaderMatchMemo.at(keyHash >> ((sizeof(size_t) * CHAR_BIT) - SHADER_MATCH_MEMO_SHARD_BITS));
+    {
+        const shared_lock lock(shard.mutex);
+        const auto it = shard.entries.find(key);
+        if (it != shard.entries.end()) {
+            s_shaderMatchMemoHits.fetch_add(1, memory_order_relaxed);
+            return it->second;
+        }
+    }
+
+    // found without holding the lock, threads racing on the same texture set find the same matches
+    s_shaderMatchMemoMisses.fetch_add(1, memory_order_relaxed);
+    auto matches = findShaderMatches(slots, patchers);
+
+    size_t entryBytes = sizeof(ShaderMatchKey) + (key.context.size() * sizeof(wchar_t))
+        + (matches.capacity() * sizeof(PatcherUtil::ShaderPatcherMatch));
+    for (const auto& slot : key.slots) {
+        entryBytes += slot.size() * sizeof(wchar_t);
+    }
+    for (const auto& match : matches) {
+        entryBytes += match.match.matchedPath.size() * sizeof(wchar_t);
+    }
+
+    {
+        const unique_lock lock(shard.mutex);
+        if (shard.entries.try_emplace(std::move(key), matches).second) {
+            shard.bytes += entryBytes;
+            MemoryGovernor::charge(getShaderMatchMemoMemory(), entryBytes);
+        }
+    }
+    MemoryGovernor::reclaim(getShaderMatchMemoMemory());
+
+    return matches;
+}
+
+auto PGPatcher::findShaderMatches(const PGTypes::TextureSet& slots,
+                                  const PatcherUtil::PatcherMeshObjectSet& patchers)
+    -> vector<PatcherUtil::ShaderPatcherMatch>
+{
+    vector<PatcherUtil::ShaderPatcherMatch> matches;
+
+    for (const auto& [shader, patcher] : patchers.shaderPatchers) {
+        // note: name is defined in source code in UTF8-encoded files
+        const Logger::Prefix prefixPatches(patcher->getPatcherName());
+
+        // Check if shader should be applied
+        vector<PatcherMeshShader::PatcherMatch> curMatches;
+        if (!patcher->shouldApply(slots, curMatches)) {
+            Logger::trace(L"Rejecting: Shader not applicable");
+            continue;
+        }
+
+        for (const auto& match : curMatches) {
+            if (!PGGlobals::getPGD()->isFile(match.matchedPath)) {
+                Logger::trace(L"Rejecting: Matched path '{}' is not a file", match.matchedPath);
+                continue;
+            }
+
+            PatcherUtil::ShaderPatcherMatch curMatch;
+            if (PGGlobals::isPGMMSet()) {
+                curMatch.mod = PGGlobals::getPGMM()->getModByFileSmart(match.matchedPath);
+            }
+
+            curMatch.shader = shader;
+            curMatch.match = match;
+            curMatch.shaderTransformTo = PGEnums::ShapeShader::UNKNOWN;
+
+            matches.push_back(std::move(curMatch));
+        }
+    }
+
+    return matches;
+}
+
 auto PGPatcher::applyTransformIfNeeded(PatcherUtil::ShaderPatcherMatch& match,
                                        const PatcherUtil::PatcherMeshObjectSet& patchers) -> bool
 {
@@ -879,6 +1312,122 @@ auto PGPatcher::applyTransformIfNeeded(PatcherUtil::ShaderPatcherMatch& match,
     return false;
 }
 
+void PGPatcher::recordModConflicts(const vector<const shared_ptr<PGModManager::Mod>*>& mods)
+{
+    thread_local shared_ptr<ModConflictBuffer> buffer;
+    thread_local uint64_t bufferGeneration = 0;
+
+    const auto curGeneration = s_modConflictGeneration.load();
+    if (buffer == nullptr || bufferGeneration != curGeneration) {
+        // first record on this thread since the last merge
+        buffer = make_shared<ModConflictBuffer>();
+        bufferGeneration = curGeneration;
+
+        const lock_guard lock(s_modConflictBuffersMutex);
+        s_modConflictBuffers.push_back(buffer);
+    }
+
+    for (const auto* const mod : mods) {
+        // only copies the shared_ptr the first time this thread sees the mod
+        buffer->mods.try_emplace(mod->get(), *mod);
+
+        for (const auto* const conflictMod : mods) {
+            if (conflictMod != mod) {
+                buffer->edges.emplace(mod->get(), conflictMod->get());
+            }
+        }
+    }
+}
+
+void PGPatcher::mergeModConflicts()
+{
+    vector<shared_ptr<ModConflictBuffer>> buffers;
+    {
+        const lock_guard lock(s_modConflictBuffersMutex);
+        buffers.swap(s_modConflictBuffers);
+        s_modConflictGeneration.fetch_add(1);
+    }
+
+    // group by mod so each mod is locked once
+    unordered_map<PGModManager::Mod*, vector<shared_ptr<PGModManager::Mod>>> conflictsByMod;
+    for (const auto& buffer : buffers) {
+        for (const auto& [mod, conflictMod] : buffer->edges) {
+            conflictsByMod[mod].push_back(buffer->mods.at(conflictMod));
+        }
+    }
+
+    for (auto& [mod, conflictMods] : conflictsByMod) {
+        const unique_lock lock(mod->mutex);
+        for (auto& conflictMod : conflictMods) {
+            mod->conflicts.insert(std::move(conflictMod));
+        }
+    }
+}
+
+void PGPatcher::recordDiff(const filesystem::path& nifPath,
+                           const uint32_t& crc32original,
+                           const uint32_t& crc32patched)
+{
+    thread_local shared_ptr<DiffBuffer> buffer;
+    thread_local uint64_t bufferGeneration = 0;
+
+    const auto curGeneration = s_diffGeneration.load();
+    if (buffer == nullptr || bufferGeneration != curGeneration) {
+        // first record on this thread since the last reset
+        buffer = make_shared<DiffBuffer>();
+        bufferGeneration = curGeneration;
+
+        const lock_guard lock(s_diffBuffersMutex);
+        s_diffBuffers.push_back(buffer);
+    }
+
+    const auto path = utf16toUTF8(nifPath.wstring());
+    buffer->records.push_back({.pathOffset = static_cast<uint32_t>(buffer->paths.size()),
+                               .pathLength = static_cast<uint32_t>(path.size()),
+                               .crc32original = crc32original,
+                               .crc32patched = crc32patched});
+    buffer->paths += path;
+}
+
+auto PGPatcher::getDiffEntries() -> vector<DiffEntry>
+{
+    vector<DiffEntry> entries;
+
+    {
+        const lock_guard lock(s_diffBuffersMutex);
+
+        size_t numRecords = 0;
+        for (const auto& buffer : s_diffBuffers) {
+            numRecords += buffer->records.size();
+        }
+        entries.reserve(numRecords);
+
+        for (const auto& buffer : s_diffBuffers) {
+            const string_view paths = buffer->paths;
+            for (const auto& record : buffer->records) {
+                entries.push_back({.path = paths.substr(record.pathOffset, record.pathLength),
+                                   .crc32original = record.crc32original,
+                                   .crc32patched = record.crc32patched});
+            }
+        }
+    }
+
+    // stable so that the last record of a path stays last, same as overwriting a json key
+    ranges::stable_sort(entries, {}, &DiffEntry::path);
+
+    size_t outIdx = 0;
+    for (size_t inIdx = 0; inIdx < entries.size(); inIdx++) {
+        if (outIdx > 0 && entries[outIdx - 1].path == entries[inIdx].path) {
+            entries[outIdx - 1] = entries[inIdx];
+            continue;
+        }
+        entries[outIdx++] = entries[inIdx];
+    }
+    entries.resize(outIdx);
+
+    return entries;
+}
+
 auto PGPatcher::createNIFPatcherObjects(const std::filesystem::path& nifPath,
                                         nifly::NifFile* nif) -> PatcherUtil::PatcherMeshObjectSet
 {
@@ -907,81 +1456,205 @@ auto PGPatcher::createNIFPatcherObjects(const std::filesystem::path& nifPath,
     return patcherObjects;
 }
 
-auto PGPatcher::patchDDS(const filesystem::path& ddsPath) -> TaskTracker::Result
+PGPatcher::PatcherObjectLease::PatcherObjectLease(const std::filesystem::path& nifPath,
+                                                 nifly::NifFile* nif)
+    : m_generation(s_meshPatchersGeneration.load())
+{
+    if (s_patcherObjectPool != nullptr && s_patcherObjectPoolGeneration == m_generation) {
+        m_objects = std::move(s_patcherObjectPool);
+        m_objects->rebind(nifPath, nif);
+        return;
+    }
+
+    // first NIF on this thread since patchers were loaded, or the pooled objects are already borrowed
+    m_objects = make_unique<PatcherUtil::PatcherMeshObjectSet>(createNIFPatcherObjects(nifPath, nif));
+}
+
+PGPatcher::PatcherObjectLease::~PatcherObjectLease()
 {
-    auto result = TaskTracker::Result::SUCCESS;
+    // drop NIF pointers and per NIF state so nothing outlives the mesh tracker
+    m_objects->rebind({}, nullptr);
+
+    if (m_generation == s_meshPatchersGeneration.load()) {
+        s_patcherObjectPool = std::move(m_objects);
+        s_patcherObjectPoolGeneration = m_generation;
+    }
+}
 
+auto PGPatcher::PatcherObjectLease::get() const -> const PatcherUtil::PatcherMeshObjectSet& { return *m_objects; }
+
+auto PGPatcher::readDDS(TextureJob& job) -> bool
+{
     auto* const pgd = PGGlobals::getPGD();
 
     // Check if this texture needs to be processed
-    if (s_texPatchers.globalPatchers.empty() && !PatcherTextureHookConvertToCM::isInProcessList(ddsPath)
-        && !PatcherTextureHookFixSSS::isInProcessList(ddsPath)) {
+    if (s_texPatchers.globalPatchers.empty() && !PatcherTextureHookConvertToCM::isInProcessList(job.ddsPath)
+        && !PatcherTextureHookFixSSS::isInProcessList(job.ddsPath)) {
         // No patchers, so we can skip
-        return result;
+        return false;
     }
 
-    Logger::debug(L"Cache for DDS {} is invalidated or nonexistent", ddsPath.wstring());
+    Logger::debug(L"Cache for DDS {} is invalidated or nonexistent", job.ddsPath.wstring());
 
     // Prep
     Logger::trace(L"Starting Processing");
 
     // only allow DDS files
-    const string ddsFileExt = ddsPath.extension().string();
+    const string ddsFileExt = job.ddsPath.extension().string();
     if (ddsFileExt != ".dds") {
         throw runtime_error("File is not a DDS file");
     }
 
-    DirectX::ScratchImage ddsImage;
-    if (!PGGlobals::getPGD3D()->getDDS(ddsPath, ddsImage)) {
-        Logger::error(L"Unable to process texture: {}", ddsPath.wstring());
-        return TaskTracker::Result::FAILURE;
+    try {
+        job.ddsBytes = pgd->getFile(job.ddsPath);
+    } catch (...) {
+        Logger::error(L"Unable to process texture: {}", job.ddsPath.wstring());
+        job.result = TaskTracker::Result::FAILURE;
+        return false;
+    }
+
+    return true;
+}
+
+auto PGPatcher::decodeDDS(TextureJob& job) -> bool
+{
+    DirectX::TexMetadata ddsMeta {};
+    HRESULT hr = DirectX::GetMetadataFromDDSMemory(
+        job.ddsBytes.data(), job.ddsBytes.size(), DirectX::DDS_FLAGS_NONE, ddsMeta);
+    if (FAILED(hr)) {
+        Logger::error(L"Unable to process texture: {}", job.ddsPath.wstring());
+        job.result = TaskTracker::Result::FAILURE;
+        return false;
     }
 
+    // reserve an estimate of the decoded size before allocating, this is where the pipeline waits for memory
+    size_t rowPitch = 0;
+    size_t slicePitch = 0;
+    size_t estimate = job.ddsBytes.size();
+    if (SUCCEEDED(DirectX::ComputePitch(ddsMeta.format, ddsMeta.width, ddsMeta.height, rowPitch, slicePitch))) {
+        // a full mip chain adds a third on top of the base level
+        estimate = slicePitch * ddsMeta.depth * ddsMeta.arraySize * 4 / 3;
+    }
+    // make room in the caches first so that decoded pixels are not what pushes the process over the total budget
+    MemoryGovernor::reclaim(nullptr, estimate);
+    if (!s_texturePixelBudget.acquire(estimate)) {
+        // pipeline was aborted while waiting
+        job.result = TaskTracker::Result::FAILURE;
+        return false;
+    }
+    job.reservedBytes += estimate;
+
+    hr = DirectX::LoadFromDDSMemory(
+        job.ddsBytes.data(), job.ddsBytes.size(), DirectX::DDS_FLAGS_NONE, nullptr, job.ddsImage);
+    job.ddsBytes = {};
+    if (FAILED(hr)) {
+        Logger::error(L"Unable to process texture: {}", job.ddsPath.wstring());
+        job.result = TaskTracker::Result::FAILURE;
+        return false;
+    }
+
+    // replace the estimate with the real size
+    s_texturePixelBudget.adjust(estimate, job.ddsImage.GetPixelsSize());
+    job.reservedBytes = job.reservedBytes - estimate + job.ddsImage.GetPixelsSize();
+
+    return true;
+}
+
+auto PGPatcher::runDDSKernels(TextureJob& job) -> bool
+{
     // Run any hook patchers (these create other textures)
-    if (PatcherTextureHookConvertToCM::isInProcessList(ddsPath)) {
-        auto patcher = PatcherTextureHookConvertToCM(ddsPath, &ddsImage);
-        if (!patcher.applyPatch()) {
-            Logger::error(L"Unable to process texture: {}", ddsPath.wstring());
-            return TaskTracker::Result::FAILURE;
-        }
+    vector<unique_ptr<PatcherTextureHook>> hooks;
+    if (PatcherTextureHookConvertToCM::isInProcessList(job.ddsPath)) {
+        hooks.emplace_back(make_unique<PatcherTextureHookConvertToCM>(job.ddsPath, &job.ddsImage));
     }
-    if (PatcherTextureHookFixSSS::isInProcessList(ddsPath)) {
-        auto patcher = PatcherTextureHookFixSSS(ddsPath, &ddsImage);
-        if (!patcher.applyPatch()) {
-            Logger::error(L"Unable to process texture: {}", ddsPath.wstring());
-            return TaskTracker::Result::FAILURE;
-        }
+    if (PatcherTextureHookFixSSS::isInProcessList(job.ddsPath)) {
+        hooks.emplace_back(make_unique<PatcherTextureHookFixSSS>(job.ddsPath, &job.ddsImage));
     }
 
-    bool ddsModified = false;
+    for (auto& hook : hooks) {
+        TextureHookOutput output {.hook = std::move(hook), .image = {}};
+        if (!output.hook->applyShader(output.image)) {
+            Logger::error(L"Unable to process texture: {}", job.ddsPath.wstring());
+            job.result = TaskTracker::Result::FAILURE;
+            return false;
+        }
+
+        s_texturePixelBudget.forceAcquire(output.image.GetPixelsSize());
+        job.reservedBytes += output.image.GetPixelsSize();
+        job.hookOutputs.push_back(std::move(output));
+    }
 
-    const auto patcherObjects = createDDSPatcherObjects(ddsPath, &ddsImage);
+    const auto patcherObjects = createDDSPatcherObjects(job.ddsPath, &job.ddsImage);
 
     // global patchers
+    const size_t sizeBefore = job.ddsImage.GetPixelsSize();
     for (const auto& patcher : patcherObjects.globalPatchers) {
-        patcher->applyPatch(ddsModified);
+        patcher->applyPatch(job.ddsModified);
+    }
+
+    if (!job.ddsModified) {
+        // source image is not needed anymore
+        job.ddsImage.Release();
     }
+    s_texturePixelBudget.adjust(sizeBefore, job.ddsImage.GetPixelsSize());
+    job.reservedBytes = job.reservedBytes - sizeBefore + job.ddsImage.GetPixelsSize();
+
+    return !job.hookOutputs.empty() || job.ddsModified;
+}
 
-    if (ddsModified) {
+auto PGPatcher::encodeDDS(TextureJob& job) -> bool
+{
+    for (auto& output : job.hookOutputs) {
+        DirectX::ScratchImage compressedImage;
+        if (!PatcherTextureHook::compressOutput(output.image, output.hook->getOutputFormat(), compressedImage)) {
+            Logger::error(L"Unable to process texture: {}", job.ddsPath.wstring());
+            job.result = TaskTracker::Result::FAILURE;
+            return false;
+        }
+
+        s_texturePixelBudget.adjust(output.image.GetPixelsSize(), compressedImage.GetPixelsSize());
+        job.reservedBytes = job.reservedBytes - output.image.GetPixelsSize() + compressedImage.GetPixelsSize();
+        output.image = std::move(compressedImage);
+    }
+
+    return true;
+}
+
+auto PGPatcher::writeDDS(TextureJob& job) -> bool
+{
+    auto* const pgd = PGGlobals::getPGD();
+
+    for (auto& output : job.hookOutputs) {
+        if (!PatcherTextureHook::saveOutput(output.image, output.hook->getOutputPath())) {
+            Logger::error(L"Unable to process texture: {}", job.ddsPath.wstring());
+            job.result = TaskTracker::Result::FAILURE;
+            return false;
+        }
+
+        output.hook->registerOutput();
+    }
+
+    if (job.ddsModified) {
         // save to output
-        const filesystem::path outputFile = pgd->getGeneratedPath() / ddsPath;
+        const filesystem::path outputFile = pgd->getGeneratedPath() / job.ddsPath;
         filesystem::create_directories(outputFile.parent_path());
 
-        const HRESULT hr = DirectX::SaveToDDSFile(ddsImage.GetImages(),
-                                                  ddsImage.GetImageCount(),
-                                                  ddsImage.GetMetadata(),
+        const HRESULT hr = DirectX::SaveToDDSFile(job.ddsImage.GetImages(),
+                                                  job.ddsImage.GetImageCount(),
+                                                  job.ddsImage.GetMetadata(),
                                                   DirectX::DDS_FLAGS_NONE,
                                                   outputFile.c_str());
         if (FAILED(hr)) {
             Logger::error(L"Unable to save texture {}: {}", outputFile.wstring(), PGD3D::getHRESULTErrorMessage(hr));
-            return TaskTracker::Result::FAILURE;
+            job.result = TaskTracker::Result::FAILURE;
+            return false;
         }
 
         // Update file map with generated file
-        pgd->addGeneratedFile(ddsPath);
+        pgd->addGeneratedFile(job.ddsPath);
     }
 
-    return result;
+    return true;
 }
 
 auto PGPatcher::createDDSPatcherObjects(const std::filesystem::path& ddsPath,
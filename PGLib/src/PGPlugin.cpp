@@ -9,7 +9,10 @@
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <chrono>
+#include <cstddef>
 #include <filesystem>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -123,6 +126,12 @@ void PGPlugin::resetPatchingState()
         return;
     }
 
+    {
+        // uses collected for the previous state are dropped with it
+        const lock_guard lock(s_modelUseBatchMutex);
+        s_modelUseBatch.clear();
+    }
+
     PGMutagenWrapper::libResetPatchingState();
 }
 
@@ -157,11 +166,8 @@ auto PGPlugin::getModelUses(const std::wstring& modelPath) -> std::vector<std::p
     });
 
     for (const auto& modelUse : modelUses) {
-        const PGMeshPermutationTracker::FormKey formKey {
-            .modKey = modelUse.modName,
-            .formID = modelUse.formID,
-            .subMODL = modelUse.subModel,
-        };
+        const auto formKey
+            = PGMeshPermutationTracker::FormKey::make(modelUse.modName, modelUse.formID, modelUse.subModel);
         MeshUseAttributes attributes;
         attributes.isWeighted = modelUse.isWeighted;
         attributes.singlepassMATO = modelUse.singlepassMATO;
@@ -169,22 +175,16 @@ auto PGPlugin::getModelUses(const std::wstring& modelPath) -> std::vector<std::p
         attributes.isDummyUse = false;
         attributes.recType = getRecTypeFromString(modelUse.type);
 
+        attributes.alternateTextures.reserve(modelUse.alternateTextures.size());
         for (const auto& altTex : modelUse.alternateTextures) {
-            // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
-            attributes.alternateTextures[altTex.slotID] = PGTypes::TextureSet {
-                altTex.slots[0],
-                altTex.slots[1],
-                altTex.slots[2],
-                altTex.slots[3],
-                altTex.slots[4],
-                altTex.slots[5],
-                altTex.slots[6],
-                altTex.slots[7],
-            };
-            // NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+            PGTypes::TextureSetIDs textureIDs {};
+            for (size_t slot = 0; slot < altTex.slots.size() && slot < NUM_TEXTURE_SLOTS; ++slot) {
+                textureIDs.at(slot) = PGTypes::internTexturePath(altTex.slots.at(slot));
+            }
+            attributes.alternateTextures.emplace_back(static_cast<unsigned int>(altTex.slotID), textureIDs);
         }
 
-        result.emplace_back(formKey, attributes);
+        result.emplace_back(formKey, std::move(attributes));
     }
 
     return result;
@@ -196,22 +196,20 @@ void PGPlugin::setModelUses(const std::vector<PGMeshPermutationTracker::MeshResu
         return;
     }
 
-    vector<PGMutagenWrapper::ModelUse> modelUses;
+    const lock_guard lock(s_modelUseBatchMutex);
 
     for (const auto& meshResult : meshResults) {
+        const auto meshFile = meshResult.meshPath.wstring();
+
         for (const auto& [formKey, altTexMap] : meshResult.altTexResults) {
-            if (formKey.modKey.empty() || formKey.formID == 0) {
+            if (formKey.pluginID == 0 || formKey.formID == 0) {
                 // skip dummy use
                 continue;
             }
 
-            PGMutagenWrapper::ModelUse modelUse;
-            modelUse.modName = formKey.modKey;
-            modelUse.formID = formKey.formID;
-            modelUse.subModel = formKey.subMODL;
-            modelUse.meshFile = meshResult.meshPath.wstring();
+            s_modelUseBatch.addModelUse(formKey.getModKey(), formKey.formID, formKey.getSubMODL(), meshFile);
 
-            const auto idxCorr = meshResult.idxCorrections;
+            const auto& idxCorr = meshResult.idxCorrections;
 
             for (const auto& [slotID, textureSet] : altTexMap) {
                 PGMutagenWrapper::AlternateTexture altTex;
@@ -233,19 +231,49 @@ void PGPlugin::setModelUses(const std::vector<PGMeshPermutationTracker::MeshResu
                 altTex.slots[7] = textureSet[7];
                 // NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
 
-                modelUse.alternateTextures.push_back(altTex);
+                s_modelUseBatch.addAlternateTexture(altTex);
             }
-
-            modelUses.push_back(modelUse);
         }
     }
 
-    PGMutagenWrapper::libSetModelUses(modelUses);
+    if (s_modelUseFlushBytes != 0 && s_modelUseBatch.getBytes() >= s_modelUseFlushBytes) {
+        flushModelUsesLocked();
+    }
+}
+
+void PGPlugin::flushModelUses()
+{
+    const lock_guard lock(s_modelUseBatchMutex);
+    flushModelUsesLocked();
+}
+
+void PGPlugin::setModelUseFlushBytes(const size_t& bytes)
+{
+    const lock_guard lock(s_modelUseBatchMutex);
+    s_modelUseFlushBytes = bytes;
+}
+
+void PGPlugin::flushModelUsesLocked()
+{
+    if (s_modelUseBatch.empty()) {
+        return;
+    }
+
+    const auto startTime = chrono::steady_clock::now();
+    PGMutagenWrapper::libSetModelUsesBatch(s_modelUseBatch);
+    const auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - startTime);
+
+    spdlog::debug("Submitted {} model uses ({} KiB) to the plugin in {} ms",
+                  s_modelUseBatch.size(),
+                  s_modelUseBatch.getBytes() >> 10U,
+                  elapsed.count());
+    s_modelUseBatch.clear();
 }
 
 void PGPlugin::savePlugin(const filesystem::path& outputDir,
                           bool esmify)
 {
+    flushModelUses();
     PGMutagenWrapper::libFinalize(outputDir, esmify);
     // TODO add to generated files
 }
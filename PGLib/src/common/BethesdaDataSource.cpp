@@ -0,0 +1,225 @@
+#include "common/BethesdaDataSource.hpp"
+
+#include "common/BethesdaDirectory.hpp"
+#include "util/FileUtil.hpp"
+#include "util/StringUtil.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+//
+// BethesdaFolderSource
+//
+
+BethesdaFolderSource::BethesdaFolderSource(filesystem::path rootDir)
+    : m_rootDir(std::move(rootDir))
+{
+}
+
+void BethesdaFolderSource::listRootFiles(const FileCallback& callback) const
+{
+    // mod folders of an overlay can be missing or replaced by a file, skip the layer like listFiles does
+    if (!filesystem::is_directory(m_rootDir)) {
+        return;
+    }
+
+    // Map top level folder (not recursive)
+    for (auto it = filesystem::directory_iterator(m_rootDir, filesystem::directory_options::skip_permission_denied);
+         it != filesystem::directory_iterator();
+         ++it) {
+        const auto& entry = *it;
+
+        if (BethesdaDirectory::isHidden(entry.path()) || entry.is_directory()) {
+            continue;
+        }
+
+        callback(entry.path().lexically_relative(m_rootDir), 0);
+    }
+}
+
+void BethesdaFolderSource::listFiles(const unordered_set<filesystem::path>& folders,
+                                     const FileCallback& callback) const
+{
+    // loop through each folder to map
+    for (const auto& folder : folders) {
+        // check if folder exists
+        const auto curCheckFolder = m_rootDir / folder;
+        if (!filesystem::exists(curCheckFolder)) {
+            continue;
+        }
+
+        for (auto it = filesystem::recursive_directory_iterator(curCheckFolder,
+                                                                filesystem::directory_options::skip_permission_denied);
+             it != filesystem::recursive_directory_iterator();
+             ++it) {
+            const auto entry = *it;
+
+            if (BethesdaDirectory::isHidden(entry.path())) {
+                if (entry.is_directory()) {
+                    // If it's a directory, don't recurse into it
+                    it.disable_recursion_pending();
+                }
+                continue;
+            }
+
+            callback(entry.path().lexically_relative(m_rootDir), 0);
+        }
+    }
+}
+
+auto BethesdaFolderSource::findFile(const filesystem::path& relPath) const -> optional<uint32_t>
+{
+    if (!filesystem::is_regular_file(m_rootDir / relPath)) {
+        return nullopt;
+    }
+
+    return 0;
+}
+
+auto BethesdaFolderSource::readFile(const filesystem::path& relPath,
+                                    [[maybe_unused]] uint32_t layer) const -> vector<std::byte>
+{
+    return FileUtil::getFileBytes(m_rootDir / relPath);
+}
+
+auto BethesdaFolderSource::getFullPath(const filesystem::path& relPath,
+                                       [[maybe_unused]] uint32_t layer) const -> filesystem::path
+{
+    return m_rootDir / relPath;
+}
+
+auto BethesdaFolderSource::getDescription() const -> wstring { return m_rootDir.wstring(); }
+
+auto BethesdaFolderSource::getRootDir() const -> const filesystem::path& { return m_rootDir; }
+
+//
+// BethesdaOverlaySource
+//
+
+BethesdaOverlaySource::BethesdaOverlaySource(const vector<filesystem::path>& layerDirs)
+{
+    m_layers.reserve(layerDirs.size());
+    for (const auto& layerDir : layerDirs) {
+        m_layers.emplace_back(layerDir);
+    }
+}
+
+void BethesdaOverlaySource::listRootFiles(const FileCallback& callback) const
+{
+    for (uint32_t layer = 0; layer < m_layers.size(); layer++) {
+        m_layers[layer].listRootFiles([&callback, layer](const filesystem::path& relPath,
+                                                         uint32_t) -> void { callback(relPath, layer); });
+    }
+}
+
+void BethesdaOverlaySource::listFiles(const unordered_set<filesystem::path>& folders,
+                                      const FileCallback& callback) const
+{
+    for (uint32_t layer = 0; layer < m_layers.size(); layer++) {
+        m_layers[layer].listFiles(folders,
+                                  [&callback, layer](const filesystem::path& relPath,
+                                                     uint32_t) -> void { callback(relPath, layer); });
+    }
+}
+
+auto BethesdaOverlaySource::findFile(const filesystem::path& relPath) const -> optional<uint32_t>
+{
+    // highest priority layer wins
+    for (auto layer = static_cast<uint32_t>(m_layers.size()); layer > 0; layer--) {
+        if (m_layers[layer - 1].findFile(relPath).has_value()) {
+            return layer - 1;
+        }
+    }
+
+    return nullopt;
+}
+
+auto BethesdaOverlaySource::readFile(const filesystem::path& relPath,
+                                     uint32_t layer) const -> vector<std::byte>
+{
+    return m_layers.at(layer).readFile(relPath, 0);
+}
+
+auto BethesdaOverlaySource::getFullPath(const filesystem::path& relPath,
+                                        uint32_t layer) const -> filesystem::path
+{
+    return m_layers.at(layer).getFullPath(relPath, 0);
+}
+
+auto BethesdaOverlaySource::getDescription() const -> wstring
+{
+    if (m_layers.empty()) {
+        return L"empty overlay";
+    }
+
+    return L"overlay of " + to_wstring(m_layers.size() - 1) + L" folders on top of "
+        + m_layers.front().getDescription();
+}
+
+//
+// BethesdaMemorySource
+//
+
+void BethesdaMemorySource::addFile(const filesystem::path& relPath,
+                                   vector<std::byte> bytes)
+{
+    m_files[StringUtil::toLowerASCII(relPath.wstring())] = {.relPath = relPath, .bytes = std::move(bytes)};
+}
+
+void BethesdaMemorySource::listRootFiles(const FileCallback& callback) const
+{
+    for (const auto& [lowerPath, file] : m_files) {
+        if (!lowerPath.has_parent_path()) {
+            callback(file.relPath, 0);
+        }
+    }
+}
+
+void BethesdaMemorySource::listFiles(const unordered_set<filesystem::path>& folders,
+                                     const FileCallback& callback) const
+{
+    for (const auto& [lowerPath, file] : m_files) {
+        if (lowerPath.has_parent_path() && folders.contains(*lowerPath.begin())) {
+            callback(file.relPath, 0);
+        }
+    }
+}
+
+auto BethesdaMemorySource::findFile(const filesystem::path& relPath) const -> optional<uint32_t>
+{
+    if (!m_files.contains(StringUtil::toLowerASCII(relPath.wstring()))) {
+        return nullopt;
+    }
+
+    return 0;
+}
+
+auto BethesdaMemorySource::readFile(const filesystem::path& relPath,
+                                    [[maybe_unused]] uint32_t layer) const -> vector<std::byte>
+{
+    const auto it = m_files.find(StringUtil::toLowerASCII(relPath.wstring()));
+    if (it == m_files.end()) {
+        return {};
+    }
+
+    return it->second.bytes;
+}
+
+auto BethesdaMemorySource::getFullPath([[maybe_unused]] const filesystem::path& relPath,
+                                       [[maybe_unused]] uint32_t layer) const -> filesystem::path
+{
+    return {};
+}
+
+auto BethesdaMemorySource::getDescription() const -> wstring
+{
+    return to_wstring(m_files.size()) + L" files in memory";
+}
@@ -1,5 +1,6 @@
 #include "common/BethesdaDirectory.hpp"
 
+#include "common/BethesdaDataSource.hpp"
 #include "common/BethesdaGame.hpp"
 #include "util/ContainerUtil.hpp"
 #include "util/FileUtil.hpp"
@@ -14,13 +15,13 @@
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/trim.hpp>
-#include <boost/crc.hpp>
 #include <bsa/tes4.hpp>
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
 #include <cctype>
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <exception>
@@ -32,7 +33,6 @@
 #include <minwindef.h>
 #include <mutex>
 #include <shared_mutex>
-#include <shlwapi.h>
 #include <stdexcept>
 #include <string>
 #include <unordered_set>
@@ -52,6 +52,7 @@ BethesdaDirectory::BethesdaDirectory(BethesdaGame* bg,
 {
     // Assign instance vars
     m_dataDir = filesystem::path(this->m_bg->getGameDataPath());
+    m_dataSource = make_unique<BethesdaFolderSource>(m_dataDir);
 
     // Log starting message
     Logger::info(L"Opening Data Folder \"{}\"", m_dataDir.wstring());
@@ -62,6 +63,7 @@ BethesdaDirectory::BethesdaDirectory(filesystem::path dataPath,
                                      filesystem::path generatedPath)
     : m_dataDir(std::move(dataPath))
     , m_generatedDir(std::move(generatedPath))
+    , m_dataSource(make_unique<BethesdaFolderSource>(m_dataDir))
     , m_foldersToMap(std::move(foldersToMap))
     , m_bg(nullptr)
 {
@@ -93,17 +95,20 @@ auto BethesdaDirectory::getExtensionBlocklist() -> vector<wstring>
     return extensionBlocklist;
 }
 
-auto BethesdaDirectory::checkGlob(const wstring& str,
-                                  const vector<wstring>& globList) -> bool
+void BethesdaDirectory::setDataSource(unique_ptr<BethesdaDataSource> dataSource)
 {
-    // convert wstring vector to LPCWSTR vector
-    vector<LPCWSTR> globListCstr = convertWStringToLPCWSTRVector(globList);
+    if (dataSource == nullptr) {
+        throw runtime_error("Data source cannot be null");
+    }
+
+    const unique_lock lock(m_fileMapMutex);
 
-    // convert wstring to LPCWSTR
-    LPCWSTR strCstr = str.c_str();
+    // layers of the old source mean nothing to the new one
+    m_fileMap.clear();
+    m_generatedFileRestoreMap.clear();
+    m_dataSource = std::move(dataSource);
 
-    // check if string matches any glob
-    return std::ranges::any_of(globListCstr, [&](LPCWSTR glob) { return PathMatchSpecW(strCstr, glob); });
+    Logger::info(L"Reading data from {}", m_dataSource->getDescription());
 }
 
 void BethesdaDirectory::populateFileMap(bool includeBSAs)
@@ -141,14 +146,11 @@ auto BethesdaDirectory::getFile(const filesystem::path& relPath) -> vector<std::
     vector<std::byte> outFileBytes;
     const shared_ptr<BSAFile> bsaStruct = file.bsaFile;
     if (bsaStruct == nullptr) {
-        filesystem::path filePath;
         if (file.generated) {
-            filePath = m_generatedDir / relPath;
+            outFileBytes = FileUtil::getFileBytes(m_generatedDir / relPath);
         } else {
-            filePath = m_dataDir / relPath;
+            outFileBytes = m_dataSource->readFile(relPath, file.layer);
         }
-
-        outFileBytes = FileUtil::getFileBytes(filePath);
     } else {
         const filesystem::path bsaPath = bsaStruct->path;
 
@@ -269,7 +271,7 @@ auto BethesdaDirectory::getLooseFileFullPath(const filesystem::path& relPath) ->
         return m_generatedDir / relPath;
     }
 
-    return m_dataDir / relPath;
+    return m_dataSource->getFullPath(relPath, file.layer);
 }
 
 auto BethesdaDirectory::getDataPath() const -> filesystem::path { return m_dataDir; }
@@ -298,62 +300,19 @@ void BethesdaDirectory::addLooseFilesToMap()
 {
     Logger::info("Adding loose files to file map.");
 
-    // Map top level folder (not recursive)
-    for (auto it = filesystem::directory_iterator(m_dataDir, filesystem::directory_options::skip_permission_denied);
-         it != filesystem::directory_iterator();
-         ++it) {
-        const auto& entry = *it;
-
-        if (isHidden(entry.path()) || entry.is_directory()) {
-            continue;
-        }
-
-        const filesystem::path& filePath = entry.path();
-        filesystem::path relativePath = filePath.lexically_relative(m_dataDir);
-        relativePath = boost::to_lower_copy(relativePath.wstring());
-
+    const auto addLooseFile = [this](const filesystem::path& relPath,
+                                     uint32_t layer) -> void {
         // check type of file, skip BSAs and ESPs
-        if (!isFileAllowed(filePath)) {
-            continue;
-        }
-
-        updateFileMap(relativePath, nullptr);
-    }
-
-    // loop through each folder to map
-    for (const auto& folder : m_foldersToMap) {
-        // check if folder exists
-        const auto curCheckFolder = m_dataDir / folder;
-        if (!filesystem::exists(curCheckFolder)) {
-            continue;
+        if (!isFileAllowed(relPath)) {
+            return;
         }
 
-        for (auto it = filesystem::recursive_directory_iterator(curCheckFolder,
-                                                                filesystem::directory_options::skip_permission_denied);
-             it != filesystem::recursive_directory_iterator();
-             ++it) {
-            const auto entry = *it;
-
-            if (isHidden(entry.path())) {
-                if (entry.is_directory()) {
-                    // If it's a directory, don't recurse into it
-                    it.disable_recursion_pending();
-                }
-                continue;
-            }
-
-            const filesystem::path& filePath = entry.path();
-            filesystem::path relativePath = filePath.lexically_relative(m_dataDir);
-            relativePath = boost::to_lower_copy(relativePath.wstring());
-
-            // check type of file, skip BSAs and ESPs
-            if (!isFileAllowed(filePath)) {
-                continue;
-            }
+        updateFileMap(boost::to_lower_copy(relPath.wstring()), nullptr, false, layer);
+    };
 
-            updateFileMap(relativePath, nullptr);
-        }
-    }
+    // top level files first, then each folder to map
+    m_dataSource->listRootFiles(addLooseFile);
+    m_dataSource->listFiles(m_foldersToMap, addLooseFile);
 }
 
 void BethesdaDirectory::addBSAToFileMap(const wstring& bsaName)
@@ -362,12 +321,19 @@ void BethesdaDirectory::addBSAToFileMap(const wstring& bsaName)
     Logger::debug(L"Adding files from {} to file map.", bsaName);
 
     bsa::tes4::archive bsaObj;
-    const filesystem::path bsaPath = m_dataDir / bsaName;
 
     // skip BSA if it doesn't exist (can happen if it's in the ini but not in the
     // data folder)
-    if (!filesystem::exists(bsaPath)) {
-        Logger::warn(L"BSA is in INI but does not exist: {}", bsaPath.wstring());
+    const auto bsaLayer = m_dataSource->findFile(bsaName);
+    if (!bsaLayer.has_value()) {
+        Logger::warn(L"BSA is in INI but does not exist: {}", (m_dataDir / bsaName).wstring());
+        return;
+    }
+
+    // archives are opened from disk
+    const filesystem::path bsaPath = m_dataSource->getFullPath(bsaName, bsaLayer.value());
+    if (bsaPath.empty()) {
+        Logger::warn(L"BSA {} cannot be opened from {}", bsaName, m_dataSource->getDescription());
         return;
     }
 
@@ -480,12 +446,17 @@ auto BethesdaDirectory::getBSAFilesFromINIs() const -> vector<wstring>
     vector<filesystem::path> iniFileOrder = {iniLocs.ini, iniLocs.iniCustom};
 
     // Find INIs in data folder
-    for (const auto& entry :
-         filesystem::directory_iterator(m_dataDir, filesystem::directory_options::skip_permission_denied)) {
-        if (entry.is_regular_file() && toLowerASCII(entry.path().extension().wstring()) == L".ini") {
-            iniFileOrder.push_back(entry.path());
+    m_dataSource->listRootFiles([this, &iniFileOrder](const filesystem::path& relPath,
+                                                      uint32_t layer) -> void {
+        if (toLowerASCII(relPath.extension().wstring()) != L".ini") {
+            return;
         }
-    }
+
+        auto iniPath = m_dataSource->getFullPath(relPath, layer);
+        if (!iniPath.empty()) {
+            iniFileOrder.push_back(std::move(iniPath));
+        }
+    });
 
     // loop through each field
     for (const auto& field : getINIBSAFields()) {
@@ -522,19 +493,23 @@ auto BethesdaDirectory::getBSAFilesFromINIs() const -> vector<wstring>
 auto BethesdaDirectory::getBSAFilesInDirectory() const -> vector<wstring>
 {
     vector<wstring> bsaFiles;
+    unordered_set<wstring> foundBSAs;
+
+    m_dataSource->listRootFiles([&bsaFiles, &foundBSAs](const filesystem::path& relPath,
+                                                        uint32_t) -> void {
+        const auto fileExtension = relPath.extension().wstring();
+        // only interested in BSA files
+        if (!boost::iequals(fileExtension, ".bsa")) {
+            return;
+        }
 
-    for (const auto& entry : filesystem::directory_iterator(this->m_dataDir)) {
-        if (entry.is_regular_file()) {
-            const auto fileExtension = entry.path().extension().wstring();
-            // only interested in BSA files
-            if (!boost::iequals(fileExtension, ".bsa")) {
-                continue;
-            }
-
+        // the same archive can be in several layers, the overriding copy is opened later
+        auto bsaName = relPath.filename().wstring();
+        if (foundBSAs.insert(boost::to_lower_copy(bsaName)).second) {
             // add to output
-            bsaFiles.push_back(entry.path().filename().wstring());
+            bsaFiles.push_back(std::move(bsaName));
         }
-    }
+    });
 
     return bsaFiles;
 }
@@ -605,13 +580,15 @@ auto BethesdaDirectory::getFileFromMap(const filesystem::path& filePath) -> Beth
 
 void BethesdaDirectory::updateFileMap(const filesystem::path& filePath,
                                       shared_ptr<BethesdaDirectory::BSAFile> bsaFile,
-                                      const bool& generated)
+                                      const bool& generated,
+                                      const uint32_t& layer)
 {
     // const filesystem::path lowerPath = getAsciiPathLower(filePath);
 
     const unique_lock lock(m_fileMapMutex);
 
-    const BethesdaFile newBFile = {.path = filePath, .bsaFile = std::move(bsaFile), .generated = generated};
+    const BethesdaFile newBFile
+        = {.path = filePath, .bsaFile = std::move(bsaFile), .generated = generated, .layer = layer};
 
     m_fileMap[filePath] = newBFile;
 }
@@ -642,25 +619,6 @@ auto BethesdaDirectory::convertWStringToLPCWSTRVector(const vector<wstring>& ori
     return output;
 }
 
-auto BethesdaDirectory::checkGlob(const LPCWSTR& str,
-                                  LPCWSTR& winningGlob,
-                                  const vector<LPCWSTR>& globList) -> bool
-{
-    if (!boost::equals(winningGlob, L"") && (PathMatchSpecW(str, winningGlob) != 0)) {
-        // no winning glob, check all globs
-        return true;
-    }
-
-    for (const auto& glob : globList) {
-        if (glob != winningGlob && (PathMatchSpecW(str, glob) != 0)) {
-            winningGlob = glob;
-            return true;
-        }
-    }
-
-    return false;
-}
-
 auto BethesdaDirectory::isHidden(const filesystem::path& path) -> bool
 {
     // check if file is hidden in filesystem
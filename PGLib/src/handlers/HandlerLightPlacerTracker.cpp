@@ -4,14 +4,19 @@
 #include "PGPlugin.hpp"
 #include "util/FileUtil.hpp"
 #include "util/StringUtil.hpp"
+#include "util/TaskPoolRunner.hpp"
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <nlohmann/json_fwd.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -20,55 +25,145 @@ using namespace std;
 
 // statics
 vector<unique_ptr<HandlerLightPlacerTracker::LPJSON>> HandlerLightPlacerTracker::s_lightPlacerJSONs;
-unordered_map<filesystem::path, vector<pair<HandlerLightPlacerTracker::LPJSON*, nlohmann::json*>>>
-    HandlerLightPlacerTracker::s_lightPlacerJSONMap;
+unordered_map<wstring,
+              vector<HandlerLightPlacerTracker::LPModels*>,
+              HandlerLightPlacerTracker::ModelKeyHash,
+              HandlerLightPlacerTracker::ModelKeyEqual>
+    HandlerLightPlacerTracker::s_modelIndex;
+
+namespace {
+constexpr auto foldModelPathChar(wchar_t c) -> wchar_t
+{
+    if (c == L'/') {
+        return L'\\';
+    }
+    if (c >= L'A' && c <= L'Z') {
+        return static_cast<wchar_t>(c - L'A' + L'a');
+    }
+    return c;
+}
+}
 
-void HandlerLightPlacerTracker::init(const vector<filesystem::path>& lpJSONs)
+auto HandlerLightPlacerTracker::ModelKeyHash::operator()(wstring_view key) const noexcept -> size_t
 {
-    static auto* const pgd = PGGlobals::getPGD();
+    // FNV-1a over the folded characters
+    static constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+    static constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+    uint64_t hash = FNV_OFFSET;
+    for (const wchar_t c : key) {
+        hash ^= static_cast<uint64_t>(foldModelPathChar(c));
+        hash *= FNV_PRIME;
+    }
 
-    // Clear stale model->JSON pointer mappings from prior runs.
-    s_lightPlacerJSONMap.clear();
+    return static_cast<size_t>(hash);
+}
 
-    // Clear and reserve space for new LPJSONs
-    s_lightPlacerJSONs.clear();
-    s_lightPlacerJSONs.reserve(lpJSONs.size());
-
-    for (const auto& jsonPath : lpJSONs) {
-        // Load JSON data
-        nlohmann::json jsonData;
-        if (!FileUtil::getJSON(pgd->getLooseFileFullPath(jsonPath), jsonData)) {
-            // unable to load
-            continue;
+auto HandlerLightPlacerTracker::ModelKeyEqual::operator()(wstring_view lhs,
+                                                          wstring_view rhs) const noexcept -> bool
+{
+    return ranges::equal(
+        lhs, rhs, [](wchar_t a, wchar_t b) -> bool { return foldModelPathChar(a) == foldModelPathChar(b); });
+}
+
+auto HandlerLightPlacerTracker::getModelKey(wstring_view path) -> wstring_view
+{
+    static constexpr wstring_view MESHES_PREFIX = L"meshes";
+
+    while (!path.empty() && foldModelPathChar(path.front()) == L'\\') {
+        path.remove_prefix(1);
+    }
+
+    if (path.size() > MESHES_PREFIX.size() && foldModelPathChar(path[MESHES_PREFIX.size()]) == L'\\'
+        && ModelKeyEqual {}(path.substr(0, MESHES_PREFIX.size()), MESHES_PREFIX)) {
+        path.remove_prefix(MESHES_PREFIX.size() + 1);
+    }
+
+    return path;
+}
+
+void HandlerLightPlacerTracker::collectModelArrays(LPJSON& lpJSON)
+{
+    for (const auto& block : lpJSON.jsonData.items()) {
+        if (!block.value().is_object() || !block.value().contains("models")) {
+            continue; // skip if not a valid light placer block
         }
 
-        // Add to s_lightPlacerJSONMutexMap
-        s_lightPlacerJSONs.emplace_back(make_unique<LPJSON>(jsonPath, std::move(jsonData)));
-        auto* const lpJsonPtr = s_lightPlacerJSONs.back().get();
+        auto& models = block.value()["models"];
+        if (!models.is_array()) {
+            continue; // skip if models is not an array
+        }
 
-        // loop through json to create nif map
-        for (const auto& block : lpJsonPtr->jsonData.items()) {
-            if (!block.value().is_object() || !block.value().contains("models")) {
-                continue; // skip if not a valid light placer block
+        LPModels lpModels {.owner = &lpJSON, .models = &models, .entries = {}};
+        for (const auto& model : models) {
+            if (model.is_string()) {
+                lpModels.entries.insert(model.get<string>());
             }
+        }
 
-            auto& models = block.value()["models"];
-            if (!models.is_array()) {
-                continue; // skip if models is not an array
-            }
+        lpJSON.modelArrays.push_back(std::move(lpModels));
+    }
+}
 
-            for (const auto& model : models) {
-                if (!model.is_string()) {
-                    continue; // skip if model is not a string
+void HandlerLightPlacerTracker::rebuildIndex()
+{
+    s_modelIndex.clear();
+
+    for (const auto& lpJSON : s_lightPlacerJSONs) {
+        for (auto& lpModels : lpJSON->modelArrays) {
+            for (const auto& model : lpModels.entries) {
+                const auto modelW = StringUtil::utf8toUTF16(model);
+                auto& refs = s_modelIndex[wstring(getModelKey(modelW))];
+                if (refs.empty() || refs.back() != &lpModels) {
+                    refs.push_back(&lpModels);
                 }
-
-                const filesystem::path modelPath = model.get<string>();
-                s_lightPlacerJSONMap[modelPath].emplace_back(lpJsonPtr, &models);
             }
         }
     }
 }
 
+void HandlerLightPlacerTracker::init(const vector<filesystem::path>& lpJSONs,
+                                     const bool& multithreading)
+{
+    static auto* const pgd = PGGlobals::getPGD();
+
+    // Clear stale model->JSON pointer mappings from prior runs.
+    s_modelIndex.clear();
+
+    // Every task only writes its own slot
+    s_lightPlacerJSONs.clear();
+    s_lightPlacerJSONs.resize(lpJSONs.size());
+
+    TaskPoolRunner runner(multithreading);
+    for (size_t jsonIdx = 0; jsonIdx < lpJSONs.size(); jsonIdx++) {
+        runner.addTask([jsonIdx, &lpJSONs]() -> void {
+            // Load JSON data
+            nlohmann::json jsonData;
+            vector<std::byte> jsonBytes;
+            try {
+                jsonBytes = pgd->getFile(lpJSONs[jsonIdx]);
+            } catch (...) {
+                return;
+            }
+
+            if (!FileUtil::getJSONFromBytes(jsonBytes, jsonData)) {
+                // unable to load
+                return;
+            }
+
+            auto lpJSON = make_unique<LPJSON>(lpJSONs[jsonIdx], std::move(jsonData));
+            collectModelArrays(*lpJSON);
+            s_lightPlacerJSONs[jsonIdx] = std::move(lpJSON);
+        });
+    }
+    runner.runTasks();
+
+    // drop JSONs that failed to load
+    erase(s_lightPlacerJSONs, nullptr);
+
+    rebuildIndex();
+}
+
 void HandlerLightPlacerTracker::handleNIFCreated(const filesystem::path& baseNIFPath,
                                                  const filesystem::path& createdNIFPath)
 {
@@ -77,30 +172,26 @@ void HandlerLightPlacerTracker::handleNIFCreated(const filesystem::path& baseNIF
         return;
     }
 
-    // Remove "meshes" from from the first part of both paths
-    const auto baseNIFPathLP = PGPlugin::getPluginPathFromDataPath(baseNIFPath);
-    const auto createdNIFPathLP = PGPlugin::getPluginPathFromDataPath(createdNIFPath);
-
-    // check if s_lightPlacerJSONMap contains the baseNIFPath
-    auto it = s_lightPlacerJSONMap.find(baseNIFPathLP);
-    if (it == s_lightPlacerJSONMap.end()) {
+    // the index is not modified while patching and the key is a view into the path, so this neither locks nor
+    // allocates
+    const auto it = s_modelIndex.find(getModelKey(baseNIFPath.native()));
+    if (it == s_modelIndex.end()) {
         // No light placer JSONs for this nif
         return;
     }
 
-    // Get the vector of LPJSON pointers and models
-    auto& lpJSONs = it->second;
+    // Remove "meshes" from from the first part of the path
+    const auto createdNIFPathStr
+        = StringUtil::utf16toUTF8(PGPlugin::getPluginPathFromDataPath(createdNIFPath).wstring());
 
-    // Loop through each LPJSON and update the models
-    for (const auto& [lpJsonPtr, models] : lpJSONs) {
+    // Loop through each models array and add the created nif if not already present
+    for (auto* const lpModels : it->second) {
         // lock mutex for modifying json
-        const lock_guard<mutex> lock(lpJsonPtr->jsonMutex);
+        const lock_guard<mutex> lock(lpModels->owner->jsonMutex);
 
-        // Add to models if not already present (models is already a json array)
-        const auto createdNIFPathStr = StringUtil::utf16toUTF8(createdNIFPathLP.wstring());
-        if (!StringUtil::checkIfStringInJSONArray(*models, createdNIFPathStr)) {
-            models->push_back(createdNIFPathStr);
-            lpJsonPtr->changed = true; // mark as changed
+        if (lpModels->entries.insert(createdNIFPathStr).second) {
+            lpModels->models->push_back(createdNIFPathStr);
+            lpModels->owner->changed = true; // mark as changed
         }
     }
 }
@@ -125,6 +216,6 @@ void HandlerLightPlacerTracker::finalize()
     }
 
     // Clear the static members
+    s_modelIndex.clear();
     s_lightPlacerJSONs.clear();
-    s_lightPlacerJSONMap.clear();
 }
@@ -2,6 +2,7 @@
 
 #include "PGGlobals.hpp"
 #include "patchers/base/PatcherMeshGlobal.hpp"
+#include "pgutil/PGNIFScanner.hpp"
 
 #include "Animation.hpp"
 #include "BasicTypes.hpp"
@@ -12,7 +13,6 @@
 #include "Object3d.hpp"
 #include "Particles.hpp"
 #include "Shaders.hpp"
-#include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/replace.hpp>
 #include <nlohmann/json.hpp>
 #include <nlohmann/json_fwd.hpp>
@@ -23,7 +23,6 @@
 #include <fstream>
 #include <memory>
 #include <mutex>
-#include <set>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -52,24 +51,23 @@ auto PatcherMeshGlobalParticleLightsToLP::getFactory() -> PatcherMeshGlobal::Pat
 
 auto PatcherMeshGlobalParticleLightsToLP::applyPatch() -> bool
 {
-    // Loop through all blocks to find alpha properties
-    // Determine if NIF has attached havok animations
-    vector<NiObject*> nifBlockTree;
-    getNIF()->GetTree(nifBlockTree);
+    auto& blockIndex = getBlockIndex();
 
-    bool appliedPatch = false;
+    const auto& billboardNodes = blockIndex.getBlocksByName(nifly::NiBillboardNode::BlockName);
+    if (!needsPatch(!billboardNodes.empty())) {
+        return false;
+    }
 
-    for (NiObject* nifBlock : nifBlockTree) {
-        if (!boost::iequals(nifBlock->GetBlockName(), "NiBillboardNode")) {
-            continue;
-        }
+    // deleted after the loop, deleting shifts the block IDs and would rebuild the index for every patched node
+    vector<NiObject*> patchedNodes;
+
+    for (NiObject* nifBlock : billboardNodes) {
         auto* const billboardNode = dynamic_cast<nifly::NiBillboardNode*>(nifBlock);
 
         // Get children
-        set<NiRef*> childRefs;
-        billboardNode->GetChildRefs(childRefs);
+        const auto& children = blockIndex.getChildren(billboardNode);
 
-        if (childRefs.empty()) {
+        if (children.empty()) {
             // no children
             continue;
         }
@@ -81,13 +79,13 @@ auto PatcherMeshGlobalParticleLightsToLP::applyPatch() -> bool
         nifly::NiParticleSystem const* particleSystem = nullptr;
 
         // Loop through children and assign whatever is found
-        for (auto* childRef : childRefs) {
+        for (auto* const child : children) {
             if (shape == nullptr) {
-                shape = getNIF()->GetHeader().GetBlock<NiShape>(childRef);
+                shape = dynamic_cast<NiShape*>(child);
             }
 
             if (particleSystem == nullptr) {
-                particleSystem = getNIF()->GetHeader().GetBlock<NiParticleSystem>(childRef);
+                particleSystem = dynamic_cast<NiParticleSystem*>(child);
             }
         }
 
@@ -143,16 +141,35 @@ auto PatcherMeshGlobalParticleLightsToLP::applyPatch() -> bool
         // Apply patch to this particle light
         if (applySinglePatch(billboardNode, shape, effectShader)) {
             // Delete block if patch was applied
-            appliedPatch = true;
-            const auto nifBlockRef = nifly::NiRef(getNIF()->GetBlockID(nifBlock));
-            getNIF()->GetHeader().DeleteBlock(nifBlockRef);
+            patchedNodes.push_back(nifBlock);
         }
     }
 
+    if (patchedNodes.empty()) {
+        return false;
+    }
+
+    for (NiObject* patchedNode : patchedNodes) {
+        const auto nifBlockRef = nifly::NiRef(getNIF()->GetBlockID(patchedNode));
+        getNIF()->GetHeader().DeleteBlock(nifBlockRef);
+    }
+
     // delete unreferenced blocks (there are probably a lot)
     getNIF()->DeleteUnreferencedBlocks();
+    blockIndex.invalidate();
+
+    return true;
+}
 
-    return appliedPatch;
+auto PatcherMeshGlobalParticleLightsToLP::mayApply(const PGNIFScanner::MeshShapes& meshShapes) const -> bool
+{
+    return needsPatch(meshShapes.hasBillboardNodes);
+}
+
+auto PatcherMeshGlobalParticleLightsToLP::needsPatch(bool hasBillboardNodes) -> bool
+{
+    // particle lights are billboard nodes with an effect shader shape
+    return hasBillboardNodes;
 }
 
 auto PatcherMeshGlobalParticleLightsToLP::applySinglePatch(nifly::NiBillboardNode* node,
@@ -3,7 +3,7 @@
 #include "patchers/PatcherTextureHookFixSSS.hpp"
 #include "patchers/base/PatcherMeshPost.hpp"
 #include "pgutil/PGEnums.hpp"
-#include "pgutil/PGNIFUtil.hpp"
+#include "pgutil/PGNIFScanner.hpp"
 #include "pgutil/PGTypes.hpp"
 
 #include "Geometry.hpp"
@@ -42,14 +42,7 @@ auto PatcherMeshPostFixSSS::applyPatch(PGTypes::TextureSet& slots,
         return false;
     }
 
-    const auto shaderType = nifShaderBSLSP->GetShaderType();
-    if (shaderType != BSLSP_DEFAULT) {
-        // only patch the default shader type
-        return false;
-    }
-
-    if (!PGNIFUtil::hasShaderFlag(nifShaderBSLSP, SLSF2_SOFT_LIGHTING)) {
-        // we don't care if it doesn't have soft lighting
+    if (!needsPatch(nifShaderBSLSP->GetShaderType(), nifShaderBSLSP->shaderFlags2)) {
         return false;
     }
 
@@ -77,3 +70,15 @@ auto PatcherMeshPostFixSSS::applyPatch(PGTypes::TextureSet& slots,
 
     return true;
 }
+
+auto PatcherMeshPostFixSSS::mayApply(const PGNIFScanner::ShaderShape& shape) const -> bool
+{
+    return needsPatch(shape.shaderType, shape.shaderFlags2);
+}
+
+auto PatcherMeshPostFixSSS::needsPatch(uint32_t shaderType,
+                                       uint32_t shaderFlags2) -> bool
+{
+    // only patch the default shader type, and we don't care if it doesn't have soft lighting
+    return shaderType == BSLSP_DEFAULT && (shaderFlags2 & SLSF2_SOFT_LIGHTING) != 0U;
+}
@@ -3,6 +3,7 @@
 #include "PGGlobals.hpp"
 #include "patchers/base/PatcherMeshPost.hpp"
 #include "pgutil/PGEnums.hpp"
+#include "pgutil/PGNIFScanner.hpp"
 #include "pgutil/PGNIFUtil.hpp"
 #include "pgutil/PGTypes.hpp"
 
@@ -43,13 +44,7 @@ auto PatcherMeshPostHairFlowMap::applyPatch(PGTypes::TextureSet& slots,
         return false;
     }
 
-    if (nifShaderBSLSP->GetShaderType() != BSLightingShaderPropertyShaderType::BSLSP_HAIRTINT) {
-        // not a Hair specular shader
-        return false;
-    }
-
-    if (PGNIFUtil::hasShaderFlag(nifShaderBSLSP, SLSF2_BACK_LIGHTING)) {
-        // already has back lighting flag, don't touch it
+    if (!needsPatch(nifShaderBSLSP->GetShaderType(), nifShaderBSLSP->shaderFlags2)) {
         return false;
     }
 
@@ -79,3 +74,16 @@ auto PatcherMeshPostHairFlowMap::applyPatch(PGTypes::TextureSet& slots,
 
     return true;
 }
+
+auto PatcherMeshPostHairFlowMap::mayApply(const PGNIFScanner::ShaderShape& shape) const -> bool
+{
+    return needsPatch(shape.shaderType, shape.shaderFlags2);
+}
+
+auto PatcherMeshPostHairFlowMap::needsPatch(uint32_t shaderType,
+                                            uint32_t shaderFlags2) -> bool
+{
+    // only Hair specular shaders, and shapes that already have the back lighting flag are not touched
+    return shaderType == BSLightingShaderPropertyShaderType::BSLSP_HAIRTINT
+        && (shaderFlags2 & SLSF2_BACK_LIGHTING) == 0U;
+}
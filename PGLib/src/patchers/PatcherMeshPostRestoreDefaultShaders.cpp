@@ -4,6 +4,7 @@
 #include "patchers/PatcherMeshShaderComplexMaterial.hpp"
 #include "patchers/base/PatcherMeshPost.hpp"
 #include "pgutil/PGEnums.hpp"
+#include "pgutil/PGNIFScanner.hpp"
 #include "pgutil/PGNIFUtil.hpp"
 #include "pgutil/PGTypes.hpp"
 
@@ -44,6 +45,10 @@ auto PatcherMeshPostRestoreDefaultShaders::applyPatch(PGTypes::TextureSet& slots
         return false;
     }
 
+    if (!needsPatch(nifShaderBSLSP->GetShaderType())) {
+        return false;
+    }
+
     if (restoreDefaultShaderFromParallax(slots, *nifShaderBSLSP)) {
         return true;
     }
@@ -55,6 +60,16 @@ auto PatcherMeshPostRestoreDefaultShaders::applyPatch(PGTypes::TextureSet& slots
     return false;
 }
 
+auto PatcherMeshPostRestoreDefaultShaders::mayApply(const PGNIFScanner::ShaderShape& shape) const -> bool
+{
+    return needsPatch(shape.shaderType);
+}
+
+auto PatcherMeshPostRestoreDefaultShaders::needsPatch(uint32_t shaderType) -> bool
+{
+    return shaderType == BSLSP_PARALLAX || shaderType == BSLSP_ENVMAP;
+}
+
 auto PatcherMeshPostRestoreDefaultShaders::restoreDefaultShaderFromParallax(PGTypes::TextureSet& slots,
                                                                             nifly::BSLightingShaderProperty& shaderProp)
     -> bool
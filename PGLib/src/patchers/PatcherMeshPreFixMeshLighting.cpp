@@ -1,6 +1,7 @@
 #include "patchers/PatcherMeshPreFixMeshLighting.hpp"
 
 #include "patchers/base/PatcherMeshPre.hpp"
+#include "pgutil/PGNIFScanner.hpp"
 #include "pgutil/PGNIFUtil.hpp"
 #include "pgutil/PGTypes.hpp"
 
@@ -39,13 +40,7 @@ auto PatcherMeshPreFixMeshLighting::applyPatch([[maybe_unused]] PGTypes::Texture
         return false;
     }
 
-    const auto shaderType = nifShaderBSLSP->GetShaderType();
-    if (shaderType != BSLSP_DEFAULT) {
-        // only patch the default shader type
-        return false;
-    }
-
-    if (nifShaderBSLSP->softlighting <= SOFTLIGHTING_MAX) {
+    if (!needsPatch(nifShaderBSLSP->GetShaderType(), nifShaderBSLSP->softlighting)) {
         return false;
     }
 
@@ -53,3 +48,15 @@ auto PatcherMeshPreFixMeshLighting::applyPatch([[maybe_unused]] PGTypes::Texture
 
     return true;
 }
+
+auto PatcherMeshPreFixMeshLighting::mayApply(const PGNIFScanner::ShaderShape& shape) const -> bool
+{
+    return needsPatch(shape.shaderType, shape.softLighting);
+}
+
+auto PatcherMeshPreFixMeshLighting::needsPatch(uint32_t shaderType,
+                                               float softLighting) -> bool
+{
+    // only patch the default shader type
+    return shaderType == BSLSP_DEFAULT && softLighting > SOFTLIGHTING_MAX;
+}
@@ -1,11 +1,13 @@
 #include "patchers/PatcherMeshPreFixTextureSlotCount.hpp"
 
 #include "patchers/base/PatcherMeshPre.hpp"
+#include "pgutil/PGNIFScanner.hpp"
 #include "pgutil/PGTypes.hpp"
 
 #include "Geometry.hpp"
 #include "NifFile.hpp"
 
+#include <cstdint>
 #include <filesystem>
 #include <memory>
 #include <utility>
@@ -37,10 +39,21 @@ auto PatcherMeshPreFixTextureSlotCount::applyPatch([[maybe_unused]] PGTypes::Tex
         return false;
     }
 
-    if (txstRec->textures.size() >= SLOT_COUNT) {
+    if (!needsPatch(txstRec->textures.size())) {
         return false;
     }
 
     txstRec->textures.resize(SLOT_COUNT);
     return true;
 }
+
+auto PatcherMeshPreFixTextureSlotCount::mayApply(const PGNIFScanner::ShaderShape& shape) const -> bool
+{
+    // shapes without a texture set count as 0 textures, they are rare enough to not matter
+    return needsPatch(shape.numTextures);
+}
+
+auto PatcherMeshPreFixTextureSlotCount::needsPatch(size_t numTextures) -> bool
+{
+    return numTextures < static_cast<size_t>(SLOT_COUNT);
+}
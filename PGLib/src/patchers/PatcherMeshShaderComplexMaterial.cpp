@@ -9,6 +9,7 @@
 #include "pgutil/PGTypes.hpp"
 #include "util/FileUtil.hpp"
 #include "util/Logger.hpp"
+#include "util/MemoryGovernor.hpp"
 
 #include "Geometry.hpp"
 #include "NifFile.hpp"
@@ -19,6 +20,7 @@
 #include <nlohmann/json_fwd.hpp>
 
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <memory>
 #include <mutex>
@@ -34,6 +36,17 @@ using namespace std;
 std::shared_mutex PatcherMeshShaderComplexMaterial::s_metaCacheMutex;
 std::unordered_map<filesystem::path, nlohmann::json> PatcherMeshShaderComplexMaterial::s_metaCache;
 
+auto PatcherMeshShaderComplexMaterial::getMetaCacheMemory() -> MemoryGovernor::Subsystem*
+{
+    static auto* const subsystem
+        = MemoryGovernor::registerSubsystem("CM Material Meta Cache", [](size_t /*bytes*/) -> void {
+              const unique_lock lk(s_metaCacheMutex);
+              s_metaCache.clear();
+              MemoryGovernor::release(getMetaCacheMemory(), SIZE_MAX);
+          });
+    return subsystem;
+}
+
 auto PatcherMeshShaderComplexMaterial::getFactory() -> PatcherMeshShader::PatcherMeshShaderFactory
 {
     return [](const filesystem::path& nifPath, nifly::NifFile* nif) -> unique_ptr<PatcherMeshShader> {
@@ -313,8 +326,15 @@ auto PatcherMeshShaderComplexMaterial::getMaterialMeta(const filesystem::path& e
         return {};
     }
 
-    const std::scoped_lock lk(s_metaCacheMutex);
-    s_metaCache[envMaskPath] = meta;
+    {
+        const std::scoped_lock lk(s_metaCacheMutex);
+        if (s_metaCache.emplace(envMaskPath, meta).second) {
+            // raw JSON size as an estimate of the parsed size
+            MemoryGovernor::charge(getMetaCacheMemory(),
+                                   jsonBytes.size() + (envMaskPath.native().size() * sizeof(wchar_t)));
+        }
+    }
+    MemoryGovernor::reclaim(getMetaCacheMemory());
 
     return meta;
 }
@@ -88,3 +88,5 @@ void PatcherMeshShaderDefault::applyPatchSlots([[maybe_unused]] PGTypes::Texture
 }
 
 void PatcherMeshShaderDefault::applyShader([[maybe_unused]] nifly::NiShape& nifShape) { }
+
+auto PatcherMeshShaderDefault::modifiesShapes() const -> bool { return false; }
@@ -6,6 +6,7 @@
 #include "pgutil/PGEnums.hpp"
 #include "pgutil/PGNIFUtil.hpp"
 #include "pgutil/PGTypes.hpp"
+#include "util/GeometryKernels.hpp"
 #include "util/Logger.hpp"
 #include "util/StringUtil.hpp"
 
@@ -17,16 +18,12 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/algorithm/string/predicate.hpp>
-#include <boost/gil.hpp>
-#include <boost/gil/color_convert.hpp>
-#include <boost/gil/extension/toolbox/color_converters.hpp>
-#include <boost/gil/extension/toolbox/color_spaces/hsl.hpp>
-#include <boost/gil/typedefs.hpp>
 #include <mutex>
 #include <nlohmann/json_fwd.hpp>
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <filesystem>
 #include <iterator>
@@ -112,6 +109,7 @@ void PatcherMeshShaderTruePBR::loadStatics(const std::vector<std::filesystem::pa
 {
     auto* pgd = PGGlobals::getPGD();
 
+    s_hasNIFFilter = false;
     size_t configOrder = 0;
     for (const auto& config : pbrJSONs) {
         // check if Config is valid
@@ -154,6 +152,10 @@ void PatcherMeshShaderTruePBR::loadStatics(const std::vector<std::filesystem::pa
 
                 element["json"] = StringUtil::utf16toUTF8(config.wstring());
 
+                if (element.contains("nif_filter")) {
+                    s_hasNIFFilter = true;
+                }
+
                 // loop through filename Fields
                 for (const auto& field : getTruePBRConfigFilenameFields()) {
                     if (element.contains(field) && !boost::istarts_with(element[field].get<string>(), "\\")) {
@@ -400,6 +402,17 @@ auto PatcherMeshShaderTruePBR::shouldApply(const PGTypes::TextureSet& oldSlots,
     return !matches.empty();
 }
 
+auto PatcherMeshShaderTruePBR::getMatchContext() const -> wstring
+{
+    if (!s_hasNIFFilter) {
+        return {};
+    }
+
+    return getNIFPath().wstring();
+}
+
+auto PatcherMeshShaderTruePBR::canMemoizeMatches() const -> bool { return !s_printNonExistentPaths; }
+
 void PatcherMeshShaderTruePBR::getSlotMatch(map<size_t,
                                                 tuple<nlohmann::json,
                                                       wstring>>& truePBRData,
@@ -720,40 +733,35 @@ auto PatcherMeshShaderTruePBR::applyOnePatch(NiShape* nifShape,
         }
 
         if (vertData != nullptr) {
-            for (auto& vert : *vertData) {
-                // Convert to HSL and multiply luminance then convert back
-                boost::gil::rgb8_pixel_t vertRGB(vert.colorData[0], vert.colorData[1], vert.colorData[2]);
-                boost::gil::hsl32f_pixel_t vertHSL;
-                boost::gil::color_convert(vertRGB, vertHSL);
-
-                float newLVal = vertHSL[2];
-                if (truePBRData.contains("vertex_color_lum_mult")) {
-                    const auto newVertexColorMult = truePBRData["vertex_color_lum_mult"].get<float>();
-                    newLVal = 1 - ((1 - vertHSL[2]) * newVertexColorMult);
-                }
-
-                float newSVal = vertHSL[1];
-                if (truePBRData.contains("vertex_color_sat_mult")) {
-                    const auto newVertexColorMult = truePBRData["vertex_color_sat_mult"].get<float>();
-                    newSVal = vertHSL[1] * newVertexColorMult;
-                }
-
-                vertHSL[1] = clamp(newSVal, 0.0F, 1.0F);
-                vertHSL[2] = clamp(newLVal, 0.0F, 1.0F);
-                boost::gil::color_convert(vertHSL, vertRGB);
+            GeometryKernels::HSLAdjust adjust;
+            if (truePBRData.contains("vertex_color_lum_mult")) {
+                adjust.scaleLightness = true;
+                adjust.lightnessMult = truePBRData["vertex_color_lum_mult"].get<float>();
+            }
+            if (truePBRData.contains("vertex_color_sat_mult")) {
+                adjust.scaleSaturation = true;
+                adjust.saturationMult = truePBRData["vertex_color_sat_mult"].get<float>();
+            }
 
-                if (vert.colorData[0] != vertRGB[0]) {
-                    vert.colorData[0] = vertRGB[0];
-                    changed = true;
-                }
+            // Convert to HSL, multiply luminance and saturation, then convert back
+            const size_t numVerts = vertData->size();
+            vector<uint8_t> red(numVerts);
+            vector<uint8_t> green(numVerts);
+            vector<uint8_t> blue(numVerts);
+            for (size_t i = 0; i < numVerts; i++) {
+                red[i] = (*vertData)[i].colorData[0];
+                green[i] = (*vertData)[i].colorData[1];
+                blue[i] = (*vertData)[i].colorData[2];
+            }
 
-                if (vert.colorData[1] != vertRGB[1]) {
-                    vert.colorData[1] = vertRGB[1];
-                    changed = true;
-                }
+            GeometryKernels::adjustHSL(red.data(), green.data(), blue.data(), numVerts, adjust);
 
-                if (vert.colorData[2] != vertRGB[2]) {
-                    vert.colorData[2] = vertRGB[2];
+            for (size_t i = 0; i < numVerts; i++) {
+                auto& colorData = (*vertData)[i].colorData;
+                if (colorData[0] != red[i] || colorData[1] != green[i] || colorData[2] != blue[i]) {
+                    colorData[0] = red[i];
+                    colorData[1] = green[i];
+                    colorData[2] = blue[i];
                     changed = true;
                 }
             }
@@ -1145,26 +1153,44 @@ auto PatcherMeshShaderTruePBR::enableTruePBROnShape(NiShader* nifShader,
 // Helpers
 //
 
-auto PatcherMeshShaderTruePBR::abs2(Vector2 v) -> Vector2 { return {abs(v.u), abs(v.v)}; }
-
 // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
 auto PatcherMeshShaderTruePBR::autoUVScale(const vector<Vector2>* uvs,
                                            const vector<Vector3>* verts,
                                            vector<Triangle>& tris) -> Vector2
 {
-    Vector2 scale;
+    // Sums of per triangle UV density, in blocks for the vector kernel
+    GeometryKernels::TriangleEdgeBlock block;
+    GeometryKernels::UVDensitySums sums;
     for (const Triangle& t : tris) {
-        auto v1 = (*verts)[t.p1];
-        auto v2 = (*verts)[t.p2];
-        auto v3 = (*verts)[t.p3];
-        auto uv1 = (*uvs)[t.p1];
-        auto uv2 = (*uvs)[t.p2];
-        auto uv3 = (*uvs)[t.p3];
-
-        auto s = (abs2(uv2 - uv1) + abs2(uv3 - uv1)) / ((v2 - v1).length() + (v3 - v1).length());
-        scale += Vector2(1.0F / s.u, 1.0F / s.v);
+        const auto& v1 = (*verts)[t.p1];
+        const auto uvEdge1 = (*uvs)[t.p2] - (*uvs)[t.p1];
+        const auto uvEdge2 = (*uvs)[t.p3] - (*uvs)[t.p1];
+        const auto posEdge1 = (*verts)[t.p2] - v1;
+        const auto posEdge2 = (*verts)[t.p3] - v1;
+
+        const size_t i = block.size;
+        block.uv1U[i] = uvEdge1.u;
+        block.uv1V[i] = uvEdge1.v;
+        block.uv2U[i] = uvEdge2.u;
+        block.uv2V[i] = uvEdge2.v;
+        block.pos1X[i] = posEdge1.x;
+        block.pos1Y[i] = posEdge1.y;
+        block.pos1Z[i] = posEdge1.z;
+        block.pos2X[i] = posEdge2.x;
+        block.pos2Y[i] = posEdge2.y;
+        block.pos2Z[i] = posEdge2.z;
+
+        if (++block.size == GeometryKernels::TriangleEdgeBlock::CAPACITY) {
+            GeometryKernels::accumulateInverseUVDensity(block, sums);
+            block.size = 0;
+        }
+    }
+
+    if (block.size > 0) {
+        GeometryKernels::accumulateInverseUVDensity(block, sums);
     }
 
+    Vector2 scale(sums.totalU(), sums.totalV());
     scale *= 10.0 / 4.0;
     scale /= static_cast<float>(tris.size());
     scale.u = min(scale.u, scale.v);
@@ -11,8 +11,6 @@
 #include "Geometry.hpp"
 #include "NifFile.hpp"
 #include "Shaders.hpp"
-#include <boost/algorithm/string.hpp>
-#include <boost/algorithm/string/predicate.hpp>
 
 #include <cstddef>
 #include <filesystem>
@@ -40,16 +38,15 @@ PatcherMeshShaderVanillaParallax::PatcherMeshShaderVanillaParallax(filesystem::p
                         nif,
                         "VanillaParallax")
 {
-    if (nif != nullptr) {
-        // Determine if NIF has attached havok animations
-        vector<NiObject*> nifBlockTree;
-        nif->GetTree(nifBlockTree);
+    onRebind();
+}
 
-        for (NiObject* nifBlock : nifBlockTree) {
-            if (boost::iequals(nifBlock->GetBlockName(), "BSBehaviorGraphExtraData")) {
-                m_hasAttachedHavok = true;
-            }
-        }
+void PatcherMeshShaderVanillaParallax::onRebind()
+{
+    m_hasAttachedHavok = false;
+    if (hasNIF()) {
+        // Determine if NIF has attached havok animations
+        m_hasAttachedHavok = !getBlockIndex().getBlocksByName("BSBehaviorGraphExtraData").empty();
     }
 }
 
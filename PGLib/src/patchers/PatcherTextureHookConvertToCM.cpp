@@ -13,8 +13,6 @@
 #include <shared_mutex>
 #include <stdexcept>
 #include <utility>
-#include <winerror.h>
-#include <winnt.h>
 
 using namespace std;
 using namespace Microsoft::WRL;
@@ -67,59 +65,38 @@ PatcherTextureHookConvertToCM::PatcherTextureHookConvertToCM(std::filesystem::pa
 {
 }
 
-auto PatcherTextureHookConvertToCM::applyPatch() -> bool
+auto PatcherTextureHookConvertToCM::applyShader(DirectX::ScratchImage& out) -> bool
 {
-    auto* pgd = PGGlobals::getPGD();
     auto* pgd3d = PGGlobals::getPGD3D();
 
     if (getDDS() == nullptr) {
         throw runtime_error("DDS not initialized");
     }
 
-    const auto texBase = PGNIFUtil::getTexBase(getDDSPath(), PGEnums::TextureSlots::PARALLAX);
-    const auto newPath = texBase + L"_m.dds";
-
-    DirectX::ScratchImage newDDS;
-    if (!pgd3d->applyShaderToTexture(*getDDS(), newDDS, s_shader, DXGI_FORMAT_R8G8B8A8_UNORM)) {
-        return false;
-    }
-
-    if (newDDS.GetImageCount() < 1) {
+    if (!pgd3d->applyShaderToTexture(*getDDS(), out, s_shader, DXGI_FORMAT_R8G8B8A8_UNORM)) {
         return false;
     }
 
-    const lock_guard<mutex> lock(s_generatedFileTrackerMutex);
-
-    const auto outPath = pgd->getGeneratedPath() / newPath;
-    filesystem::create_directories(outPath.parent_path());
+    return out.GetImageCount() >= 1;
+}
 
-    DirectX::ScratchImage compressedImage;
-    HRESULT hr = DirectX::Compress(newDDS.GetImages(),
-                                   newDDS.GetImageCount(),
-                                   newDDS.GetMetadata(),
-                                   DXGI_FORMAT_BC3_UNORM,
-                                   DirectX::TEX_COMPRESS_DEFAULT,
-                                   1.0F,
-                                   compressedImage);
+auto PatcherTextureHookConvertToCM::getOutputPath() const -> filesystem::path
+{
+    return getOutputFilename(getDDSPath());
+}
 
-    if (FAILED(hr)) {
-        return false;
-    }
+auto PatcherTextureHookConvertToCM::getOutputFormat() const -> DXGI_FORMAT { return DXGI_FORMAT_BC3_UNORM; }
 
-    hr = DirectX::SaveToDDSFile(compressedImage.GetImages(),
-                                compressedImage.GetImageCount(),
-                                compressedImage.GetMetadata(),
-                                DirectX::DDS_FLAGS_NONE,
-                                outPath.c_str());
+void PatcherTextureHookConvertToCM::registerOutput()
+{
+    auto* pgd = PGGlobals::getPGD();
 
-    if (FAILED(hr)) {
-        return false;
-    }
+    const auto texBase = PGNIFUtil::getTexBase(getDDSPath(), PGEnums::TextureSlots::PARALLAX);
+    const auto newPath = getOutputPath();
 
     // add newly created file to complexMaterialMaps for later processing
+    const lock_guard<mutex> lock(s_generatedFileTrackerMutex);
     pgd->getTextureMap(PGEnums::TextureSlots::ENVMASK)[texBase].insert(
         {newPath, PGEnums::TextureType::COMPLEXMATERIAL});
     pgd->setTextureType(newPath, PGEnums::TextureType::COMPLEXMATERIAL);
-
-    return true;
 }
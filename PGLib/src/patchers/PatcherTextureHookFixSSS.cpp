@@ -15,8 +15,6 @@
 #include <shared_mutex>
 #include <stdexcept>
 #include <utility>
-#include <winerror.h>
-#include <winnt.h>
 
 using namespace std;
 using namespace Microsoft::WRL;
@@ -69,26 +67,21 @@ PatcherTextureHookFixSSS::PatcherTextureHookFixSSS(std::filesystem::path ddsPath
 {
 }
 
-auto PatcherTextureHookFixSSS::applyPatch() -> bool
+auto PatcherTextureHookFixSSS::applyShader(DirectX::ScratchImage& out) -> bool
 {
-    auto* pgd = PGGlobals::getPGD();
     auto* pgd3d = PGGlobals::getPGD3D();
 
     if (getDDS() == nullptr) {
         throw runtime_error("DDS not initialized");
     }
 
-    const auto texBase = PGNIFUtil::getTexBase(getDDSPath(), PGEnums::TextureSlots::DIFFUSE);
-    const auto newPath = texBase + L"_s.dds";
-
-    DirectX::ScratchImage newDDS;
     static constexpr size_t SCALE_FACTOR = 2;
     const auto newWidth = static_cast<UINT>(getDDS()->GetMetadata().width / SCALE_FACTOR);
     const auto newHeight = static_cast<UINT>(getDDS()->GetMetadata().height / SCALE_FACTOR);
     // the shader delights and also reduces size by 4 for efficiency
     ShaderParams params = {.fAlbedoSatPower = SHADER_ALBEDO_SAT_POWER, .fAlbedoNorm = SHADER_ALBEDO_NORM};
     if (!pgd3d->applyShaderToTexture(*getDDS(),
-                                     newDDS,
+                                     out,
                                      s_shader,
                                      DXGI_FORMAT_R8G8B8A8_UNORM,
                                      newWidth,
@@ -98,41 +91,22 @@ auto PatcherTextureHookFixSSS::applyPatch() -> bool
         return false;
     }
 
-    if (newDDS.GetImageCount() < 1) {
-        return false;
-    }
-
-    const lock_guard<mutex> lock(s_generatedFileTrackerMutex);
-
-    const auto outPath = pgd->getGeneratedPath() / newPath;
-    filesystem::create_directories(outPath.parent_path());
+    return out.GetImageCount() >= 1;
+}
 
-    DirectX::ScratchImage compressedImage;
-    HRESULT hr = DirectX::Compress(newDDS.GetImages(),
-                                   newDDS.GetImageCount(),
-                                   newDDS.GetMetadata(),
-                                   DXGI_FORMAT_BC2_UNORM,
-                                   DirectX::TEX_COMPRESS_DEFAULT,
-                                   1.0F,
-                                   compressedImage);
+auto PatcherTextureHookFixSSS::getOutputPath() const -> filesystem::path { return getOutputFilename(getDDSPath()); }
 
-    if (FAILED(hr)) {
-        return false;
-    }
+auto PatcherTextureHookFixSSS::getOutputFormat() const -> DXGI_FORMAT { return DXGI_FORMAT_BC2_UNORM; }
 
-    hr = DirectX::SaveToDDSFile(compressedImage.GetImages(),
-                                compressedImage.GetImageCount(),
-                                compressedImage.GetMetadata(),
-                                DirectX::DDS_FLAGS_NONE,
-                                outPath.c_str());
+void PatcherTextureHookFixSSS::registerOutput()
+{
+    auto* pgd = PGGlobals::getPGD();
 
-    if (FAILED(hr)) {
-        return false;
-    }
+    const auto texBase = PGNIFUtil::getTexBase(getDDSPath(), PGEnums::TextureSlots::DIFFUSE);
+    const auto newPath = getOutputPath();
 
-    // add newly created file to complexMaterialMaps for later processing
+    // add newly created file to subsurface maps for later processing
+    const lock_guard<mutex> lock(s_generatedFileTrackerMutex);
     pgd->getTextureMap(PGEnums::TextureSlots::GLOW)[texBase].insert({newPath, PGEnums::TextureType::SUBSURFACECOLOR});
     pgd->setTextureType(newPath, PGEnums::TextureType::SUBSURFACECOLOR);
-
-    return true;
 }
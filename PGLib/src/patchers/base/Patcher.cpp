@@ -10,4 +10,4 @@ Patcher::Patcher(string patcherName)
 {
 }
 
-auto Patcher::getPatcherName() const -> string { return m_patcherName; }
+auto Patcher::getPatcherName() const -> const string& { return m_patcherName; }
@@ -1,6 +1,7 @@
 #include "patchers/base/PatcherMesh.hpp"
 
 #include "patchers/base/Patcher.hpp"
+#include "pgutil/PGNIFBlockIndex.hpp"
 #include "pgutil/PGNIFUtil.hpp"
 #include "pgutil/PGTypes.hpp"
 #include "util/StringUtil.hpp"
@@ -136,9 +137,20 @@ PatcherMesh::PatcherMesh(filesystem::path nifPath,
     : Patcher(std::move(patcherName))
     , m_nifPath(std::move(nifPath))
     , m_nif(nif)
+    , m_blockIndex(PGNIFBlockIndex::getActive(nif))
 {
 }
 
+void PatcherMesh::rebind(filesystem::path nifPath,
+                         nifly::NifFile* nif)
+{
+    m_nifPath = std::move(nifPath);
+    setNIF(nif);
+    onRebind();
+}
+
+void PatcherMesh::onRebind() {}
+
 auto PatcherMesh::getNIFPath() const -> filesystem::path { return m_nifPath; }
 
 auto PatcherMesh::getNIF() const -> nifly::NifFile*
@@ -150,4 +162,28 @@ auto PatcherMesh::getNIF() const -> nifly::NifFile*
     return m_nif;
 }
 
-void PatcherMesh::setNIF(nifly::NifFile* nif) { m_nif = nif; }
+auto PatcherMesh::hasNIF() const -> bool { return m_nif != nullptr; }
+
+void PatcherMesh::setNIF(nifly::NifFile* nif)
+{
+    m_nif = nif;
+    m_blockIndex = PGNIFBlockIndex::getActive(nif);
+    if (m_ownBlockIndex != nullptr) {
+        // keep the fallback index of a pooled patcher around, it is re-pointed when needed
+        m_ownBlockIndex->reset(nullptr);
+    }
+}
+
+auto PatcherMesh::getBlockIndex() -> PGNIFBlockIndex&
+{
+    if (m_blockIndex == nullptr) {
+        if (m_ownBlockIndex == nullptr) {
+            m_ownBlockIndex = make_unique<PGNIFBlockIndex>(getNIF());
+        } else {
+            m_ownBlockIndex->reset(getNIF());
+        }
+        m_blockIndex = m_ownBlockIndex.get();
+    }
+
+    return *m_blockIndex;
+}
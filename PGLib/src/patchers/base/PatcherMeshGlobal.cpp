@@ -1,6 +1,7 @@
 #include "patchers/base/PatcherMeshGlobal.hpp"
 
 #include "patchers/base/PatcherMesh.hpp"
+#include "pgutil/PGNIFScanner.hpp"
 
 #include "NifFile.hpp"
 
@@ -18,3 +19,8 @@ PatcherMeshGlobal::PatcherMeshGlobal(std::filesystem::path nifPath,
                   std::move(patcherName))
 {
 }
+
+auto PatcherMeshGlobal::mayApply([[maybe_unused]] const PGNIFScanner::MeshShapes& meshShapes) const -> bool
+{
+    return true;
+}
@@ -1,6 +1,7 @@
 #include "patchers/base/PatcherMeshPost.hpp"
 
 #include "patchers/base/PatcherMesh.hpp"
+#include "pgutil/PGNIFScanner.hpp"
 
 #include "NifFile.hpp"
 
@@ -18,3 +19,5 @@ PatcherMeshPost::PatcherMeshPost(std::filesystem::path nifPath,
                   std::move(patcherName))
 {
 }
+
+auto PatcherMeshPost::mayApply([[maybe_unused]] const PGNIFScanner::ShaderShape& shape) const -> bool { return true; }
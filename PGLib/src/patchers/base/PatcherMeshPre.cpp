@@ -1,6 +1,7 @@
 #include "patchers/base/PatcherMeshPre.hpp"
 
 #include "patchers/base/PatcherMesh.hpp"
+#include "pgutil/PGNIFScanner.hpp"
 
 #include "NifFile.hpp"
 
@@ -18,3 +19,5 @@ PatcherMeshPre::PatcherMeshPre(std::filesystem::path nifPath,
                   std::move(patcherName))
 {
 }
+
+auto PatcherMeshPre::mayApply([[maybe_unused]] const PGNIFScanner::ShaderShape& shape) const -> bool { return true; }
@@ -19,3 +19,9 @@ PatcherMeshShader::PatcherMeshShader(filesystem::path nifPath,
                   std::move(patcherName))
 {
 }
+
+auto PatcherMeshShader::getMatchContext() const -> wstring { return {}; }
+
+auto PatcherMeshShader::canMemoizeMatches() const -> bool { return true; }
+
+auto PatcherMeshShader::modifiesShapes() const -> bool { return true; }
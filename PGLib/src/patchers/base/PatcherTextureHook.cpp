@@ -1,12 +1,19 @@
 #include "patchers/base/PatcherTextureHook.hpp"
 
+#include "PGD3D.hpp"
+#include "PGGlobals.hpp"
 #include "patchers/base/PatcherTexture.hpp"
+#include "util/BCEncoder.hpp"
+#include "util/Logger.hpp"
 
 #include <DirectXTex.h>
+#include <dxgiformat.h>
 
 #include <filesystem>
 #include <string>
 #include <utility>
+#include <winerror.h>
+#include <winnt.h>
 
 using namespace std;
 
@@ -18,3 +25,52 @@ PatcherTextureHook::PatcherTextureHook(std::filesystem::path texPath,
                      std::move(patcherName))
 {
 }
+
+auto PatcherTextureHook::applyPatch() -> bool
+{
+    DirectX::ScratchImage shaderOutput;
+    if (!applyShader(shaderOutput)) {
+        return false;
+    }
+
+    DirectX::ScratchImage compressedImage;
+    if (!compressOutput(shaderOutput, getOutputFormat(), compressedImage)) {
+        return false;
+    }
+
+    if (!saveOutput(compressedImage, getOutputPath())) {
+        return false;
+    }
+
+    registerOutput();
+    return true;
+}
+
+auto PatcherTextureHook::compressOutput(const DirectX::ScratchImage& source,
+                                        const DXGI_FORMAT& format,
+                                        DirectX::ScratchImage& out) -> bool
+{
+    const HRESULT hr = BCEncoder::compress(source, format, COMPRESS_QUALITY, out);
+    if (FAILED(hr)) {
+        Logger::debug(L"Unable to compress generated texture: {}", PGD3D::getHRESULTErrorMessage(hr));
+        return false;
+    }
+
+    return true;
+}
+
+auto PatcherTextureHook::saveOutput(const DirectX::ScratchImage& image,
+                                    const filesystem::path& outputPath) -> bool
+{
+    const auto outPath = PGGlobals::getPGD()->getGeneratedPath() / outputPath;
+    filesystem::create_directories(outPath.parent_path());
+
+    const HRESULT hr = DirectX::SaveToDDSFile(
+        image.GetImages(), image.GetImageCount(), image.GetMetadata(), DirectX::DDS_FLAGS_NONE, outPath.c_str());
+    if (FAILED(hr)) {
+        Logger::debug(L"Unable to save generated texture {}: {}", outPath.wstring(), PGD3D::getHRESULTErrorMessage(hr));
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,153 @@
+#include "pgutil/PGMeshPatchStore.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+PGMeshPatchStore::View::View(vector<shared_ptr<const MeshEntry>> meshes)
+    : m_meshes(std::move(meshes))
+{
+    // stable so that the latest record of a mesh added twice ends up last, shards keep insertion order per path
+    ranges::stable_sort(m_meshes, [](const auto& a, const auto& b) -> bool { return a->meshPath < b->meshPath; });
+
+    size_t outIdx = 0;
+    for (size_t inIdx = 0; inIdx < m_meshes.size(); inIdx++) {
+        if (outIdx > 0 && m_meshes[outIdx - 1]->meshPath == m_meshes[inIdx]->meshPath) {
+            // replace older record
+            m_meshes[outIdx - 1] = std::move(m_meshes[inIdx]);
+            continue;
+        }
+        if (outIdx != inIdx) {
+            m_meshes[outIdx] = std::move(m_meshes[inIdx]);
+        }
+        outIdx++;
+    }
+    m_meshes.resize(outIdx);
+}
+
+auto PGMeshPatchStore::View::find(const filesystem::path& meshPath) const -> const MeshMeta*
+{
+    const auto it = ranges::lower_bound(
+        m_meshes, meshPath, less<> {}, [](const auto& entry) -> const filesystem::path& { return entry->meshPath; });
+    if (it == m_meshes.end() || (*it)->meshPath != meshPath) {
+        return nullptr;
+    }
+
+    return &(*it)->meta;
+}
+
+auto PGMeshPatchStore::View::contains(const filesystem::path& meshPath) const -> bool
+{
+    return find(meshPath) != nullptr;
+}
+
+auto PGMeshPatchStore::getPatcherBit(const string& patcherName) -> PatcherMask
+{
+    {
+        const shared_lock lock(s_patcherNamesMutex);
+        const auto it = s_patcherBits.find(patcherName);
+        if (it != s_patcherBits.end()) {
+            return it->second;
+        }
+    }
+
+    const unique_lock lock(s_patcherNamesMutex);
+    const auto it = s_patcherBits.find(patcherName);
+    if (it != s_patcherBits.end()) {
+        return it->second;
+    }
+
+    if (s_patcherNames.size() >= MAX_PATCHERS) {
+        throw runtime_error("Too many patchers for patch metadata mask");
+    }
+
+    const PatcherMask bit = PatcherMask {1} << s_patcherNames.size();
+    s_patcherNames.push_back(patcherName);
+    s_patcherBits.emplace(patcherName, bit);
+    return bit;
+}
+
+auto PGMeshPatchStore::getPatcherNames(const PatcherMask& mask) -> vector<string>
+{
+    vector<string> names;
+
+    const shared_lock lock(s_patcherNamesMutex);
+    for (auto remaining = mask; remaining != 0; remaining &= remaining - 1) {
+        const auto bitIdx = static_cast<size_t>(countr_zero(remaining));
+        if (bitIdx < s_patcherNames.size()) {
+            names.push_back(s_patcherNames[bitIdx]);
+        }
+    }
+
+    return names;
+}
+
+auto PGMeshPatchStore::internShapeName(const string& shapeName) -> string_view
+{
+    const size_t shardIdx = hash<string> {}(shapeName) % SHARD_COUNT;
+
+    const lock_guard lock(s_shapeNameMutexes.at(shardIdx));
+    // set nodes never move, so the view stays valid
+    return *s_shapeNames.at(shardIdx).insert(shapeName).first;
+}
+
+void PGMeshPatchStore::add(filesystem::path meshPath,
+                           MeshMeta&& meta)
+{
+    auto entry = make_shared<const MeshEntry>(MeshEntry {.meshPath = std::move(meshPath), .meta = std::move(meta)});
+    auto& shard = m_shards.at(hash<filesystem::path> {}(entry->meshPath) % SHARD_COUNT);
+
+    {
+        const lock_guard lock(shard.mutex);
+        shard.meshes.push_back(std::move(entry));
+    }
+
+    m_size.fetch_add(1);
+    m_generation.fetch_add(1);
+}
+
+auto PGMeshPatchStore::getView() -> shared_ptr<const View>
+{
+    const lock_guard viewLock(m_viewMutex);
+
+    const auto curGeneration = m_generation.load();
+    if (m_view != nullptr && m_viewGeneration == curGeneration) {
+        return m_view;
+    }
+
+    vector<shared_ptr<const MeshEntry>> meshes;
+    meshes.reserve(m_size.load());
+    for (auto& shard : m_shards) {
+        const lock_guard lock(shard.mutex);
+        meshes.insert(meshes.end(), shard.meshes.begin(), shard.meshes.end());
+    }
+
+    m_view = make_shared<const View>(std::move(meshes));
+    m_viewGeneration = curGeneration;
+    return m_view;
+}
+
+auto PGMeshPatchStore::empty() const -> bool { return m_size.load() == 0; }
+
+void PGMeshPatchStore::clear()
+{
+    for (auto& shard : m_shards) {
+        const lock_guard lock(shard.mutex);
+        shard.meshes.clear();
+    }
+
+    m_size.store(0);
+    m_generation.fetch_add(1);
+}
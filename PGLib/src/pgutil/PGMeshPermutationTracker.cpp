@@ -3,7 +3,10 @@
 #include "PGGlobals.hpp"
 #include "pgutil/PGNIFUtil.hpp"
 #include "pgutil/PGTypes.hpp"
+#include "util/HashUtil.hpp"
 #include "util/Logger.hpp"
+#include "util/MemoryGovernor.hpp"
+#include "util/OutputBuffer.hpp"
 #include "util/StringUtil.hpp"
 
 #include "BasicTypes.hpp"
@@ -12,7 +15,6 @@
 #include "Particles.hpp"
 #include "Shaders.hpp"
 #include <boost/algorithm/string/predicate.hpp>
-#include <boost/crc.hpp>
 
 #include <algorithm>
 #include <cstddef>
@@ -20,11 +22,12 @@
 #include <filesystem>
 #include <fstream>
 #include <ios>
+#include <map>
 #include <memory>
-#include <mutex>
-#include <sstream>
+#include <ostream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -32,10 +35,42 @@
 
 using namespace std;
 
-PGMeshPermutationTracker::PGMeshPermutationTracker(const std::filesystem::path& origMeshPath)
+auto PGMeshPermutationTracker::FormKey::make(wstring_view modKey,
+                                             uint32_t formID,
+                                             string_view subMODL) -> FormKey
+{
+    return {.pluginID = s_modKeys.intern(modKey), .subModelID = s_subModels.intern(subMODL), .formID = formID};
+}
+
+auto PGMeshPermutationTracker::FormKey::getModKey() const -> const wstring& { return s_modKeys.get(pluginID); }
+
+auto PGMeshPermutationTracker::FormKey::getSubMODL() const -> const string& { return s_subModels.get(subModelID); }
+
+auto PGMeshPermutationTracker::FormKey::operator<(const FormKey& other) const -> bool
+{
+    if (pluginID != other.pluginID) {
+        return getModKey() < other.getModKey();
+    }
+    if (formID != other.formID) {
+        return formID < other.formID;
+    }
+    if (subModelID != other.subModelID) {
+        return getSubMODL() < other.getSubMODL();
+    }
+    return false;
+}
+
+auto PGMeshPermutationTracker::FormKey::getInternerStats() -> pair<size_t, size_t>
+{
+    return {s_modKeys.size() + s_subModels.size(), s_modKeys.getBytes() + s_subModels.getBytes()};
+}
+
+PGMeshPermutationTracker::PGMeshPermutationTracker(const std::filesystem::path& origMeshPath,
+                                                   WeightVariantFingerprints* weightVariants)
     : m_origMeshPath(origMeshPath)
     , m_origCrc32(0)
     , m_stagedMeshPtr(nullptr)
+    , m_weightVariants(weightVariants)
 {
     // Check if file exists
     auto* pgd = PGGlobals::getPGD();
@@ -49,10 +84,12 @@ void PGMeshPermutationTracker::load()
     // Load original NIF file
     const vector<std::byte> nifFileData = PGGlobals::getPGD()->getFile(m_origMeshPath);
 
+    // blocks while the memory budget is exhausted so that workers do not pile up parsed NIFs
+    m_parsedNIFReservation
+        = MemoryGovernor::acquire(getParsedNIFMemory(), nifFileData.size() * PARSED_NIF_SIZE_FACTOR);
+
     // Calculate original CRC32
-    boost::crc_32_type crcBeforeResult {};
-    crcBeforeResult.process_bytes(nifFileData.data(), nifFileData.size());
-    m_origCrc32 = crcBeforeResult.checksum();
+    m_origCrc32 = HashUtil::crc32(nifFileData.data(), nifFileData.size());
 
     // Load original NIF
     m_origNifFile = PGNIFUtil::loadNIFFromBytes(nifFileData, false);
@@ -84,12 +121,15 @@ auto PGMeshPermutationTracker::stageMesh() -> nifly::NifFile*
     m_stagedMesh.CopyFrom(m_origNifFile);
     m_stagedMeshPtr = &m_stagedMesh;
 
-    // Store original 3D indices for the staged mesh
-    m_stagedMeshOriginal3DIdx = get3dIndices(m_stagedMeshPtr);
+    // Store original 3D indices for the staged mesh, the index is shared with the patchers from here on
+    m_stagedBlockIndex.reset(m_stagedMeshPtr);
+    m_stagedMeshOriginal3DIdx = m_stagedBlockIndex.get3dIndices();
 
     return m_stagedMeshPtr;
 }
 
+auto PGMeshPermutationTracker::getStagedBlockIndex() -> PGNIFBlockIndex& { return m_stagedBlockIndex; }
+
 void PGMeshPermutationTracker::ignoreBaseMesh() { m_ignoreBaseMesh = true; }
 
 auto PGMeshPermutationTracker::commitMesh(const FormKey& formKey,
@@ -114,7 +154,8 @@ auto PGMeshPermutationTracker::commitMesh(const FormKey& formKey,
 
     // Build current->original 3D index map for the staged mesh so comparisons remain stable if
     // patchers deleted shapes and shifted current indices.
-    const auto stagedCurrent3DIndices = get3dIndices(m_stagedMeshPtr);
+    // Only walks the tree again if patchers changed the block structure
+    const auto& stagedCurrent3DIndices = m_stagedBlockIndex.get3dIndices();
     const auto stagedInverseIdxCorrectionsPatching
         = buildInverseIdxCorrections(stagedCurrent3DIndices, m_stagedMeshOriginal3DIdx);
 
@@ -240,24 +281,26 @@ auto PGMeshPermutationTracker::saveMeshes() -> pair<vector<MeshResult>,
 
         // Save Mesh file
 
-        // Write to memory buffer
+        // Write to memory buffer, the CRC32 of the base mesh is computed while saving
         bool saveSuccess = false;
-        ostringstream buffer(std::ios::binary);
-        saveSuccess = (mesh.Save(buffer, {.optimize = false, .sortBlocks = false}) == 0);
-        const string& data = buffer.str();
+        auto buffer = make_shared<OutputBuffer>(curIndex == 0);
+        {
+            ostream bufferStream(buffer.get());
+            saveSuccess = (mesh.Save(bufferStream, {.optimize = false, .sortBlocks = false}) == 0);
+        }
 
         if (curIndex == 0) {
-            // get CRC32
-            boost::crc_32_type crc;
-            crc.process_bytes(data.data(), data.size());
-            baseCrc32 = crc.checksum();
+            baseCrc32 = buffer->getCRC32();
         }
 
-        // queue save to file saver
-        PGGlobals::getFileSaver().queueTask([data, meshFilename]() -> void {
+        // queue save to file saver, the file saver drains on its own so waiting here cannot deadlock
+        // the buffer itself moves into the queue and goes back to the pool once it is written
+        auto writeReservation = make_shared<MemoryGovernor::Reservation>(
+            MemoryGovernor::acquire(getMeshWriteMemory(), buffer->size()));
+        PGGlobals::getFileSaver().queueTask([buffer = std::move(buffer), meshFilename, writeReservation]() -> void {
             std::ofstream file(meshFilename, std::ios::binary);
             if (file.is_open()) {
-                file.write(data.data(), static_cast<std::streamsize>(data.size()));
+                file.write(buffer->data(), static_cast<std::streamsize>(buffer->size()));
                 file.close();
             }
         });
@@ -288,40 +331,80 @@ auto PGMeshPermutationTracker::saveMeshes() -> pair<vector<MeshResult>,
     return {output, {m_origCrc32, baseCrc32}};
 }
 
-void PGMeshPermutationTracker::validateWeightedVariants()
+auto PGMeshPermutationTracker::getParsedNIFMemory() -> MemoryGovernor::Subsystem*
 {
-    const std::scoped_lock lock(s_otherWeightVariantsMutex);
-    for (const auto& [key, nifFile] : s_otherWeightVariants) {
+    static auto* const subsystem = MemoryGovernor::registerSubsystem("Parsed NIFs");
+    return subsystem;
+}
+
+auto PGMeshPermutationTracker::getMeshWriteMemory() -> MemoryGovernor::Subsystem*
+{
+    static auto* const subsystem = MemoryGovernor::registerSubsystem("Mesh Write Queue");
+    return subsystem;
+}
+
+void PGMeshPermutationTracker::reportUnmatchedWeightVariants(const WeightVariantFingerprints& weightVariants)
+{
+    for (const auto& [key, fingerprint] : weightVariants.pending) {
         Logger::error(L"Weighted mesh variant for '{}' not created. Weight variants (_0 and _1) do not match.",
                       key.first.wstring());
     }
-    s_otherWeightVariants.clear();
 }
 
 void PGMeshPermutationTracker::processWeightVariant()
 {
-    // Check other weight variant cache
-    const std::scoped_lock lock(s_otherWeightVariantsMutex);
+    if (m_weightVariants == nullptr) {
+        // not scheduled together with the other variant
+        return;
+    }
+
     const auto dupIdx = m_outputMeshes.size();
     // check if other variant exists
     const auto otherVariantPath = getOtherWeightVariant(m_origMeshPath);
-    if (s_otherWeightVariants.contains({otherVariantPath, dupIdx})) {
-        if (!compareMesh(m_stagedMesh, s_otherWeightVariants[{otherVariantPath, dupIdx}], {}, true, true)) {
+    const auto otherIt = m_weightVariants->pending.find({otherVariantPath, dupIdx});
+    if (otherIt != m_weightVariants->pending.end()) {
+        if (getShapeFingerprint(m_stagedBlockIndex) != otherIt->second) {
             // different from each other, post error
             Logger::error(L"Weighted mesh variants '{}' and '{}' do not match.",
                           m_origMeshPath.wstring(),
                           otherVariantPath.wstring());
         }
 
-        // delete from cache to free memory
-        s_otherWeightVariants.erase({otherVariantPath, dupIdx});
+        m_weightVariants->pending.erase(otherIt);
     } else {
-        // add to cache
-        s_otherWeightVariants[{m_origMeshPath, dupIdx}] = nifly::NifFile();
-        s_otherWeightVariants[{m_origMeshPath, dupIdx}].CopyFrom(m_stagedMesh);
+        // wait for the other variant
+        m_weightVariants->pending[{m_origMeshPath, dupIdx}] = getShapeFingerprint(m_stagedBlockIndex);
     }
 }
 
+auto PGMeshPermutationTracker::getShapeFingerprint(PGNIFBlockIndex& blockIndex) -> ShapeFingerprint
+{
+    // must stay in sync with the checks compareMesh makes with checkOnlyWeighted
+    const auto& blocks = blockIndex.getComparableBlocks();
+
+    ShapeFingerprint fingerprint;
+    fingerprint.reserve(blocks.size());
+    for (auto* const block : blocks) {
+        uint8_t kind = 0;
+        const bool isParticle = dynamic_cast<nifly::NiParticleSystem*>(block) != nullptr;
+        if (isParticle) {
+            kind |= FINGERPRINT_PARTICLE;
+        }
+
+        auto* const shape = dynamic_cast<NiShape*>(block);
+        if (shape != nullptr) {
+            kind |= FINGERPRINT_SHAPE;
+            if (!isParticle && dynamic_cast<nifly::BSTriShape*>(shape) != nullptr) {
+                kind |= FINGERPRINT_TRISHAPE;
+            }
+        }
+
+        fingerprint.push_back(kind);
+    }
+
+    return fingerprint;
+}
+
 //
 // ANY changes in patchers that involve WRITING new properties must be included in the equality operators below
 //
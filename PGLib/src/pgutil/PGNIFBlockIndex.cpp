@@ -0,0 +1,150 @@
+#include "pgutil/PGNIFBlockIndex.hpp"
+
+#include "BasicTypes.hpp"
+#include "Geometry.hpp"
+#include "NifFile.hpp"
+#include "Particles.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+PGNIFBlockIndex::Scope::Scope(PGNIFBlockIndex& index)
+    : m_prevActive(s_activeIndex)
+{
+    s_activeIndex = &index;
+}
+
+PGNIFBlockIndex::Scope::~Scope() { s_activeIndex = m_prevActive; }
+
+PGNIFBlockIndex::PGNIFBlockIndex(const nifly::NifFile* nif)
+    : m_nif(nif)
+{
+}
+
+void PGNIFBlockIndex::reset(const nifly::NifFile* nif)
+{
+    m_nif = nif;
+    m_dirty = true;
+}
+
+void PGNIFBlockIndex::invalidate() { m_dirty = true; }
+
+auto PGNIFBlockIndex::getNIF() const -> const nifly::NifFile* { return m_nif; }
+
+void PGNIFBlockIndex::ensureCurrent()
+{
+    if (m_nif == nullptr) {
+        throw runtime_error("NIF is null");
+    }
+
+    if (m_dirty || m_nif->GetHeader().GetNumBlocks() != m_numBlocks) {
+        rebuild();
+    }
+}
+
+void PGNIFBlockIndex::rebuild()
+{
+    m_blocksByName.clear();
+    m_children.clear();
+    m_shapes.clear();
+    m_comparableBlocks.clear();
+    m_3dIndices.clear();
+
+    vector<nifly::NiObject*> tree;
+    m_nif->GetTree(tree);
+    m_children.reserve(tree.size());
+
+    int index3D = 0;
+    vector<uint32_t> childIndices;
+    for (auto* const block : tree) {
+        m_blocksByName[block->GetBlockName()].push_back(block);
+
+        childIndices.clear();
+        block->GetChildIndices(childIndices);
+        auto& children = m_children[block];
+        children.reserve(childIndices.size());
+        for (const auto childIdx : childIndices) {
+            auto* const child = m_nif->GetHeader().GetBlock<nifly::NiObject>(childIdx);
+            if (child == nullptr) {
+                continue;
+            }
+
+            children.push_back(child);
+        }
+
+        // same order and rules the plugins use for 3D indices
+        auto* const shape = dynamic_cast<nifly::NiShape*>(block);
+        if (shape != nullptr) {
+            m_shapes.push_back({.shape = shape, .index3D = index3D});
+            m_comparableBlocks.push_back(block);
+            m_3dIndices[block] = index3D++;
+            continue;
+        }
+
+        if (dynamic_cast<nifly::NiParticleSystem*>(block) != nullptr) {
+            m_comparableBlocks.push_back(block);
+            m_3dIndices[block] = index3D++;
+        }
+    }
+
+    m_numBlocks = m_nif->GetHeader().GetNumBlocks();
+    m_dirty = false;
+}
+
+auto PGNIFBlockIndex::getBlocksByName(string_view blockName) -> const vector<nifly::NiObject*>&
+{
+    static const vector<nifly::NiObject*> emptyBlocks;
+
+    ensureCurrent();
+    const auto it = m_blocksByName.find(blockName);
+    if (it == m_blocksByName.end()) {
+        return emptyBlocks;
+    }
+
+    return it->second;
+}
+
+auto PGNIFBlockIndex::getChildren(nifly::NiObject* block) -> const vector<nifly::NiObject*>&
+{
+    static const vector<nifly::NiObject*> emptyBlocks;
+
+    ensureCurrent();
+    const auto it = m_children.find(block);
+    if (it == m_children.end()) {
+        return emptyBlocks;
+    }
+
+    return it->second;
+}
+
+auto PGNIFBlockIndex::getShapes() -> const vector<ShapeEntry>&
+{
+    ensureCurrent();
+    return m_shapes;
+}
+
+auto PGNIFBlockIndex::getComparableBlocks() -> const vector<nifly::NiObject*>&
+{
+    ensureCurrent();
+    return m_comparableBlocks;
+}
+
+auto PGNIFBlockIndex::get3dIndices() -> const unordered_map<nifly::NiObject*, int>&
+{
+    ensureCurrent();
+    return m_3dIndices;
+}
+
+auto PGNIFBlockIndex::getActive(const nifly::NifFile* nif) -> PGNIFBlockIndex*
+{
+    if (s_activeIndex == nullptr || s_activeIndex->m_nif != nif) {
+        return nullptr;
+    }
+
+    return s_activeIndex;
+}
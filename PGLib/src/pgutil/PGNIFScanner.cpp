@@ -0,0 +1,740 @@
+#include "pgutil/PGNIFScanner.hpp"
+
+#include "pgutil/PGNIFUtil.hpp"
+#include "pgutil/PGTypes.hpp"
+#include "util/Logger.hpp"
+#include "util/StringUtil.hpp"
+
+#include "NifFile.hpp"
+#include "Nodes.hpp"
+#include "Shaders.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+namespace {
+constexpr uint32_t NIF_VERSION_SKYRIM = 0x14020007; /** 20.2.0.7 */
+constexpr uint32_t NIF_USER_VERSION_SKYRIM = 12;
+constexpr uint32_t BS_VERSION_SKYRIM_LE = 83;
+constexpr uint32_t BS_VERSION_SKYRIM_SE = 100;
+constexpr uint8_t NIF_LITTLE_ENDIAN = 1;
+constexpr uint32_t NIF_NPOS = 0xFFFFFFFF;
+constexpr size_t NUM_EXPORT_STRINGS = 3; /** Author, process script and export script */
+constexpr uint16_t BLOCK_TYPE_INDEX_MASK = 0x7FFF;
+constexpr size_t MAX_NISTRING_LENGTH = 2048; /** nifly reads strings into a buffer of this size */
+constexpr double BYTES_PER_MIB = 1024.0 * 1024.0;
+
+// sizes of fields the scanner steps over
+constexpr size_t NIAVOBJECT_FLAGS_SIZE = 4;
+constexpr size_t NIAVOBJECT_TRANSFORM_SIZE = 52; /** Translation, rotation and scale */
+constexpr size_t NIBOUND_SIZE = 16;
+constexpr size_t SHADER_UV_SIZE = 16; /** UV offset and scale */
+constexpr size_t EFFECT_SHADER_PARAMS_SIZE = 44; /** Clamp mode bytes, falloff, base color, scale, soft depth */
+constexpr size_t LIGHTING_SHADER_PARAMS_SIZE = 48; /** Emissive, clamp mode, alpha, refraction, glossiness, specular */
+
+constexpr string_view NIF_HEADER_PREFIX = "Gamebryo File Format";
+constexpr string_view PG_IGNORE_NAME = "PG_IGNORE";
+constexpr string_view BILLBOARD_NODE_NAME = "NiBillboardNode";
+
+enum class BlockKind : uint8_t {
+    UNKNOWN, /** Could be a shape, the scanner cannot handle the NIF */
+    OTHER, /** Never a shape, skipped */
+    NODE,
+    TRISHAPE, /** BSTriShape and its subclasses */
+    GEOMETRY, /** NiGeometry based shapes */
+    LIGHTING_SHADER,
+    EFFECT_SHADER,
+    TEXTURE_SET,
+    BOOLEAN_EXTRA_DATA
+};
+
+auto getBlockKind(string_view blockName,
+                  uint32_t bsVersion) -> BlockKind
+{
+    // NiNode and every block that derives from it, the child list is at the same place in all of them
+    static const unordered_set<string_view> nodeBlocks = {"NiNode",
+                                                          "BSFadeNode",
+                                                          "BSLeafAnimNode",
+                                                          "BSTreeNode",
+                                                          "BSMultiBoundNode",
+                                                          "BSOrderedNode",
+                                                          "BSValueNode",
+                                                          "BSBlastNode",
+                                                          "BSDamageStage",
+                                                          "BSRangeNode",
+                                                          "BSDebrisNode",
+                                                          "BSFaceGenNiNode",
+                                                          "NiBillboardNode",
+                                                          "NiSwitchNode",
+                                                          "NiLODNode",
+                                                          "NiSortAdjustNode",
+                                                          "NiBone",
+                                                          "AvoidNode",
+                                                          "RootCollisionNode",
+                                                          "NiBSAnimationNode"};
+
+    // blocks that are known not to be shapes and do not need a suffix rule
+    static const unordered_set<string_view> otherBlocks = {"BSXFlags",
+                                                           "BSBound",
+                                                           "BSInvMarker",
+                                                           "BSFurnitureMarkerNode",
+                                                           "BSWArray",
+                                                           "NiSkinInstance",
+                                                           "BSDismemberSkinInstance",
+                                                           "NiSkinPartition",
+                                                           "BSMultiBound",
+                                                           "BSMultiBoundAABB",
+                                                           "BSMultiBoundOBB",
+                                                           "BSMultiBoundSphere",
+                                                           "BSConnectPoint::Parents",
+                                                           "BSConnectPoint::Children",
+                                                           "NiPointLight",
+                                                           "NiAmbientLight",
+                                                           "NiDirectionalLight",
+                                                           "NiSpotLight",
+                                                           "NiCamera"};
+
+    static constexpr array<string_view, 2> OTHER_PREFIXES = {"bhk", "hk"};
+    static constexpr array<string_view, 6> OTHER_SUFFIXES
+        = {"Controller", "Interpolator", "Data", "Property", "Palette", "Sequence"};
+
+    if (blockName == "BSTriShape" || blockName == "BSDynamicTriShape" || blockName == "BSMeshLODTriShape") {
+        return bsVersion == BS_VERSION_SKYRIM_SE ? BlockKind::TRISHAPE : BlockKind::UNKNOWN;
+    }
+
+    if (blockName == "NiTriShape" || blockName == "BSLODTriShape") {
+        return bsVersion == BS_VERSION_SKYRIM_LE ? BlockKind::GEOMETRY : BlockKind::UNKNOWN;
+    }
+
+    if (blockName == "BSLightingShaderProperty") {
+        return BlockKind::LIGHTING_SHADER;
+    }
+
+    if (blockName == "BSEffectShaderProperty") {
+        return BlockKind::EFFECT_SHADER;
+    }
+
+    if (blockName == "BSShaderTextureSet") {
+        return BlockKind::TEXTURE_SET;
+    }
+
+    if (blockName == "NiBooleanExtraData") {
+        return BlockKind::BOOLEAN_EXTRA_DATA;
+    }
+
+    if (nodeBlocks.contains(blockName)) {
+        return BlockKind::NODE;
+    }
+
+    if (otherBlocks.contains(blockName)) {
+        return BlockKind::OTHER;
+    }
+
+    for (const auto& prefix : OTHER_PREFIXES) {
+        if (blockName.starts_with(prefix)) {
+            return BlockKind::OTHER;
+        }
+    }
+
+    for (const auto& suffix : OTHER_SUFFIXES) {
+        if (blockName.ends_with(suffix)) {
+            return BlockKind::OTHER;
+        }
+    }
+
+    return BlockKind::UNKNOWN;
+}
+
+/**
+ * @brief Bounds checked little endian reads over a byte range, throws runtime_error past the end
+ */
+class NIFReader {
+private:
+    const std::byte* m_data;
+    size_t m_size;
+    size_t m_pos = 0;
+
+    void require(size_t count) const
+    {
+        if (count > m_size - m_pos) {
+            throw runtime_error("Unexpected end of NIF data");
+        }
+    }
+
+public:
+    NIFReader(const std::byte* data,
+              size_t size)
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+
+    template <typename T> auto read() -> T
+    {
+        require(sizeof(T));
+        T value {};
+        memcpy(&value, m_data + m_pos, sizeof(T)); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        m_pos += sizeof(T);
+        return value;
+    }
+
+    void skip(size_t count)
+    {
+        require(count);
+        m_pos += count;
+    }
+
+    [[nodiscard]] auto getPos() const -> size_t { return m_pos; }
+
+    [[nodiscard]] auto getRemaining() const -> size_t { return m_size - m_pos; }
+
+    /** Header line up to the newline */
+    auto readLine() -> string
+    {
+        string line;
+        while (true) {
+            const auto c = read<char>();
+            if (c == '\n') {
+                return line;
+            }
+            line.push_back(c);
+        }
+    }
+
+    /** String with a 32-bit length, cut at the first null character like nifly does */
+    auto readNiString() -> string
+    {
+        const auto length = read<uint32_t>();
+        if (length >= MAX_NISTRING_LENGTH) {
+            throw runtime_error("NIF string is too long");
+        }
+
+        require(length);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const auto* chars = reinterpret_cast<const char*>(m_data) + m_pos;
+        string str(chars, length);
+        m_pos += length;
+
+        const auto nullPos = str.find('\0');
+        if (nullPos != string::npos) {
+            str.resize(nullPos);
+        }
+
+        return str;
+    }
+
+    /** Block reference list with a 32-bit count */
+    auto readRefs() -> vector<uint32_t>
+    {
+        const auto count = read<uint32_t>();
+        if (count > getRemaining() / sizeof(uint32_t)) {
+            throw runtime_error("Unexpected end of NIF data");
+        }
+
+        vector<uint32_t> refs(count);
+        for (auto& ref : refs) {
+            ref = read<uint32_t>();
+        }
+        return refs;
+    }
+};
+
+struct LightingShader {
+    uint32_t shaderType;
+    uint32_t shaderFlags1;
+    uint32_t shaderFlags2;
+    uint32_t textureSetRef;
+    float softLighting;
+    vector<uint32_t> extraDataRefs;
+};
+
+struct Shape {
+    uint32_t nameIndex;
+    uint32_t shaderRef;
+    vector<uint32_t> extraDataRefs;
+};
+
+/**
+ * @brief One scan of one NIF. Anything the scanner cannot reproduce exactly throws runtime_error
+ */
+class NIFScan {
+private:
+    const vector<std::byte>& m_bytes;
+    uint32_t m_bsVersion = 0;
+    vector<string> m_strings;
+    vector<BlockKind> m_blockKinds;
+    vector<uint32_t> m_blockSizes;
+    vector<size_t> m_blockOffsets;
+    bool m_hasBillboardNodes = false;
+    size_t m_bytesRead = 0; /** Header and the parts of blocks that were decoded */
+
+    void readHeader()
+    {
+        NIFReader reader(m_bytes.data(), m_bytes.size());
+
+        if (!reader.readLine().starts_with(NIF_HEADER_PREFIX)) {
+            throw runtime_error("Not a NIF file");
+        }
+
+        if (reader.read<uint32_t>() != NIF_VERSION_SKYRIM || reader.read<uint8_t>() != NIF_LITTLE_ENDIAN
+            || reader.read<uint32_t>() != NIF_USER_VERSION_SKYRIM) {
+            throw runtime_error("NIF version is not supported by the scanner");
+        }
+
+        const auto numBlocks = reader.read<uint32_t>();
+
+        m_bsVersion = reader.read<uint32_t>();
+        if (m_bsVersion != BS_VERSION_SKYRIM_LE && m_bsVersion != BS_VERSION_SKYRIM_SE) {
+            throw runtime_error("NIF version is not supported by the scanner");
+        }
+
+        for (size_t i = 0; i < NUM_EXPORT_STRINGS; i++) {
+            reader.skip(reader.read<uint8_t>());
+        }
+
+        // block types
+        const auto numBlockTypes = reader.read<uint16_t>();
+        vector<BlockKind> typeKinds;
+        vector<bool> typeIsBillboard;
+        typeKinds.reserve(numBlockTypes);
+        typeIsBillboard.reserve(numBlockTypes);
+        for (uint16_t i = 0; i < numBlockTypes; i++) {
+            const auto typeName = reader.readNiString();
+            typeKinds.push_back(getBlockKind(typeName, m_bsVersion));
+            typeIsBillboard.push_back(typeName == BILLBOARD_NODE_NAME);
+        }
+
+        // block type index and size of each block
+        if (numBlocks > reader.getRemaining() / (sizeof(uint16_t) + sizeof(uint32_t))) {
+            throw runtime_error("Unexpected end of NIF data");
+        }
+
+        m_blockKinds.reserve(numBlocks);
+        for (uint32_t i = 0; i < numBlocks; i++) {
+            const auto typeIndex = static_cast<uint16_t>(reader.read<uint16_t>() & BLOCK_TYPE_INDEX_MASK);
+            if (typeIndex >= typeKinds.size()) {
+                throw runtime_error("Invalid block type index");
+            }
+
+            if (typeKinds[typeIndex] == BlockKind::UNKNOWN) {
+                throw runtime_error("NIF contains a block type the scanner does not know");
+            }
+
+            m_blockKinds.push_back(typeKinds[typeIndex]);
+            m_hasBillboardNodes = m_hasBillboardNodes || typeIsBillboard[typeIndex];
+        }
+
+        m_blockSizes.reserve(numBlocks);
+        for (uint32_t i = 0; i < numBlocks; i++) {
+            m_blockSizes.push_back(reader.read<uint32_t>());
+        }
+
+        // string table
+        const auto numStrings = reader.read<uint32_t>();
+        reader.skip(sizeof(uint32_t)); // max string length
+        if (numStrings > reader.getRemaining() / sizeof(uint32_t)) {
+            throw runtime_error("Unexpected end of NIF data");
+        }
+
+        m_strings.reserve(numStrings);
+        for (uint32_t i = 0; i < numStrings; i++) {
+            m_strings.push_back(reader.readNiString());
+        }
+
+        // groups
+        reader.skip(static_cast<size_t>(reader.read<uint32_t>()) * sizeof(uint32_t));
+
+        // the blocks have to fill the file up to the footer exactly, otherwise the size table cannot be trusted
+        size_t offset = reader.getPos();
+        m_blockOffsets.reserve(numBlocks);
+        for (const auto blockSize : m_blockSizes) {
+            m_blockOffsets.push_back(offset);
+            offset += blockSize;
+            if (offset > m_bytes.size()) {
+                throw runtime_error("Block sizes exceed the NIF file");
+            }
+        }
+
+        NIFReader footer(m_bytes.data() + offset, // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                         m_bytes.size() - offset);
+        footer.skip(static_cast<size_t>(footer.read<uint32_t>()) * sizeof(uint32_t));
+        if (footer.getRemaining() != 0) {
+            throw runtime_error("Block sizes do not match the NIF file");
+        }
+
+        m_bytesRead = reader.getPos() + footer.getPos();
+    }
+
+    [[nodiscard]] auto getNumBlocks() const -> uint32_t { return static_cast<uint32_t>(m_blockKinds.size()); }
+
+    [[nodiscard]] auto getKind(uint32_t block) const -> BlockKind
+    {
+        return block < getNumBlocks() ? m_blockKinds[block] : BlockKind::UNKNOWN;
+    }
+
+    [[nodiscard]] auto getString(uint32_t index) const -> string_view
+    {
+        return index < m_strings.size() ? string_view(m_strings[index]) : string_view();
+    }
+
+    auto getBlockReader(uint32_t block) const -> NIFReader
+    {
+        return {m_bytes.data() + m_blockOffsets[block], // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                m_blockSizes[block]};
+    }
+
+    /** Name, extra data and controller of NiObjectNET, returns the extra data refs and optionally the name index */
+    static auto readObjectNET(NIFReader& reader,
+                              uint32_t* nameIndex = nullptr) -> vector<uint32_t>
+    {
+        const auto name = reader.read<uint32_t>();
+        if (nameIndex != nullptr) {
+            *nameIndex = name;
+        }
+        auto extraDataRefs = reader.readRefs();
+        reader.skip(sizeof(uint32_t));
+        return extraDataRefs;
+    }
+
+    /** Flags, transform and collision of NiAVObject */
+    static void skipAVObject(NIFReader& reader)
+    {
+        reader.skip(NIAVOBJECT_FLAGS_SIZE + NIAVOBJECT_TRANSFORM_SIZE + sizeof(uint32_t));
+    }
+
+    auto readChildren(uint32_t node) -> vector<uint32_t>
+    {
+        auto reader = getBlockReader(node);
+        readObjectNET(reader);
+        skipAVObject(reader);
+        auto children = reader.readRefs();
+
+        m_bytesRead += reader.getPos();
+        return children;
+    }
+
+    auto readShape(uint32_t shape) -> Shape
+    {
+        auto reader = getBlockReader(shape);
+
+        Shape result {};
+        result.extraDataRefs = readObjectNET(reader, &result.nameIndex);
+        skipAVObject(reader);
+
+        if (m_blockKinds[shape] == BlockKind::TRISHAPE) {
+            // bounds and skin instance
+            reader.skip(NIBOUND_SIZE + sizeof(uint32_t));
+        } else {
+            // data, skin instance and material data
+            reader.skip(sizeof(uint32_t) + sizeof(uint32_t));
+            const auto numMaterials = static_cast<size_t>(reader.read<uint32_t>());
+            reader.skip((numMaterials * 2 * sizeof(uint32_t)) + sizeof(uint32_t) + sizeof(uint8_t));
+        }
+
+        result.shaderRef = reader.read<uint32_t>();
+
+        m_bytesRead += reader.getPos();
+        return result;
+    }
+
+    auto readLightingShader(uint32_t shader) -> LightingShader
+    {
+        auto reader = getBlockReader(shader);
+
+        LightingShader result {};
+        result.shaderType = reader.read<uint32_t>(); // stored before NiObjectNET
+        result.extraDataRefs = readObjectNET(reader);
+        result.shaderFlags1 = reader.read<uint32_t>();
+        result.shaderFlags2 = reader.read<uint32_t>();
+        reader.skip(SHADER_UV_SIZE);
+        result.textureSetRef = reader.read<uint32_t>();
+        reader.skip(LIGHTING_SHADER_PARAMS_SIZE);
+        result.softLighting = reader.read<float>();
+
+        m_bytesRead += reader.getPos();
+        return result;
+    }
+
+    /** Effect shaders are never patched, their textures only go through the load checks */
+    void checkEffectShader(uint32_t shader)
+    {
+        auto reader = getBlockReader(shader);
+        readObjectNET(reader);
+        reader.skip(sizeof(uint32_t) + sizeof(uint32_t) + SHADER_UV_SIZE);
+
+        const auto sourceTexture = reader.readNiString();
+        reader.skip(EFFECT_SHADER_PARAMS_SIZE);
+        const auto greyscaleTexture = reader.readNiString();
+        m_bytesRead += reader.getPos();
+
+        if (!StringUtil::containsOnlyAscii(sourceTexture) || !StringUtil::containsOnlyAscii(greyscaleTexture)) {
+            throw runtime_error("NIF contains non-ascii characters in texture slot(s)");
+        }
+    }
+
+    auto readTextureSet(uint32_t textureSet,
+                        uint32_t& numTextures) -> vector<string>
+    {
+        auto reader = getBlockReader(textureSet);
+
+        numTextures = reader.read<uint32_t>();
+        vector<string> textures;
+        for (uint32_t i = 0; i < numTextures && i < NUM_TEXTURE_SLOTS; i++) {
+            textures.push_back(reader.readNiString());
+        }
+
+        m_bytesRead += reader.getPos();
+        return textures;
+    }
+
+    auto hasIgnoreFlag(const vector<uint32_t>& extraDataRefs) -> bool
+    {
+        for (const auto extraDataRef : extraDataRefs) {
+            if (getKind(extraDataRef) != BlockKind::BOOLEAN_EXTRA_DATA) {
+                continue;
+            }
+
+            auto reader = getBlockReader(extraDataRef);
+            const auto name = getString(reader.read<uint32_t>());
+            const auto value = reader.read<uint8_t>();
+            m_bytesRead += reader.getPos();
+
+            if (name == PG_IGNORE_NAME && value != 0) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /** Shapes reached through node child lists from the root, each one has to be reached exactly once */
+    auto getShapeBlocks() -> vector<uint32_t>
+    {
+        if (getNumBlocks() == 0 || m_blockKinds[0] != BlockKind::NODE) {
+            throw runtime_error("First block is not a node");
+        }
+
+        vector<uint32_t> shapes;
+        vector<bool> reached(getNumBlocks(), false);
+        reached[0] = true;
+
+        vector<uint32_t> nodes = {0};
+        while (!nodes.empty()) {
+            const auto node = nodes.back();
+            nodes.pop_back();
+
+            for (const auto child : readChildren(node)) {
+                if (child >= getNumBlocks()) {
+                    // empty or dangling reference, nifly skips these too
+                    continue;
+                }
+
+                if (reached[child]) {
+                    throw runtime_error("Block is referenced more than once");
+                }
+                reached[child] = true;
+
+                const auto kind = m_blockKinds[child];
+                if (kind == BlockKind::NODE) {
+                    nodes.push_back(child);
+                } else if (kind == BlockKind::TRISHAPE || kind == BlockKind::GEOMETRY) {
+                    shapes.push_back(child);
+                }
+            }
+        }
+
+        for (uint32_t block = 0; block < getNumBlocks(); block++) {
+            const auto kind = m_blockKinds[block];
+            if ((kind == BlockKind::TRISHAPE || kind == BlockKind::GEOMETRY) && !reached[block]) {
+                throw runtime_error("Shape is not reached from the root node");
+            }
+        }
+
+        return shapes;
+    }
+
+public:
+    explicit NIFScan(const vector<std::byte>& bytes)
+        : m_bytes(bytes)
+    {
+        readHeader();
+    }
+
+    auto getShaderShapes() -> PGNIFScanner::MeshShapes
+    {
+        PGNIFScanner::MeshShapes result;
+        result.hasBillboardNodes = m_hasBillboardNodes;
+
+        for (const auto shapeBlock : getShapeBlocks()) {
+            const auto shape = readShape(shapeBlock);
+
+            switch (getKind(shape.shaderRef)) {
+            case BlockKind::LIGHTING_SHADER:
+                break;
+            case BlockKind::EFFECT_SHADER:
+                checkEffectShader(shape.shaderRef);
+                result.otherShapes.push_back({.blockID = shapeBlock, .name = string(getString(shape.nameIndex))});
+                continue;
+            default:
+                if (shape.shaderRef >= getNumBlocks()) {
+                    // no shader
+                    continue;
+                }
+                throw runtime_error("Shape has a shader the scanner does not read");
+            }
+
+            const auto shader = readLightingShader(shape.shaderRef);
+            PGNIFScanner::ShaderShape shaderShape {.shaderType = shader.shaderType,
+                                                   .shaderFlags1 = shader.shaderFlags1,
+                                                   .shaderFlags2 = shader.shaderFlags2,
+                                                   .softLighting = shader.softLighting,
+                                                   .numTextures = 0,
+                                                   .shaderPatchable = false,
+                                                   .textureSet = {},
+                                                   .blockID = shapeBlock,
+                                                   .name = string(getString(shape.nameIndex))};
+            if (shader.textureSetRef == NIF_NPOS) {
+                // no texture set, only the pre and post patchers look at this shape
+                result.shapes.push_back(shaderShape);
+                continue;
+            }
+
+            if (getKind(shader.textureSetRef) != BlockKind::TEXTURE_SET) {
+                // out of range or another block type, left to the checks of nifly
+                throw runtime_error("NIF contains reference to texture set that does not exist");
+            }
+
+            auto textures = readTextureSet(shader.textureSetRef, shaderShape.numTextures);
+
+            for (size_t slot = 0; slot < textures.size(); slot++) {
+                auto& texture = textures[slot];
+                if (!StringUtil::containsOnlyAscii(texture)) {
+                    throw runtime_error("NIF contains non-ascii characters in texture slot(s)");
+                }
+
+                StringUtil::toLowerASCIIFastInPlace(texture);
+                if (!texture.empty()) {
+                    shaderShape.textureSet.at(slot) = PGTypes::internTexturePath(StringUtil::asciitoUTF16(texture));
+                }
+            }
+
+            shaderShape.shaderPatchable = !hasIgnoreFlag(shader.extraDataRefs) && !hasIgnoreFlag(shape.extraDataRefs);
+            result.shapes.push_back(shaderShape);
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] auto getBytesSkipped() const -> size_t { return m_bytes.size() - min(m_bytesRead, m_bytes.size()); }
+};
+}
+
+auto PGNIFScanner::ShaderShape::hasShaderFlag(nifly::SkyrimShaderPropertyFlags1 flag) const -> bool
+{
+    return (shaderFlags1 & flag) != 0U;
+}
+
+auto PGNIFScanner::ShaderShape::hasShaderFlag(nifly::SkyrimShaderPropertyFlags2 flag) const -> bool
+{
+    return (shaderFlags2 & flag) != 0U;
+}
+
+auto PGNIFScanner::scan(const vector<std::byte>& nifBytes) -> optional<MeshShapes>
+{
+    try {
+        NIFScan nifScan(nifBytes);
+        auto shapes = nifScan.getShaderShapes();
+
+        s_scanned++;
+        s_bytesSkipped += nifScan.getBytesSkipped();
+        return shapes;
+    } catch (const exception& e) {
+        Logger::trace("NIF scanner falling back to nifly: {}", e.what());
+        s_fallbacks++;
+        return nullopt;
+    }
+}
+
+auto PGNIFScanner::getShaderShapes(nifly::NifFile& nif) -> MeshShapes
+{
+    MeshShapes result;
+
+    const auto& header = nif.GetHeader();
+    for (uint32_t blockID = 0; blockID < header.GetNumBlocks(); blockID++) {
+        if (header.GetBlock<nifly::NiBillboardNode>(blockID) != nullptr) {
+            result.hasBillboardNodes = true;
+            break;
+        }
+    }
+
+    const auto shapes = PGNIFUtil::getShapesWith3DIdx(&nif);
+    for (const auto& [shape, oldindex3d] : shapes) {
+        if (shape == nullptr) {
+            // Skip if shape is null (invalid shapes)
+            continue;
+        }
+
+        if (!PGNIFUtil::isPatchableShape(nif, *shape)) {
+            continue;
+        }
+
+        auto* const shaderBSLSP = dynamic_cast<nifly::BSLightingShaderProperty*>(nif.GetShader(shape));
+        if (shaderBSLSP == nullptr) {
+            // Not a BSLightingShaderProperty, no patcher changes it
+            result.otherShapes.push_back({.blockID = nif.GetBlockID(shape), .name = shape->name.get()});
+            continue;
+        }
+
+        ShaderShape shaderShape {.shaderType = shaderBSLSP->GetShaderType(),
+                                 .shaderFlags1 = shaderBSLSP->shaderFlags1,
+                                 .shaderFlags2 = shaderBSLSP->shaderFlags2,
+                                 .softLighting = shaderBSLSP->softlighting,
+                                 .numTextures = 0,
+                                 .shaderPatchable = PGNIFUtil::isShaderPatchableShape(nif, *shape),
+                                 .textureSet = {},
+                                 .blockID = nif.GetBlockID(shape),
+                                 .name = shape->name.get()};
+
+        const auto* const textureSet = header.GetBlock(shaderBSLSP->TextureSetRef());
+        if (textureSet != nullptr) {
+            shaderShape.numTextures = static_cast<uint32_t>(textureSet->textures.size());
+
+            const auto slots = PGNIFUtil::getTextureSlots(&nif, shape);
+            for (size_t slot = 0; slot < NUM_TEXTURE_SLOTS; slot++) {
+                if (!slots.at(slot).empty()) {
+                    shaderShape.textureSet.at(slot) = PGTypes::internTexturePath(slots.at(slot));
+                }
+            }
+        }
+
+        result.shapes.push_back(shaderShape);
+    }
+
+    return result;
+}
+
+auto PGNIFScanner::getStats() -> Stats
+{
+    return {.scanned = s_scanned.load(), .fallbacks = s_fallbacks.load(), .bytesSkipped = s_bytesSkipped.load()};
+}
+
+void PGNIFScanner::logStats()
+{
+    const auto stats = getStats();
+    Logger::debug("NIF scanner: {} meshes scanned, {} loaded with nifly, {:.1f} MiB of unneeded blocks skipped",
+                  stats.scanned,
+                  stats.fallbacks,
+                  static_cast<double>(stats.bytesSkipped) / BYTES_PER_MIB);
+}
@@ -1,17 +1,29 @@
 #include "pgutil/PGTypes.hpp"
 
+#include "util/StringInterner.hpp"
 #include "util/StringUtil.hpp"
 
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 using namespace std;
 
 namespace PGTypes {
+namespace {
+auto getTexturePathInterner() -> StringInterner<wchar_t, uint32_t>&
+{
+    static StringInterner<wchar_t, uint32_t> interner;
+    return interner;
+}
+}
+
 auto getTextureSlotsFromStr(const string& slots) -> TextureSet
 {
     TextureSet textureSlots;
@@ -36,4 +48,23 @@ auto getStrFromTextureSlots(const TextureSet& slots) -> string
     }
     return strSlots;
 }
+
+auto internTexturePath(wstring_view path) -> uint32_t { return getTexturePathInterner().intern(path); }
+
+auto resolveTextureSet(const TextureSetIDs& ids) -> TextureSet
+{
+    auto& interner = getTexturePathInterner();
+
+    TextureSet slots;
+    for (size_t i = 0; i < NUM_TEXTURE_SLOTS; ++i) {
+        slots.at(i) = interner.get(ids.at(i));
+    }
+    return slots;
+}
+
+auto getTexturePathInternerStats() -> pair<size_t, size_t>
+{
+    const auto& interner = getTexturePathInterner();
+    return {interner.size(), interner.getBytes()};
+}
 }
@@ -0,0 +1,543 @@
+#include "util/BCEncoder.hpp"
+
+#include <DirectXTex.h>
+#include <dxgiformat.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <execution>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <winerror.h>
+#include <winnt.h>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define PG_BCENCODER_SSE2
+#endif
+
+using namespace std;
+
+namespace {
+
+constexpr size_t BLOCK_DIM = 4;
+constexpr size_t BLOCK_PIXELS = BLOCK_DIM * BLOCK_DIM;
+constexpr size_t NUM_CHANNELS = 4;
+constexpr size_t BC1_BLOCK_SIZE = 8;
+constexpr size_t BC23_BLOCK_SIZE = 16;
+constexpr int ALPHA_THRESHOLD = 128;
+constexpr int POWER_ITERATIONS = 4;
+
+using Block = array<uint8_t, BLOCK_PIXELS * NUM_CHANNELS>; // RGBA, row major
+using Color = array<int, 3>;
+using ColorIndices = array<uint8_t, BLOCK_PIXELS>;
+
+auto getBlockSize(const DXGI_FORMAT& format) -> size_t
+{
+    return format == DXGI_FORMAT_BC1_UNORM || format == DXGI_FORMAT_BC1_UNORM_SRGB ? BC1_BLOCK_SIZE : BC23_BLOCK_SIZE;
+}
+
+/// @brief Copy a 4x4 block of RGBA pixels, replicating edge pixels for partial blocks
+void fetchBlock(const DirectX::Image& image,
+                const size_t& blockX,
+                const size_t& blockY,
+                Block& block)
+{
+    for (size_t y = 0; y < BLOCK_DIM; y++) {
+        const size_t srcY = min((blockY * BLOCK_DIM) + y, image.height - 1);
+        const uint8_t* row = image.pixels + (srcY * image.rowPitch);
+        for (size_t x = 0; x < BLOCK_DIM; x++) {
+            const size_t srcX = min((blockX * BLOCK_DIM) + x, image.width - 1);
+            memcpy(&block.at(((y * BLOCK_DIM) + x) * NUM_CHANNELS), row + (srcX * NUM_CHANNELS), NUM_CHANNELS);
+        }
+    }
+}
+
+/// @brief Per channel min/max of a block
+void getBounds(const Block& block,
+               array<uint8_t, NUM_CHANNELS>& minColor,
+               array<uint8_t, NUM_CHANNELS>& maxColor)
+{
+#ifdef PG_BCENCODER_SSE2
+    // 4 pixels per register, reduce the 4 registers and then the 4 lanes
+    __m128i curMin = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block.data())); // NOLINT
+    __m128i curMax = curMin;
+    for (size_t i = 1; i < NUM_CHANNELS; i++) {
+        const __m128i curPixels
+            = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block.data() + (i * 16))); // NOLINT
+        curMin = _mm_min_epu8(curMin, curPixels);
+        curMax = _mm_max_epu8(curMax, curPixels);
+    }
+    curMin = _mm_min_epu8(curMin, _mm_shuffle_epi32(curMin, _MM_SHUFFLE(1, 0, 3, 2)));
+    curMin = _mm_min_epu8(curMin, _mm_shuffle_epi32(curMin, _MM_SHUFFLE(2, 3, 0, 1)));
+    curMax = _mm_max_epu8(curMax, _mm_shuffle_epi32(curMax, _MM_SHUFFLE(1, 0, 3, 2)));
+    curMax = _mm_max_epu8(curMax, _mm_shuffle_epi32(curMax, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    const auto minPacked = static_cast<uint32_t>(_mm_cvtsi128_si32(curMin));
+    const auto maxPacked = static_cast<uint32_t>(_mm_cvtsi128_si32(curMax));
+    memcpy(minColor.data(), &minPacked, NUM_CHANNELS);
+    memcpy(maxColor.data(), &maxPacked, NUM_CHANNELS);
+#else
+    minColor.fill(numeric_limits<uint8_t>::max());
+    maxColor.fill(0);
+    for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+        for (size_t c = 0; c < NUM_CHANNELS; c++) {
+            minColor.at(c) = min(minColor.at(c), block.at((i * NUM_CHANNELS) + c));
+            maxColor.at(c) = max(maxColor.at(c), block.at((i * NUM_CHANNELS) + c));
+        }
+    }
+#endif
+}
+
+auto to565(const Color& color) -> uint16_t
+{
+    static constexpr int MAX_5 = 31;
+    static constexpr int MAX_6 = 63;
+    static constexpr int MAX_8 = 255;
+
+    const auto quantize = [](int value, int maxOut) -> unsigned {
+        value = clamp(value, 0, MAX_8);
+        return static_cast<unsigned>(((value * maxOut) + (MAX_8 / 2)) / MAX_8);
+    };
+
+    return static_cast<uint16_t>((quantize(color[0], MAX_5) << 11U) | (quantize(color[1], MAX_6) << 5U)
+                                 | quantize(color[2], MAX_5));
+}
+
+auto from565(const uint16_t& packed) -> Color
+{
+    const unsigned r = (packed >> 11U) & 0x1FU;
+    const unsigned g = (packed >> 5U) & 0x3FU;
+    const unsigned b = packed & 0x1FU;
+    return {static_cast<int>((r << 3U) | (r >> 2U)),
+            static_cast<int>((g << 2U) | (g >> 4U)),
+            static_cast<int>((b << 3U) | (b >> 2U))};
+}
+
+auto getPixel(const Block& block,
+              const size_t& idx) -> Color
+{
+    return {block.at(idx * NUM_CHANNELS), block.at((idx * NUM_CHANNELS) + 1), block.at((idx * NUM_CHANNELS) + 2)};
+}
+
+auto colorDistance(const Color& a,
+                   const Color& b) -> int
+{
+    const int dr = a[0] - b[0];
+    const int dg = a[1] - b[1];
+    const int db = a[2] - b[2];
+    return (dr * dr) + (dg * dg) + (db * db);
+}
+
+/// @brief Endpoints along the principal axis of the block colors (only pixels in mask are considered)
+void getPrincipalEndpoints(const Block& block,
+                           const array<bool, BLOCK_PIXELS>& mask,
+                           const array<uint8_t, NUM_CHANNELS>& minColor,
+                           const array<uint8_t, NUM_CHANNELS>& maxColor,
+                           Color& endpoint0,
+                           Color& endpoint1)
+{
+    array<float, 3> mean {};
+    size_t count = 0;
+    for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+        if (!mask.at(i)) {
+            continue;
+        }
+        const auto pixel = getPixel(block, i);
+        for (size_t c = 0; c < 3; c++) {
+            mean.at(c) += static_cast<float>(pixel.at(c));
+        }
+        count++;
+    }
+    for (auto& m : mean) {
+        m /= static_cast<float>(count);
+    }
+
+    // covariance matrix (rr, rg, rb, gg, gb, bb)
+    array<float, 6> cov {};
+    for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+        if (!mask.at(i)) {
+            continue;
+        }
+        const auto pixel = getPixel(block, i);
+        const float r = static_cast<float>(pixel[0]) - mean[0];
+        const float g = static_cast<float>(pixel[1]) - mean[1];
+        const float b = static_cast<float>(pixel[2]) - mean[2];
+        cov[0] += r * r;
+        cov[1] += r * g;
+        cov[2] += r * b;
+        cov[3] += g * g;
+        cov[4] += g * b;
+        cov[5] += b * b;
+    }
+
+    // power iteration starting at the bounding box diagonal
+    array<float, 3> axis = {static_cast<float>(maxColor[0] - minColor[0]),
+                            static_cast<float>(maxColor[1] - minColor[1]),
+                            static_cast<float>(maxColor[2] - minColor[2])};
+    for (int iter = 0; iter < POWER_ITERATIONS; iter++) {
+        const array<float, 3> next = {(axis[0] * cov[0]) + (axis[1] * cov[1]) + (axis[2] * cov[2]),
+                                      (axis[0] * cov[1]) + (axis[1] * cov[3]) + (axis[2] * cov[4]),
+                                      (axis[0] * cov[2]) + (axis[1] * cov[4]) + (axis[2] * cov[5])};
+        const float len = max({fabs(next[0]), fabs(next[1]), fabs(next[2])});
+        if (len < numeric_limits<float>::epsilon()) {
+            break;
+        }
+        axis = {next[0] / len, next[1] / len, next[2] / len};
+    }
+
+    float minProj = numeric_limits<float>::max();
+    float maxProj = numeric_limits<float>::lowest();
+    for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+        if (!mask.at(i)) {
+            continue;
+        }
+        const auto pixel = getPixel(block, i);
+        const float proj = (static_cast<float>(pixel[0]) * axis[0]) + (static_cast<float>(pixel[1]) * axis[1])
+            + (static_cast<float>(pixel[2]) * axis[2]);
+        if (proj < minProj) {
+            minProj = proj;
+            endpoint1 = pixel;
+        }
+        if (proj > maxProj) {
+            maxProj = proj;
+            endpoint0 = pixel;
+        }
+    }
+}
+
+/// @brief Pick the closest palette entry for each pixel, returns the total squared error
+auto selectIndices(const Block& block,
+                   const array<bool, BLOCK_PIXELS>& mask,
+                   const array<Color, 4>& palette,
+                   const size_t& paletteSize,
+                   ColorIndices& indices) -> int
+{
+    int totalError = 0;
+    for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+        if (!mask.at(i)) {
+            continue;
+        }
+
+        const auto pixel = getPixel(block, i);
+        int bestError = numeric_limits<int>::max();
+        for (size_t p = 0; p < paletteSize; p++) {
+            const int curError = colorDistance(pixel, palette.at(p));
+            if (curError < bestError) {
+                bestError = curError;
+                indices.at(i) = static_cast<uint8_t>(p);
+            }
+        }
+        totalError += bestError;
+    }
+
+    return totalError;
+}
+
+/// @brief Least squares fit of the endpoints for fixed 4 color mode indices
+auto refineEndpoints(const Block& block,
+                     const ColorIndices& indices,
+                     Color& endpoint0,
+                     Color& endpoint1) -> bool
+{
+    static constexpr array<float, 4> WEIGHTS0 = {1.0F, 0.0F, 2.0F / 3.0F, 1.0F / 3.0F};
+
+    float aa = 0.0F;
+    float ab = 0.0F;
+    float bb = 0.0F;
+    array<float, 3> ax {};
+    array<float, 3> bx {};
+    for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+        const float a = WEIGHTS0.at(indices.at(i));
+        const float b = 1.0F - a;
+        const auto pixel = getPixel(block, i);
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (size_t c = 0; c < 3; c++) {
+            ax.at(c) += a * static_cast<float>(pixel.at(c));
+            bx.at(c) += b * static_cast<float>(pixel.at(c));
+        }
+    }
+
+    const float det = (aa * bb) - (ab * ab);
+    if (fabs(det) < numeric_limits<float>::epsilon()) {
+        return false;
+    }
+
+    for (size_t c = 0; c < 3; c++) {
+        endpoint0.at(c) = static_cast<int>(lround(((ax.at(c) * bb) - (bx.at(c) * ab)) / det));
+        endpoint1.at(c) = static_cast<int>(lround(((bx.at(c) * aa) - (ax.at(c) * ab)) / det));
+    }
+
+    return true;
+}
+
+auto packIndices(const ColorIndices& indices) -> uint32_t
+{
+    uint32_t packed = 0;
+    for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+        packed |= static_cast<uint32_t>(indices.at(i)) << (i * 2);
+    }
+    return packed;
+}
+
+/// @brief Builds the palette for two quantized endpoints and selects indices
+auto fitColorEndpoints(const Block& block,
+                       const array<bool, BLOCK_PIXELS>& mask,
+                       const bool& threeColorMode,
+                       uint16_t& c0,
+                       uint16_t& c1,
+                       ColorIndices& indices) -> int
+{
+    // 4 color mode requires c0 > c1, 3 color mode requires c0 <= c1
+    if ((!threeColorMode && c0 < c1) || (threeColorMode && c0 > c1)) {
+        swap(c0, c1);
+    }
+
+    const auto col0 = from565(c0);
+    const auto col1 = from565(c1);
+    array<Color, 4> palette {col0, col1, {}, {}};
+    size_t paletteSize = 4;
+    if (threeColorMode) {
+        for (size_t c = 0; c < 3; c++) {
+            palette[2].at(c) = (col0.at(c) + col1.at(c)) / 2;
+        }
+        paletteSize = 3;
+    } else {
+        for (size_t c = 0; c < 3; c++) {
+            palette[2].at(c) = ((2 * col0.at(c)) + col1.at(c)) / 3;
+            palette[3].at(c) = (col0.at(c) + (2 * col1.at(c))) / 3;
+        }
+    }
+
+    if (c0 == c1 && !threeColorMode) {
+        // solid block, only index 0 is well defined
+        paletteSize = 1;
+    }
+
+    return selectIndices(block, mask, palette, paletteSize, indices);
+}
+
+/// @brief Encodes the 8 byte color part of a BC1/BC2/BC3 block
+void encodeColorBlock(const Block& block,
+                      const BCEncoder::Quality& quality,
+                      const bool& allowPunchThrough,
+                      uint8_t* out)
+{
+    array<bool, BLOCK_PIXELS> mask {};
+    bool hasTransparent = false;
+    for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+        mask.at(i) = !allowPunchThrough || block.at((i * NUM_CHANNELS) + 3) >= ALPHA_THRESHOLD;
+        hasTransparent = hasTransparent || !mask.at(i);
+    }
+
+    ColorIndices indices {};
+    uint16_t c0 = 0;
+    uint16_t c1 = 0;
+
+    if (hasTransparent && ranges::none_of(mask, [](bool opaque) -> bool { return opaque; })) {
+        // fully transparent block
+        indices.fill(3);
+    } else {
+        array<uint8_t, NUM_CHANNELS> minColor {};
+        array<uint8_t, NUM_CHANNELS> maxColor {};
+        getBounds(block, minColor, maxColor);
+
+        Color endpoint0 {};
+        Color endpoint1 {};
+        if (quality == BCEncoder::Quality::FAST && !hasTransparent) {
+            // inset the bounding box by 1/16th to reduce error at the extremes
+            for (size_t c = 0; c < 3; c++) {
+                const int inset = (maxColor.at(c) - minColor.at(c)) / 16;
+                endpoint0.at(c) = maxColor.at(c) - inset;
+                endpoint1.at(c) = minColor.at(c) + inset;
+            }
+        } else {
+            getPrincipalEndpoints(block, mask, minColor, maxColor, endpoint0, endpoint1);
+        }
+
+        c0 = to565(endpoint0);
+        c1 = to565(endpoint1);
+        int error = fitColorEndpoints(block, mask, hasTransparent, c0, c1, indices);
+
+        if (quality != BCEncoder::Quality::FAST && !hasTransparent && error > 0
+            && refineEndpoints(block, indices, endpoint0, endpoint1)) {
+            // keep refined endpoints only if they reduce the error
+            uint16_t refined0 = to565(endpoint0);
+            uint16_t refined1 = to565(endpoint1);
+            ColorIndices refinedIndices {};
+            const int refinedError = fitColorEndpoints(block, mask, false, refined0, refined1, refinedIndices);
+            if (refinedError < error) {
+                c0 = refined0;
+                c1 = refined1;
+                indices = refinedIndices;
+                error = refinedError;
+            }
+        }
+
+        for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+            if (!mask.at(i)) {
+                indices.at(i) = 3;
+            }
+        }
+    }
+
+    const uint32_t packedIndices = packIndices(indices);
+    memcpy(out, &c0, sizeof(c0));
+    memcpy(out + 2, &c1, sizeof(c1));
+    memcpy(out + 4, &packedIndices, sizeof(packedIndices));
+}
+
+/// @brief Encodes the 8 byte explicit alpha part of a BC2 block
+void encodeAlphaBC2(const Block& block,
+                    uint8_t* out)
+{
+    static constexpr unsigned MAX_4 = 15;
+    static constexpr unsigned MAX_8 = 255;
+
+    uint64_t packed = 0;
+    for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+        const unsigned alpha = block.at((i * NUM_CHANNELS) + 3);
+        packed |= static_cast<uint64_t>(((alpha * MAX_4) + (MAX_8 / 2)) / MAX_8) << (i * 4);
+    }
+    memcpy(out, &packed, sizeof(packed));
+}
+
+/// @brief Encodes the 8 byte interpolated alpha part of a BC3 block
+void encodeAlphaBC3(const Block& block,
+                    uint8_t* out)
+{
+    static constexpr int NUM_STEPS = 7;
+
+    int alphaMin = numeric_limits<uint8_t>::max();
+    int alphaMax = 0;
+    for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+        const int alpha = block.at((i * NUM_CHANNELS) + 3);
+        alphaMin = min(alphaMin, alpha);
+        alphaMax = max(alphaMax, alpha);
+    }
+
+    uint64_t packed = static_cast<uint64_t>(alphaMax) | (static_cast<uint64_t>(alphaMin) << 8U);
+    if (alphaMax != alphaMin) {
+        // 8 alpha mode: index 0 = max, 1 = min, 2-7 interpolate from max to min
+        const int range = alphaMax - alphaMin;
+        for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+            const int alpha = block.at((i * NUM_CHANNELS) + 3);
+            const int step = (((alpha - alphaMin) * NUM_STEPS) + (range / 2)) / range;
+            uint64_t index = 0;
+            if (step == 0) {
+                index = 1;
+            } else if (step < NUM_STEPS) {
+                index = static_cast<uint64_t>(NUM_STEPS + 1 - step);
+            }
+            packed |= index << (16 + (i * 3));
+        }
+    }
+
+    memcpy(out, &packed, sizeof(packed));
+}
+
+void encodeBlockRow(const DirectX::Image& src,
+                    const DirectX::Image& dst,
+                    const size_t& blockRow,
+                    const BCEncoder::Quality& quality)
+{
+    const size_t blockSize = getBlockSize(dst.format);
+    const size_t blocksWide = max<size_t>(1, (src.width + BLOCK_DIM - 1) / BLOCK_DIM);
+    uint8_t* outRow = dst.pixels + (blockRow * dst.rowPitch);
+
+    Block block {};
+    for (size_t blockX = 0; blockX < blocksWide; blockX++) {
+        fetchBlock(src, blockX, blockRow, block);
+        uint8_t* outBlock = outRow + (blockX * blockSize);
+
+        switch (dst.format) {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+            encodeColorBlock(block, quality, true, outBlock);
+            break;
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:
+            encodeAlphaBC2(block, outBlock);
+            encodeColorBlock(block, quality, false, outBlock + BC1_BLOCK_SIZE);
+            break;
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+            encodeAlphaBC3(block, outBlock);
+            encodeColorBlock(block, quality, false, outBlock + BC1_BLOCK_SIZE);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+}
+
+namespace BCEncoder {
+
+auto isNativeFormat(const DXGI_FORMAT& format) -> bool
+{
+    switch (format) {
+    case DXGI_FORMAT_BC1_UNORM:
+    case DXGI_FORMAT_BC1_UNORM_SRGB:
+    case DXGI_FORMAT_BC2_UNORM:
+    case DXGI_FORMAT_BC2_UNORM_SRGB:
+    case DXGI_FORMAT_BC3_UNORM:
+    case DXGI_FORMAT_BC3_UNORM_SRGB:
+        return true;
+    default:
+        return false;
+    }
+}
+
+auto compress(const DirectX::ScratchImage& source,
+              const DXGI_FORMAT& format,
+              const Quality& quality,
+              DirectX::ScratchImage& out) -> HRESULT
+{
+    const auto& srcMeta = source.GetMetadata();
+
+    if (quality == Quality::REFERENCE || !isNativeFormat(format) || srcMeta.format != DXGI_FORMAT_R8G8B8A8_UNORM
+        || srcMeta.IsVolumemap()) {
+        auto flags = DirectX::TEX_COMPRESS_PARALLEL;
+        if (quality == Quality::FAST) {
+            flags |= DirectX::TEX_COMPRESS_BC7_QUICK;
+        }
+
+        return DirectX::Compress(
+            source.GetImages(), source.GetImageCount(), srcMeta, format, flags, DirectX::TEX_THRESHOLD_DEFAULT, out);
+    }
+
+    auto dstMeta = srcMeta;
+    dstMeta.format = format;
+    const HRESULT hr = out.Initialize(dstMeta);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    // flatten every block row of every image (mips and array slices) into one parallel job list
+    const auto* const srcImages = source.GetImages();
+    const auto* const dstImages = out.GetImages();
+    vector<pair<size_t, size_t>> blockRows;
+    for (size_t imageIdx = 0; imageIdx < source.GetImageCount(); imageIdx++) {
+        const size_t blocksHigh = max<size_t>(1, (srcImages[imageIdx].height + BLOCK_DIM - 1) / BLOCK_DIM);
+        for (size_t blockRow = 0; blockRow < blocksHigh; blockRow++) {
+            blockRows.emplace_back(imageIdx, blockRow);
+        }
+    }
+
+    for_each(execution::par, blockRows.begin(), blockRows.end(), [&](const pair<size_t, size_t>& job) -> void {
+        encodeBlockRow(srcImages[job.first], dstImages[job.first], job.second, quality);
+    });
+
+    return S_OK;
+}
+
+}
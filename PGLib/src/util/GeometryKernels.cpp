@@ -0,0 +1,642 @@
+#include "util/GeometryKernels.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#include <emmintrin.h>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#define PG_GEOMETRY_X64
+#endif
+
+#ifdef _MSC_VER
+#define PG_GEOMETRY_INLINE __forceinline
+#define PG_GEOMETRY_TARGET_AVX2
+#else
+#define PG_GEOMETRY_INLINE __attribute__((always_inline)) inline
+#define PG_GEOMETRY_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+using namespace std;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers,cppcoreguidelines-pro-bounds-pointer-arithmetic,cppcoreguidelines-pro-type-reinterpret-cast)
+namespace {
+
+using GeometryKernels::HSLAdjust;
+using GeometryKernels::NUM_LANES;
+using GeometryKernels::TriangleEdgeBlock;
+using GeometryKernels::UVDensitySums;
+
+constexpr float CHANNEL_MAX = 255.0F;
+constexpr float ONE_THIRD = 1.0F / 3.0F;
+constexpr float ONE_SIXTH = 1.0F / 6.0F;
+constexpr float TWO_THIRDS = 2.0F / 3.0F;
+/** gil tests |min - max| < 0.001 in double, (float)0.001 lies above it so < on floats is the same test */
+constexpr float RGB_GRAY_EPSILON = 0.001F;
+/** gil tests |max - channel| < 0.0001F */
+constexpr float HUE_CHANNEL_EPSILON = 0.0001F;
+/** gil tests |S| < 0.0001 in double, (float)0.0001 lies below it so the same test on floats is <= */
+constexpr float HSL_GRAY_EPSILON = 0.0001F;
+
+//
+// Lane operations
+//
+
+#ifndef PG_GEOMETRY_X64
+/** One lane per vector, same results as the vector paths */
+struct ScalarOps {
+    using Vec = float;
+    using Mask = bool;
+    static constexpr size_t WIDTH = 1;
+
+    static auto load(const float* p) -> Vec { return *p; }
+    static void store(float* p,
+                      Vec v)
+    {
+        *p = v;
+    }
+    static auto set(float v) -> Vec { return v; }
+    static auto add(Vec a,
+                    Vec b) -> Vec
+    {
+        return a + b;
+    }
+    static auto sub(Vec a,
+                    Vec b) -> Vec
+    {
+        return a - b;
+    }
+    static auto mul(Vec a,
+                    Vec b) -> Vec
+    {
+        return a * b;
+    }
+    static auto div(Vec a,
+                    Vec b) -> Vec
+    {
+        return a / b;
+    }
+    static auto sqrt(Vec a) -> Vec { return std::sqrt(a); }
+    static auto abs(Vec a) -> Vec { return std::abs(a); }
+    static auto min(Vec a,
+                    Vec b) -> Vec
+    {
+        return b < a ? b : a;
+    }
+    static auto max(Vec a,
+                    Vec b) -> Vec
+    {
+        return a < b ? b : a;
+    }
+    static auto lt(Vec a,
+                   Vec b) -> Mask
+    {
+        return a < b;
+    }
+    static auto le(Vec a,
+                   Vec b) -> Mask
+    {
+        return a <= b;
+    }
+    static auto gt(Vec a,
+                   Vec b) -> Mask
+    {
+        return a > b;
+    }
+    static auto select(Mask m,
+                       Vec a,
+                       Vec b) -> Vec
+    {
+        return m ? a : b;
+    }
+    static auto loadU8(const uint8_t* p) -> Vec { return static_cast<float>(*p); }
+    static void storeU8(uint8_t* p,
+                        Vec v)
+    {
+        // truncate and saturate like the vector paths
+        *p = static_cast<uint8_t>(clamp(static_cast<int32_t>(v), 0, static_cast<int32_t>(CHANNEL_MAX)));
+    }
+};
+#endif
+
+#ifdef PG_GEOMETRY_X64
+struct SSE2Ops {
+    using Vec = __m128;
+    using Mask = __m128;
+    static constexpr size_t WIDTH = 4;
+
+    static auto load(const float* p) -> Vec { return _mm_loadu_ps(p); }
+    static void store(float* p,
+                      Vec v)
+    {
+        _mm_storeu_ps(p, v);
+    }
+    static auto set(float v) -> Vec { return _mm_set1_ps(v); }
+    static auto add(Vec a,
+                    Vec b) -> Vec
+    {
+        return _mm_add_ps(a, b);
+    }
+    static auto sub(Vec a,
+                    Vec b) -> Vec
+    {
+        return _mm_sub_ps(a, b);
+    }
+    static auto mul(Vec a,
+                    Vec b) -> Vec
+    {
+        return _mm_mul_ps(a, b);
+    }
+    static auto div(Vec a,
+                    Vec b) -> Vec
+    {
+        return _mm_div_ps(a, b);
+    }
+    static auto sqrt(Vec a) -> Vec { return _mm_sqrt_ps(a); }
+    static auto abs(Vec a) -> Vec { return _mm_andnot_ps(_mm_set1_ps(-0.0F), a); }
+    static auto min(Vec a,
+                    Vec b) -> Vec
+    {
+        return _mm_min_ps(a, b);
+    }
+    static auto max(Vec a,
+                    Vec b) -> Vec
+    {
+        return _mm_max_ps(a, b);
+    }
+    static auto lt(Vec a,
+                   Vec b) -> Mask
+    {
+        return _mm_cmplt_ps(a, b);
+    }
+    static auto le(Vec a,
+                   Vec b) -> Mask
+    {
+        return _mm_cmple_ps(a, b);
+    }
+    static auto gt(Vec a,
+                   Vec b) -> Mask
+    {
+        return _mm_cmpgt_ps(a, b);
+    }
+    static auto select(Mask m,
+                       Vec a,
+                       Vec b) -> Vec
+    {
+        return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+    }
+    static auto loadU8(const uint8_t* p) -> Vec
+    {
+        int32_t bytes = 0;
+        memcpy(&bytes, p, sizeof(bytes));
+        const __m128i zero = _mm_setzero_si128();
+        __m128i values = _mm_cvtsi32_si128(bytes);
+        values = _mm_unpacklo_epi8(values, zero);
+        values = _mm_unpacklo_epi16(values, zero);
+        return _mm_cvtepi32_ps(values);
+    }
+    static void storeU8(uint8_t* p,
+                        Vec v)
+    {
+        __m128i values = _mm_cvttps_epi32(v);
+        values = _mm_packs_epi32(values, values);
+        values = _mm_packus_epi16(values, values);
+        const int32_t bytes = _mm_cvtsi128_si32(values);
+        memcpy(p, &bytes, sizeof(bytes));
+    }
+};
+
+struct AVX2Ops {
+    using Vec = __m256;
+    using Mask = __m256;
+    static constexpr size_t WIDTH = 8;
+
+    PG_GEOMETRY_TARGET_AVX2 static auto load(const float* p) -> Vec { return _mm256_loadu_ps(p); }
+    PG_GEOMETRY_TARGET_AVX2 static void store(float* p,
+                                              Vec v)
+    {
+        _mm256_storeu_ps(p, v);
+    }
+    PG_GEOMETRY_TARGET_AVX2 static auto set(float v) -> Vec { return _mm256_set1_ps(v); }
+    PG_GEOMETRY_TARGET_AVX2 static auto add(Vec a,
+                                            Vec b) -> Vec
+    {
+        return _mm256_add_ps(a, b);
+    }
+    PG_GEOMETRY_TARGET_AVX2 static auto sub(Vec a,
+                                            Vec b) -> Vec
+    {
+        return _mm256_sub_ps(a, b);
+    }
+    PG_GEOMETRY_TARGET_AVX2 static auto mul(Vec a,
+                                            Vec b) -> Vec
+    {
+        return _mm256_mul_ps(a, b);
+    }
+    PG_GEOMETRY_TARGET_AVX2 static auto div(Vec a,
+                                            Vec b) -> Vec
+    {
+        return _mm256_div_ps(a, b);
+    }
+    PG_GEOMETRY_TARGET_AVX2 static auto sqrt(Vec a) -> Vec { return _mm256_sqrt_ps(a); }
+    PG_GEOMETRY_TARGET_AVX2 static auto abs(Vec a) -> Vec { return _mm256_andnot_ps(_mm256_set1_ps(-0.0F), a); }
+    PG_GEOMETRY_TARGET_AVX2 static auto min(Vec a,
+                                            Vec b) -> Vec
+    {
+        return _mm256_min_ps(a, b);
+    }
+    PG_GEOMETRY_TARGET_AVX2 static auto max(Vec a,
+                                            Vec b) -> Vec
+    {
+        return _mm256_max_ps(a, b);
+    }
+    PG_GEOMETRY_TARGET_AVX2 static auto lt(Vec a,
+                                           Vec b) -> Mask
+    {
+        return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+    }
+    PG_GEOMETRY_TARGET_AVX2 static auto le(Vec a,
+                                           Vec b) -> Mask
+    {
+        return _mm256_cmp_ps(a, b, _CMP_LE_OQ);
+    }
+    PG_GEOMETRY_TARGET_AVX2 static auto gt(Vec a,
+                                           Vec b) -> Mask
+    {
+        return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+    }
+    PG_GEOMETRY_TARGET_AVX2 static auto select(Mask m,
+                                               Vec a,
+                                               Vec b) -> Vec
+    {
+        return _mm256_blendv_ps(b, a, m);
+    }
+    PG_GEOMETRY_TARGET_AVX2 static auto loadU8(const uint8_t* p) -> Vec
+    {
+        const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+        return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+    }
+    PG_GEOMETRY_TARGET_AVX2 static void storeU8(uint8_t* p,
+                                                Vec v)
+    {
+        const __m256i values = _mm256_cvttps_epi32(v);
+        __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1));
+        packed = _mm_packus_epi16(packed, packed);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(p), packed);
+    }
+};
+#endif
+
+//
+// Auto UV scale
+//
+
+/** sqrt(x * x + y * y + z * z), like nifly Vector3::length */
+template <typename Ops>
+PG_GEOMETRY_INLINE auto length(typename Ops::Vec x,
+                               typename Ops::Vec y,
+                               typename Ops::Vec z) -> typename Ops::Vec
+{
+    return Ops::sqrt(Ops::add(Ops::add(Ops::mul(x, x), Ops::mul(y, y)), Ops::mul(z, z)));
+}
+
+/** Inverse UV density of the triangles starting at index first, in the operation order of autoUVScale */
+template <typename Ops>
+PG_GEOMETRY_INLINE void inverseUVDensity(const TriangleEdgeBlock& block,
+                                         size_t first,
+                                         typename Ops::Vec& invU,
+                                         typename Ops::Vec& invV)
+{
+    using Vec = typename Ops::Vec;
+
+    const Vec pos1X = Ops::load(block.pos1X.data() + first);
+    const Vec pos1Y = Ops::load(block.pos1Y.data() + first);
+    const Vec pos1Z = Ops::load(block.pos1Z.data() + first);
+    const Vec pos2X = Ops::load(block.pos2X.data() + first);
+    const Vec pos2Y = Ops::load(block.pos2Y.data() + first);
+    const Vec pos2Z = Ops::load(block.pos2Z.data() + first);
+
+    const Vec posSum = Ops::add(length<Ops>(pos1X, pos1Y, pos1Z), length<Ops>(pos2X, pos2Y, pos2Z));
+
+    const Vec uvSumU = Ops::add(Ops::abs(Ops::load(block.uv1U.data() + first)),
+                                Ops::abs(Ops::load(block.uv2U.data() + first)));
+    const Vec uvSumV = Ops::add(Ops::abs(Ops::load(block.uv1V.data() + first)),
+                                Ops::abs(Ops::load(block.uv2V.data() + first)));
+
+    const Vec one = Ops::set(1.0F);
+    invU = Ops::div(one, Ops::div(uvSumU, posSum));
+    invV = Ops::div(one, Ops::div(uvSumV, posSum));
+}
+
+template <typename Ops>
+PG_GEOMETRY_INLINE void inverseUVDensityBlock(const TriangleEdgeBlock& block,
+                                              UVDensitySums& sums)
+{
+    using Vec = typename Ops::Vec;
+
+    const size_t fullSize = block.size - (block.size % NUM_LANES);
+    for (size_t first = 0; first < fullSize; first += NUM_LANES) {
+        for (size_t lane = 0; lane < NUM_LANES; lane += Ops::WIDTH) {
+            Vec invU {};
+            Vec invV {};
+            inverseUVDensity<Ops>(block, first + lane, invU, invV);
+            Ops::store(sums.u.data() + lane, Ops::add(Ops::load(sums.u.data() + lane), invU));
+            Ops::store(sums.v.data() + lane, Ops::add(Ops::load(sums.v.data() + lane), invV));
+        }
+    }
+
+    if (fullSize == block.size) {
+        return;
+    }
+
+    // the last partial group is computed in full, only lanes of real triangles are added
+    alignas(32) array<float, NUM_LANES> restU {};
+    alignas(32) array<float, NUM_LANES> restV {};
+    for (size_t lane = 0; lane < NUM_LANES; lane += Ops::WIDTH) {
+        Vec invU {};
+        Vec invV {};
+        inverseUVDensity<Ops>(block, fullSize + lane, invU, invV);
+        Ops::store(restU.data() + lane, invU);
+        Ops::store(restV.data() + lane, invV);
+    }
+
+    for (size_t lane = 0; lane < block.size - fullSize; lane++) {
+        sums.u[lane] += restU[lane];
+        sums.v[lane] += restV[lane];
+    }
+}
+
+//
+// HSL adjustment
+//
+
+/** gil HSL to RGB for one channel, t is the hue shifted for that channel */
+template <typename Ops>
+PG_GEOMETRY_INLINE auto hueToChannel(typename Ops::Vec temp1,
+                                     typename Ops::Vec temp2,
+                                     typename Ops::Vec t) -> typename Ops::Vec
+{
+    using Vec = typename Ops::Vec;
+
+    const Vec six = Ops::set(6.0F);
+    const Vec twoThirds = Ops::set(TWO_THIRDS);
+    const Vec delta = Ops::sub(temp2, temp1);
+    const Vec rising = Ops::add(temp1, Ops::mul(Ops::mul(delta, six), t));
+    const Vec falling = Ops::add(temp1, Ops::mul(Ops::mul(delta, Ops::sub(twoThirds, t)), six));
+
+    return Ops::select(
+        Ops::lt(t, Ops::set(ONE_SIXTH)),
+        rising,
+        Ops::select(Ops::lt(t, Ops::set(0.5F)), temp2, Ops::select(Ops::lt(t, twoThirds), falling, temp1)));
+}
+
+/** std::clamp(v, 0, 1) */
+template <typename Ops>
+PG_GEOMETRY_INLINE auto clampUnit(typename Ops::Vec v) -> typename Ops::Vec
+{
+    const auto zero = Ops::set(0.0F);
+    const auto one = Ops::set(1.0F);
+    return Ops::select(Ops::lt(v, zero), zero, Ops::select(Ops::gt(v, one), one, v));
+}
+
+/** Adjusts Ops::WIDTH colors, every step mirrors boost::gil's rgb_t <-> hsl_t converters */
+template <typename Ops>
+PG_GEOMETRY_INLINE void adjustHSLVec(uint8_t* red,
+                                     uint8_t* green,
+                                     uint8_t* blue,
+                                     const HSLAdjust& adjust)
+{
+    using Vec = typename Ops::Vec;
+
+    const Vec zero = Ops::set(0.0F);
+    const Vec half = Ops::set(0.5F);
+    const Vec one = Ops::set(1.0F);
+    const Vec two = Ops::set(2.0F);
+    const Vec channelMax = Ops::set(CHANNEL_MAX);
+
+    // RGB to HSL
+    const Vec r = Ops::div(Ops::loadU8(red), channelMax);
+    const Vec g = Ops::div(Ops::loadU8(green), channelMax);
+    const Vec b = Ops::div(Ops::loadU8(blue), channelMax);
+
+    const Vec minColor = Ops::min(r, Ops::min(g, b));
+    const Vec maxColor = Ops::max(r, Ops::max(g, b));
+    const Vec diff = Ops::sub(maxColor, minColor);
+    const auto isGray = Ops::lt(Ops::abs(Ops::sub(minColor, maxColor)), Ops::set(RGB_GRAY_EPSILON));
+
+    Vec lightness = Ops::div(Ops::add(minColor, maxColor), two);
+    Vec saturation = Ops::select(Ops::lt(lightness, half),
+                                 Ops::div(diff, Ops::add(minColor, maxColor)),
+                                 Ops::div(Ops::sub(maxColor, minColor), Ops::sub(two, diff)));
+
+    // gil uses r - b for the blue case too
+    const Vec hueRed = Ops::div(Ops::sub(g, b), diff);
+    const Vec hueGreen = Ops::add(two, Ops::div(Ops::sub(b, r), diff));
+    const Vec hueBlue = Ops::add(Ops::set(4.0F), Ops::div(Ops::sub(r, b), diff));
+    const Vec hueEpsilon = Ops::set(HUE_CHANNEL_EPSILON);
+    Vec hue = Ops::select(Ops::lt(Ops::abs(Ops::sub(maxColor, r)), hueEpsilon),
+                          hueRed,
+                          Ops::select(Ops::lt(Ops::abs(Ops::sub(maxColor, g)), hueEpsilon), hueGreen, hueBlue));
+    hue = Ops::div(hue, Ops::set(6.0F));
+    hue = Ops::select(Ops::lt(hue, zero), Ops::add(hue, one), hue);
+
+    hue = Ops::select(isGray, zero, hue);
+    saturation = Ops::select(isGray, zero, saturation);
+    lightness = Ops::select(isGray, r, lightness);
+
+    // Adjust
+    if (adjust.scaleLightness) {
+        lightness = Ops::sub(one, Ops::mul(Ops::sub(one, lightness), Ops::set(adjust.lightnessMult)));
+    }
+    if (adjust.scaleSaturation) {
+        saturation = Ops::mul(saturation, Ops::set(adjust.saturationMult));
+    }
+    saturation = clampUnit<Ops>(saturation);
+    lightness = clampUnit<Ops>(lightness);
+
+    // HSL to RGB
+    const auto isGrayOut = Ops::le(Ops::abs(saturation), Ops::set(HSL_GRAY_EPSILON));
+    const Vec temp2 = Ops::select(Ops::lt(lightness, half),
+                                  Ops::mul(lightness, Ops::add(one, saturation)),
+                                  Ops::sub(Ops::add(lightness, saturation), Ops::mul(lightness, saturation)));
+    const Vec temp1 = Ops::sub(Ops::mul(two, lightness), temp2);
+
+    const Vec oneThird = Ops::set(ONE_THIRD);
+    Vec tempR = Ops::add(hue, oneThird);
+    tempR = Ops::select(Ops::gt(tempR, one), Ops::sub(tempR, one), tempR);
+    Vec tempB = Ops::sub(hue, oneThird);
+    tempB = Ops::select(Ops::lt(tempB, zero), Ops::add(tempB, one), tempB);
+
+    const Vec outR = Ops::select(isGrayOut, lightness, hueToChannel<Ops>(temp1, temp2, tempR));
+    const Vec outG = Ops::select(isGrayOut, lightness, hueToChannel<Ops>(temp1, temp2, hue));
+    const Vec outB = Ops::select(isGrayOut, lightness, hueToChannel<Ops>(temp1, temp2, tempB));
+
+    Ops::storeU8(red, Ops::add(Ops::mul(outR, channelMax), half));
+    Ops::storeU8(green, Ops::add(Ops::mul(outG, channelMax), half));
+    Ops::storeU8(blue, Ops::add(Ops::mul(outB, channelMax), half));
+}
+
+template <typename Ops>
+PG_GEOMETRY_INLINE void adjustHSLBatch(uint8_t* red,
+                                       uint8_t* green,
+                                       uint8_t* blue,
+                                       size_t count,
+                                       const HSLAdjust& adjust)
+{
+    size_t i = 0;
+    for (; i + Ops::WIDTH <= count; i += Ops::WIDTH) {
+        adjustHSLVec<Ops>(red + i, green + i, blue + i, adjust);
+    }
+
+    if (i < count) {
+        // the rest goes through a padded copy
+        const size_t rest = count - i;
+        array<uint8_t, NUM_LANES> restR {};
+        array<uint8_t, NUM_LANES> restG {};
+        array<uint8_t, NUM_LANES> restB {};
+        copy_n(red + i, rest, restR.begin());
+        copy_n(green + i, rest, restG.begin());
+        copy_n(blue + i, rest, restB.begin());
+
+        adjustHSLVec<Ops>(restR.data(), restG.data(), restB.data(), adjust);
+
+        copy_n(restR.begin(), rest, red + i);
+        copy_n(restG.begin(), rest, green + i);
+        copy_n(restB.begin(), rest, blue + i);
+    }
+}
+
+//
+// Dispatch
+//
+
+#ifdef PG_GEOMETRY_X64
+auto readXCR0() -> uint64_t
+{
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    uint32_t eax = 0;
+    uint32_t edx = 0;
+    __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32U) | eax;
+#endif
+}
+
+auto cpuHasAVX2() -> bool
+{
+    constexpr uint32_t CPUID_ECX_OSXSAVE = 1U << 27U;
+    constexpr uint32_t CPUID_ECX_AVX = 1U << 28U;
+    constexpr uint32_t CPUID_EBX_AVX2 = 1U << 5U;
+    constexpr uint64_t XCR0_SSE_AVX = 0x6; /** OS saves XMM and YMM state */
+
+#ifdef _MSC_VER
+    array<int, 4> regs {};
+    __cpuid(regs.data(), 0);
+    if (regs[0] < 7) {
+        return false;
+    }
+    __cpuid(regs.data(), 1);
+    const auto ecx = static_cast<uint32_t>(regs[2]);
+    __cpuidex(regs.data(), 7, 0);
+    const auto ebx = static_cast<uint32_t>(regs[1]);
+#else
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+        return false;
+    }
+    const uint32_t leaf1ECX = ecx;
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0) {
+        return false;
+    }
+    ecx = leaf1ECX;
+#endif
+
+    if ((ecx & CPUID_ECX_OSXSAVE) == 0 || (ecx & CPUID_ECX_AVX) == 0) {
+        return false;
+    }
+
+    return (readXCR0() & XCR0_SSE_AVX) == XCR0_SSE_AVX && (ebx & CPUID_EBX_AVX2) != 0;
+}
+
+auto useAVX2() -> bool
+{
+    static const bool hasAVX2 = cpuHasAVX2();
+    return hasAVX2;
+}
+
+PG_GEOMETRY_TARGET_AVX2 void inverseUVDensityBlockAVX2(const TriangleEdgeBlock& block,
+                                                       UVDensitySums& sums)
+{
+    inverseUVDensityBlock<AVX2Ops>(block, sums);
+}
+
+PG_GEOMETRY_TARGET_AVX2 void adjustHSLBatchAVX2(uint8_t* red,
+                                                uint8_t* green,
+                                                uint8_t* blue,
+                                                size_t count,
+                                                const HSLAdjust& adjust)
+{
+    adjustHSLBatch<AVX2Ops>(red, green, blue, count, adjust);
+}
+#endif
+
+}
+
+namespace GeometryKernels {
+
+auto UVDensitySums::totalU() const -> float
+{
+    return ((u[0] + u[1]) + (u[2] + u[3])) + ((u[4] + u[5]) + (u[6] + u[7]));
+}
+
+auto UVDensitySums::totalV() const -> float
+{
+    return ((v[0] + v[1]) + (v[2] + v[3])) + ((v[4] + v[5]) + (v[6] + v[7]));
+}
+
+void accumulateInverseUVDensity(const TriangleEdgeBlock& block,
+                                UVDensitySums& sums)
+{
+#ifdef PG_GEOMETRY_X64
+    if (useAVX2()) {
+        inverseUVDensityBlockAVX2(block, sums);
+        return;
+    }
+    inverseUVDensityBlock<SSE2Ops>(block, sums);
+#else
+    inverseUVDensityBlock<ScalarOps>(block, sums);
+#endif
+}
+
+void adjustHSL(uint8_t* red,
+               uint8_t* green,
+               uint8_t* blue,
+               size_t count,
+               const HSLAdjust& adjust)
+{
+#ifdef PG_GEOMETRY_X64
+    if (useAVX2()) {
+        adjustHSLBatchAVX2(red, green, blue, count, adjust);
+        return;
+    }
+    adjustHSLBatch<SSE2Ops>(red, green, blue, count, adjust);
+#else
+    adjustHSLBatch<ScalarOps>(red, green, blue, count, adjust);
+#endif
+}
+
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers,cppcoreguidelines-pro-bounds-pointer-arithmetic,cppcoreguidelines-pro-type-reinterpret-cast)
@@ -0,0 +1,238 @@
+#include "util/GlobSet.hpp"
+
+#include "util/StringUtil.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+namespace {
+constexpr wchar_t GLOB_STAR = L'*';
+constexpr wchar_t GLOB_ANY = L'?';
+constexpr wchar_t GLOB_SEPARATOR = L';';
+constexpr wstring_view GLOB_MATCH_ALL = L"*.*";
+
+void keepLowest(optional<size_t>& best,
+                size_t globIdx)
+{
+    if (!best.has_value() || globIdx < best.value()) {
+        best = globIdx;
+    }
+}
+}
+
+GlobSet::GlobSet(const vector<wstring>& globs)
+    : m_numGlobs(globs.size())
+{
+    for (size_t globIdx = 0; globIdx < globs.size(); globIdx++) {
+        wstring glob = globs[globIdx];
+        StringUtil::toLowerASCIIFastInPlace(glob);
+
+        if (glob == GLOB_MATCH_ALL) {
+            keepLowest(m_matchAll, globIdx);
+            continue;
+        }
+
+        // same splitting as PathMatchSpecW: ; separated patterns, leading spaces of each pattern ignored
+        wstring_view remaining = glob;
+        while (!remaining.empty()) {
+            const auto firstNonSpace = remaining.find_first_not_of(L' ');
+            if (firstNonSpace == wstring_view::npos) {
+                // a pattern of only spaces is empty and matches the empty path
+                addPattern({}, globIdx);
+                break;
+            }
+            remaining.remove_prefix(firstNonSpace);
+
+            const auto sepPos = remaining.find(GLOB_SEPARATOR);
+            addPattern(remaining.substr(0, sepPos), globIdx);
+            if (sepPos == wstring_view::npos) {
+                break;
+            }
+            remaining.remove_prefix(sepPos + 1);
+        }
+    }
+
+    ranges::stable_sort(m_wildcards, {}, &WildcardPattern::globIdx);
+}
+
+void GlobSet::addPattern(wstring_view pattern,
+                         size_t globIdx)
+{
+    const auto firstStar = pattern.find(GLOB_STAR);
+    const bool hasAny = pattern.find(GLOB_ANY) != wstring_view::npos;
+
+    if (firstStar == wstring_view::npos && !hasAny) {
+        const auto& literal = m_storage.emplace_back(pattern);
+        m_exact.try_emplace(literal, globIdx);
+        return;
+    }
+
+    if (!hasAny && firstStar == pattern.find_last_of(GLOB_STAR)) {
+        // exactly one star with only literals around it
+        const auto head = pattern.substr(0, firstStar);
+        const auto tail = pattern.substr(firstStar + 1);
+        if (head.empty() && tail.empty()) {
+            keepLowest(m_matchAll, globIdx);
+            return;
+        }
+        if (tail.empty()) {
+            addToBucket(m_prefixes, m_storage.emplace_back(head), globIdx);
+            return;
+        }
+        if (head.empty()) {
+            addToBucket(m_suffixes, m_storage.emplace_back(tail), globIdx);
+            return;
+        }
+    }
+
+    WildcardPattern wildcard {.globIdx = globIdx, .segments = {}, .hasStar = firstStar != wstring_view::npos,
+                               .minLength = 0};
+    size_t segStart = 0;
+    while (true) {
+        const auto starPos = pattern.find(GLOB_STAR, segStart);
+        wildcard.segments.emplace_back(pattern.substr(segStart, starPos - segStart));
+        if (starPos == wstring_view::npos) {
+            break;
+        }
+        segStart = starPos + 1;
+    }
+
+    for (const auto& segment : wildcard.segments) {
+        wildcard.minLength += segment.size();
+    }
+
+    m_wildcards.push_back(std::move(wildcard));
+}
+
+void GlobSet::addToBucket(vector<LiteralBucket>& buckets,
+                          wstring_view literal,
+                          size_t globIdx)
+{
+    auto it = ranges::find(buckets, literal.size(), &LiteralBucket::length);
+    if (it == buckets.end()) {
+        it = buckets.insert(buckets.end(), LiteralBucket {.length = literal.size(), .globIndices = {}});
+    }
+
+    it->globIndices.try_emplace(literal, globIdx);
+}
+
+void GlobSet::lookupBucket(const vector<LiteralBucket>& buckets,
+                           wstring_view path,
+                           bool fromFront,
+                           optional<size_t>& best)
+{
+    for (const auto& bucket : buckets) {
+        if (bucket.length > path.size()) {
+            continue;
+        }
+
+        const auto key = fromFront ? path.substr(0, bucket.length) : path.substr(path.size() - bucket.length);
+        const auto it = bucket.globIndices.find(key);
+        if (it != bucket.globIndices.end()) {
+            keepLowest(best, it->second);
+        }
+    }
+}
+
+auto GlobSet::matchSegment(wstring_view text,
+                           wstring_view segment) -> bool
+{
+    // text has the length of the segment
+    for (size_t i = 0; i < segment.size(); i++) {
+        if (segment[i] != GLOB_ANY && segment[i] != text[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto GlobSet::matchWildcard(const WildcardPattern& pattern,
+                            wstring_view path) -> bool
+{
+    if (!pattern.hasStar) {
+        return path.size() == pattern.minLength && matchSegment(path, pattern.segments.front());
+    }
+
+    if (path.size() < pattern.minLength) {
+        return false;
+    }
+
+    // head and tail are anchored, the segments in between are matched leftmost first which is optimal for stars
+    const auto& head = pattern.segments.front();
+    const auto& tail = pattern.segments.back();
+    if (!matchSegment(path.substr(0, head.size()), head)
+        || !matchSegment(path.substr(path.size() - tail.size()), tail)) {
+        return false;
+    }
+
+    auto middle = path.substr(head.size(), path.size() - head.size() - tail.size());
+    for (size_t segIdx = 1; segIdx + 1 < pattern.segments.size(); segIdx++) {
+        const auto& segment = pattern.segments[segIdx];
+
+        bool found = false;
+        for (size_t start = 0; start + segment.size() <= middle.size(); start++) {
+            if (matchSegment(middle.substr(start, segment.size()), segment)) {
+                middle.remove_prefix(start + segment.size());
+                found = true;
+                break;
+            }
+        }
+
+        if (!found) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto GlobSet::findMatchLower(wstring_view lowerPath) const -> optional<size_t>
+{
+    optional<size_t> best = m_matchAll;
+
+    const auto exactIt = m_exact.find(lowerPath);
+    if (exactIt != m_exact.end()) {
+        keepLowest(best, exactIt->second);
+    }
+
+    lookupBucket(m_prefixes, lowerPath, true, best);
+    lookupBucket(m_suffixes, lowerPath, false, best);
+
+    for (const auto& wildcard : m_wildcards) {
+        if (best.has_value() && wildcard.globIdx >= best.value()) {
+            // sorted by glob index, nothing left that could win
+            break;
+        }
+
+        if (matchWildcard(wildcard, lowerPath)) {
+            best = wildcard.globIdx;
+            break;
+        }
+    }
+
+    return best;
+}
+
+auto GlobSet::findMatch(wstring_view path) const -> optional<size_t>
+{
+    if (m_numGlobs == 0) {
+        return nullopt;
+    }
+
+    thread_local wstring lowerPath;
+    lowerPath.assign(path);
+    StringUtil::toLowerASCIIFastInPlace(lowerPath);
+
+    return findMatchLower(lowerPath);
+}
+
+auto GlobSet::matches(wstring_view path) const -> bool { return findMatch(path).has_value(); }
+
+auto GlobSet::empty() const -> bool { return m_numGlobs == 0; }
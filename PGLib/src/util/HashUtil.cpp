@@ -0,0 +1,534 @@
+#include "util/HashUtil.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#include <emmintrin.h>
+#include <smmintrin.h>
+#include <wmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#define PG_HASH_X64
+#if defined(__GNUC__) || defined(__clang__)
+#define PG_HASH_TARGET_CLMUL __attribute__((target("pclmul,sse4.1")))
+#else
+#define PG_HASH_TARGET_CLMUL
+#endif
+#endif
+
+using namespace std;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers,cppcoreguidelines-pro-bounds-pointer-arithmetic,cppcoreguidelines-pro-bounds-constant-array-index,cppcoreguidelines-pro-type-reinterpret-cast)
+namespace {
+
+//
+// CRC32
+//
+
+constexpr uint32_t CRC32_POLY = 0xEDB88320U; /** Reflected 0x04C11DB7 */
+constexpr size_t CRC32_BITS = 32;
+constexpr size_t CRC32_SLICES = 16;
+constexpr size_t CRC32_CLMUL_MIN_SIZE = 64;
+constexpr size_t CRC32_CLMUL_CHUNK_MASK = 15;
+
+using CRC32Tables = array<array<uint32_t, 256>, CRC32_SLICES>;
+
+constexpr auto makeCRC32Tables() -> CRC32Tables
+{
+    CRC32Tables tables {};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int bit = 0; bit < 8; bit++) {
+            c = (c & 1U) != 0 ? (c >> 1U) ^ CRC32_POLY : c >> 1U;
+        }
+        tables[0][i] = c;
+    }
+
+    // table n advances a byte through n more zero bytes
+    for (size_t slice = 1; slice < CRC32_SLICES; slice++) {
+        for (size_t i = 0; i < 256; i++) {
+            const uint32_t prev = tables[slice - 1][i];
+            tables[slice][i] = (prev >> 8U) ^ tables[0][prev & 0xFFU];
+        }
+    }
+
+    return tables;
+}
+
+constexpr CRC32Tables CRC32_TABLES = makeCRC32Tables();
+
+auto load32(const uint8_t* data) -> uint32_t
+{
+    uint32_t value = 0;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+#ifndef PG_HASH_X64
+auto load64(const uint8_t* data) -> uint64_t
+{
+    uint64_t value = 0;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+#endif
+
+/** Works on the CRC register, without the inversion before and after */
+auto crc32Slicing16(const uint8_t* data,
+                    size_t size,
+                    uint32_t reg) -> uint32_t
+{
+    const auto& t = CRC32_TABLES;
+
+    while (size >= CRC32_SLICES) {
+        const uint32_t w0 = load32(data) ^ reg;
+        const uint32_t w1 = load32(data + 4);
+        const uint32_t w2 = load32(data + 8);
+        const uint32_t w3 = load32(data + 12);
+
+        reg = t[15][w0 & 0xFFU] ^ t[14][(w0 >> 8U) & 0xFFU] ^ t[13][(w0 >> 16U) & 0xFFU] ^ t[12][w0 >> 24U]
+            ^ t[11][w1 & 0xFFU] ^ t[10][(w1 >> 8U) & 0xFFU] ^ t[9][(w1 >> 16U) & 0xFFU] ^ t[8][w1 >> 24U]
+            ^ t[7][w2 & 0xFFU] ^ t[6][(w2 >> 8U) & 0xFFU] ^ t[5][(w2 >> 16U) & 0xFFU] ^ t[4][w2 >> 24U]
+            ^ t[3][w3 & 0xFFU] ^ t[2][(w3 >> 8U) & 0xFFU] ^ t[1][(w3 >> 16U) & 0xFFU] ^ t[0][w3 >> 24U];
+
+        data += CRC32_SLICES;
+        size -= CRC32_SLICES;
+    }
+
+    while (size-- > 0) {
+        reg = (reg >> 8U) ^ t[0][(reg ^ *data++) & 0xFFU];
+    }
+
+    return reg;
+}
+
+#ifdef PG_HASH_X64
+auto cpuHasCLMUL() -> bool
+{
+    constexpr uint32_t CPUID_ECX_PCLMULQDQ = 1U << 1U;
+    constexpr uint32_t CPUID_ECX_SSE41 = 1U << 19U;
+
+#ifdef _MSC_VER
+    array<int, 4> regs {};
+    __cpuid(regs.data(), 1);
+    const auto ecx = static_cast<uint32_t>(regs[2]);
+#else
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+        return false;
+    }
+#endif
+
+    return (ecx & CPUID_ECX_PCLMULQDQ) != 0 && (ecx & CPUID_ECX_SSE41) != 0;
+}
+
+/** Folds acc forward by 128 bits onto next */
+PG_HASH_TARGET_CLMUL auto crc32Fold128(__m128i acc,
+                                       __m128i next,
+                                       __m128i k3k4) -> __m128i
+{
+    const __m128i low = _mm_clmulepi64_si128(acc, k3k4, 0x00);
+    const __m128i high = _mm_clmulepi64_si128(acc, k3k4, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(high, next), low);
+}
+
+/**
+ * Folds 64 bytes at a time with carry-less multiplication and Barrett reduces to 32 bits, from Intel's "Fast CRC
+ * Computation for Generic Polynomials Using PCLMULQDQ Instruction" with the constants for the reflected polynomial,
+ * same as zlib/Chromium. Size must be at least 64 and a multiple of 16. Works on the CRC register.
+ */
+PG_HASH_TARGET_CLMUL auto crc32CLMUL(const uint8_t* data,
+                                     size_t size,
+                                     uint32_t reg) -> uint32_t
+{
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    const __m128i k5k0 = _mm_set_epi64x(0x0000000000, 0x0163cd6124);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+
+    const auto* blocks = reinterpret_cast<const __m128i*>(data);
+
+    __m128i x1 = _mm_xor_si128(_mm_loadu_si128(blocks), _mm_cvtsi32_si128(static_cast<int>(reg)));
+    __m128i x2 = _mm_loadu_si128(blocks + 1);
+    __m128i x3 = _mm_loadu_si128(blocks + 2);
+    __m128i x4 = _mm_loadu_si128(blocks + 3);
+    blocks += 4;
+    size -= CRC32_CLMUL_MIN_SIZE;
+
+    // four folds in parallel
+    while (size >= CRC32_CLMUL_MIN_SIZE) {
+        const __m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        const __m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        const __m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        const __m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(blocks));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(blocks + 1));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(blocks + 2));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(blocks + 3));
+
+        blocks += 4;
+        size -= CRC32_CLMUL_MIN_SIZE;
+    }
+
+    // fold the four lanes into one
+    x1 = crc32Fold128(x1, x2, k3k4);
+    x1 = crc32Fold128(x1, x3, k3k4);
+    x1 = crc32Fold128(x1, x4, k3k4);
+
+    // remaining 16 byte blocks
+    while (size >= sizeof(__m128i)) {
+        x1 = crc32Fold128(x1, _mm_loadu_si128(blocks), k3k4);
+        blocks++;
+        size -= sizeof(__m128i);
+    }
+
+    // 128 to 64 bits
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+#endif
+
+auto useCLMUL() -> bool
+{
+#ifdef PG_HASH_X64
+    static const bool hasCLMUL = cpuHasCLMUL();
+    return hasCLMUL;
+#else
+    return false;
+#endif
+}
+
+using GF2Matrix = array<uint32_t, CRC32_BITS>;
+
+auto gf2MatrixTimes(const GF2Matrix& mat,
+                    uint32_t vec) -> uint32_t
+{
+    uint32_t sum = 0;
+    for (size_t i = 0; vec != 0; i++, vec >>= 1U) {
+        if ((vec & 1U) != 0) {
+            sum ^= mat[i];
+        }
+    }
+    return sum;
+}
+
+auto gf2MatrixSquare(const GF2Matrix& mat) -> GF2Matrix
+{
+    GF2Matrix square {};
+    for (size_t i = 0; i < CRC32_BITS; i++) {
+        square[i] = gf2MatrixTimes(mat, mat[i]);
+    }
+    return square;
+}
+
+//
+// Content hash
+//
+
+constexpr size_t SECRET_WORDS = 24;
+constexpr size_t SCRAMBLE_SECRET_OFFSET = 16;
+constexpr size_t LOW_SECRET_OFFSET = 3;
+constexpr size_t HIGH_SECRET_OFFSET = 13;
+
+constexpr uint64_t PRIME32_1 = 0x9E3779B1U;
+constexpr uint64_t PRIME32_2 = 0x85EBCA77U;
+constexpr uint64_t PRIME32_3 = 0xC2B2AE3DU;
+constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+using Accumulators = array<uint64_t, HashUtil::ContentHasher::NUM_LANES>;
+
+constexpr Accumulators INITIAL_ACC
+    = {PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3, PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1};
+
+/** Fixed key material, generated with splitmix64 */
+constexpr auto makeSecret() -> array<uint64_t, SECRET_WORDS>
+{
+    array<uint64_t, SECRET_WORDS> secret {};
+    uint64_t state = 0x5047506174636865ULL;
+    for (auto& word : secret) {
+        state += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = state;
+        z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+        word = z ^ (z >> 31U);
+    }
+    return secret;
+}
+
+constexpr array<uint64_t, SECRET_WORDS> SECRET = makeSecret();
+
+auto mul128Fold64(uint64_t lhs,
+                  uint64_t rhs) -> uint64_t
+{
+#if defined(__SIZEOF_INT128__)
+    const auto product = static_cast<unsigned __int128>(lhs) * rhs;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64U);
+#elif defined(_M_X64)
+    uint64_t high = 0;
+    const uint64_t low = _umul128(lhs, rhs, &high);
+    return low ^ high;
+#else
+    const uint64_t loLo = (lhs & 0xFFFFFFFFU) * (rhs & 0xFFFFFFFFU);
+    const uint64_t hiLo = (lhs >> 32U) * (rhs & 0xFFFFFFFFU);
+    const uint64_t loHi = (lhs & 0xFFFFFFFFU) * (rhs >> 32U);
+    const uint64_t hiHi = (lhs >> 32U) * (rhs >> 32U);
+    const uint64_t cross = (loLo >> 32U) + (hiLo & 0xFFFFFFFFU) + loHi;
+    const uint64_t high = (hiLo >> 32U) + (cross >> 32U) + hiHi;
+    const uint64_t low = (cross << 32U) | (loLo & 0xFFFFFFFFU);
+    return low ^ high;
+#endif
+}
+
+auto avalanche(uint64_t h) -> uint64_t
+{
+    h ^= h >> 37U;
+    h *= 0x165667919E3779F9ULL;
+    h ^= h >> 32U;
+    return h;
+}
+
+/** acc[i ^ 1] += data[i], acc[i] += lo32(data[i] ^ key[i]) * hi32(data[i] ^ key[i]) */
+void accumulateStripe(Accumulators& acc,
+                      const uint8_t* stripe,
+                      const uint64_t* secret)
+{
+#ifdef PG_HASH_X64
+    auto* accVecs = reinterpret_cast<__m128i*>(acc.data());
+    const auto* dataVecs = reinterpret_cast<const __m128i*>(stripe);
+    const auto* keyVecs = reinterpret_cast<const __m128i*>(secret);
+    for (size_t i = 0; i < HashUtil::ContentHasher::NUM_LANES / 2; i++) {
+        const __m128i dataVec = _mm_loadu_si128(dataVecs + i);
+        const __m128i dataKey = _mm_xor_si128(dataVec, _mm_loadu_si128(keyVecs + i));
+        const __m128i dataKeyHigh = _mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1));
+        const __m128i product = _mm_mul_epu32(dataKey, dataKeyHigh);
+        const __m128i dataSwap = _mm_shuffle_epi32(dataVec, _MM_SHUFFLE(1, 0, 3, 2));
+        _mm_storeu_si128(accVecs + i,
+                         _mm_add_epi64(_mm_loadu_si128(accVecs + i), _mm_add_epi64(product, dataSwap)));
+    }
+#else
+    for (size_t lane = 0; lane < HashUtil::ContentHasher::NUM_LANES; lane++) {
+        const uint64_t dataVal = load64(stripe + (lane * sizeof(uint64_t)));
+        const uint64_t dataKey = dataVal ^ secret[lane];
+        acc[lane ^ 1U] += dataVal;
+        acc[lane] += (dataKey & 0xFFFFFFFFU) * (dataKey >> 32U);
+    }
+#endif
+}
+
+/** acc = (acc ^ (acc >> 47) ^ key) * PRIME32_1 */
+void scrambleAccumulators(Accumulators& acc,
+                          const uint64_t* secret)
+{
+#ifdef PG_HASH_X64
+    auto* accVecs = reinterpret_cast<__m128i*>(acc.data());
+    const auto* keyVecs = reinterpret_cast<const __m128i*>(secret);
+    const __m128i prime = _mm_set1_epi32(static_cast<int>(PRIME32_1));
+    for (size_t i = 0; i < HashUtil::ContentHasher::NUM_LANES / 2; i++) {
+        __m128i accVec = _mm_loadu_si128(accVecs + i);
+        accVec = _mm_xor_si128(accVec, _mm_srli_epi64(accVec, 47));
+        accVec = _mm_xor_si128(accVec, _mm_loadu_si128(keyVecs + i));
+
+        const __m128i productLow = _mm_mul_epu32(accVec, prime);
+        const __m128i productHigh = _mm_mul_epu32(_mm_srli_epi64(accVec, 32), prime);
+        _mm_storeu_si128(accVecs + i, _mm_add_epi64(productLow, _mm_slli_epi64(productHigh, 32)));
+    }
+#else
+    for (size_t lane = 0; lane < HashUtil::ContentHasher::NUM_LANES; lane++) {
+        uint64_t value = acc[lane];
+        value ^= value >> 47U;
+        value ^= secret[lane];
+        acc[lane] = value * PRIME32_1;
+    }
+#endif
+}
+
+auto mergeAccumulators(const Accumulators& acc,
+                       const uint64_t* secret,
+                       uint64_t start) -> uint64_t
+{
+    uint64_t result = start;
+    for (size_t lane = 0; lane < HashUtil::ContentHasher::NUM_LANES; lane += 2) {
+        result += mul128Fold64(acc[lane] ^ secret[lane], acc[lane + 1] ^ secret[lane + 1]);
+    }
+    return avalanche(result);
+}
+
+}
+
+namespace HashUtil {
+
+auto crc32(const void* data,
+           size_t size,
+           uint32_t crc) -> uint32_t
+{
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    uint32_t reg = ~crc;
+
+#ifdef PG_HASH_X64
+    if (size >= CRC32_CLMUL_MIN_SIZE && useCLMUL()) {
+        const size_t chunkSize = size & ~CRC32_CLMUL_CHUNK_MASK;
+        reg = crc32CLMUL(bytes, chunkSize, reg);
+        bytes += chunkSize;
+        size -= chunkSize;
+    }
+#endif
+
+    return ~crc32Slicing16(bytes, size, reg);
+}
+
+auto crc32Combine(uint32_t crc1,
+                  uint32_t crc2,
+                  size_t len2) -> uint32_t
+{
+    if (len2 == 0) {
+        return crc1;
+    }
+
+    // operator for one zero bit, squared up to one zero byte, same approach as zlib's crc32_combine
+    GF2Matrix odd {};
+    odd[0] = CRC32_POLY;
+    uint32_t row = 1;
+    for (size_t i = 1; i < CRC32_BITS; i++) {
+        odd[i] = row;
+        row <<= 1U;
+    }
+
+    GF2Matrix even = gf2MatrixSquare(odd); // two zero bits
+    odd = gf2MatrixSquare(even); // four zero bits
+
+    // apply len2 zero bytes to crc1 bit by bit of len2, alternating between the two operators while squaring
+    do {
+        even = gf2MatrixSquare(odd);
+        if ((len2 & 1U) != 0) {
+            crc1 = gf2MatrixTimes(even, crc1);
+        }
+        len2 >>= 1U;
+        if (len2 == 0) {
+            break;
+        }
+
+        odd = gf2MatrixSquare(even);
+        if ((len2 & 1U) != 0) {
+            crc1 = gf2MatrixTimes(odd, crc1);
+        }
+        len2 >>= 1U;
+    } while (len2 != 0);
+
+    return crc1 ^ crc2;
+}
+
+auto getCRC32Implementation() -> string_view { return useCLMUL() ? "PCLMULQDQ" : "slicing-by-16"; }
+
+ContentHasher::ContentHasher() { reset(); }
+
+void ContentHasher::reset()
+{
+    m_acc = INITIAL_ACC;
+    m_bufferSize = 0;
+    m_stripeInBlock = 0;
+    m_totalSize = 0;
+}
+
+void ContentHasher::consumeStripe(const uint8_t* stripe)
+{
+    accumulateStripe(m_acc, stripe, SECRET.data() + m_stripeInBlock);
+    if (++m_stripeInBlock == STRIPES_PER_BLOCK) {
+        scrambleAccumulators(m_acc, SECRET.data() + SCRAMBLE_SECRET_OFFSET);
+        m_stripeInBlock = 0;
+    }
+}
+
+void ContentHasher::update(const void* data,
+                           size_t size)
+{
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    m_totalSize += size;
+
+    // top up a partial stripe first
+    if (m_bufferSize > 0) {
+        const size_t take = min(size, STRIPE_SIZE - m_bufferSize);
+        memcpy(m_buffer.data() + m_bufferSize, bytes, take);
+        m_bufferSize += take;
+        bytes += take;
+        size -= take;
+
+        if (m_bufferSize < STRIPE_SIZE) {
+            return;
+        }
+
+        consumeStripe(m_buffer.data());
+        m_bufferSize = 0;
+    }
+
+    while (size >= STRIPE_SIZE) {
+        consumeStripe(bytes);
+        bytes += STRIPE_SIZE;
+        size -= STRIPE_SIZE;
+    }
+
+    if (size > 0) {
+        memcpy(m_buffer.data(), bytes, size);
+        m_bufferSize = size;
+    }
+}
+
+auto ContentHasher::digest() const -> Hash128
+{
+    Accumulators acc = m_acc;
+
+    // the tail is zero padded, the total size mixed in below tells it apart from real zeros
+    if (m_bufferSize > 0) {
+        array<uint8_t, STRIPE_SIZE> lastStripe {};
+        memcpy(lastStripe.data(), m_buffer.data(), m_bufferSize);
+        accumulateStripe(acc, lastStripe.data(), SECRET.data() + m_stripeInBlock);
+    }
+
+    return {.low = mergeAccumulators(acc, SECRET.data() + LOW_SECRET_OFFSET, m_totalSize * PRIME64_1),
+            .high = mergeAccumulators(acc, SECRET.data() + HIGH_SECRET_OFFSET, ~(m_totalSize * PRIME64_2))};
+}
+
+auto hash128(const void* data,
+             size_t size) -> Hash128
+{
+    ContentHasher hasher;
+    hasher.update(data, size);
+    return hasher.digest();
+}
+
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers,cppcoreguidelines-pro-bounds-pointer-arithmetic,cppcoreguidelines-pro-bounds-constant-array-index,cppcoreguidelines-pro-type-reinterpret-cast)
@@ -5,51 +5,142 @@
 #include <spdlog/common.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <mutex>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <utility>
 #include <variant>
 #include <vector>
 
 using namespace std;
 
+// Statics
+array<Logger::DedupShard, Logger::DEDUP_SHARD_COUNT> Logger::s_dedupShards;
+
 // Static thread-local variables
 thread_local vector<wstring> Logger::s_prefixStack;
 
 // Helper function to build the full prefix string
 auto Logger::buildPrefixWString() -> wstring
 {
-    wstringstream fullPrefix;
+    size_t totalSize = 0;
+    for (const auto& block : Logger::s_prefixStack) {
+        totalSize += block.size() + 3;
+    }
+
+    wstring fullPrefix;
+    fullPrefix.reserve(totalSize);
     for (const auto& block : Logger::s_prefixStack) {
-        fullPrefix << L"[" << block << L"] ";
+        fullPrefix += L'[';
+        fullPrefix += block;
+        fullPrefix += L"] ";
     }
-    return fullPrefix.str();
+    return fullPrefix;
 }
 
 auto Logger::buildPrefixString() -> string { return StringUtil::utf16toUTF8(buildPrefixWString()); }
 
 // ScopedPrefix class implementation
-Logger::Prefix::Prefix(const wstring& prefix)
+void Logger::Prefix::push(wstring&& prefix)
 {
     // Add the new prefix block to the stack
-    s_prefixStack.push_back(prefix);
+    s_prefixStack.push_back(std::move(prefix));
+    m_pushed = true;
 }
 
-Logger::Prefix::Prefix(const string& prefix)
+Logger::Prefix::Prefix(const wstring_view prefix)
 {
-    // Add the new prefix block to the stack
-    s_prefixStack.push_back(StringUtil::utf8toUTF16(prefix));
+    if (isPrefixEnabled()) {
+        push(wstring(prefix));
+    }
+}
+
+Logger::Prefix::Prefix(const string_view prefix)
+{
+    if (isPrefixEnabled()) {
+        push(StringUtil::utf8toUTF16(string(prefix)));
+    }
 }
 
 Logger::Prefix::~Prefix()
 {
-    // Remove the last prefix block
-    if (!s_prefixStack.empty()) {
+    // Remove the last prefix block (only if this prefix was actually pushed)
+    if (m_pushed && !s_prefixStack.empty()) {
         s_prefixStack.pop_back();
     }
 }
 
+auto Logger::processMessage(uint64_t messageHash) -> bool
+{
+    // finalize the hash so shard and slot selection use well mixed bits (splitmix64 finalizer)
+    messageHash ^= messageHash >> 30U;
+    messageHash *= 0xbf58476d1ce4e5b9ULL;
+    messageHash ^= messageHash >> 27U;
+    messageHash *= 0x94d049bb133111ebULL;
+    messageHash ^= messageHash >> 31U;
+    if (messageHash == 0) {
+        // 0 marks an empty slot
+        messageHash = 1;
+    }
+
+    auto& shard = s_dedupShards.at(messageHash % DEDUP_SHARD_COUNT);
+    const lock_guard lock(shard.mutex);
+
+    if (shard.slots.empty()) {
+        // slot count is a power of two kept at or below 75% load
+        size_t slotCount = 1;
+        while (slotCount * 3 < s_dedupShardCapacity.load() * 4) {
+            slotCount <<= 1U;
+        }
+        shard.slots.resize(slotCount, 0);
+    }
+
+    const size_t mask = shard.slots.size() - 1;
+    for (size_t idx = (messageHash / DEDUP_SHARD_COUNT) & mask;; idx = (idx + 1) & mask) {
+        auto& slot = shard.slots[idx];
+        if (slot == messageHash) {
+            // don't log anything if already logged
+            s_suppressedMessages.fetch_add(1, memory_order_relaxed);
+            return false;
+        }
+
+        if (slot == 0) {
+            if (shard.size >= s_dedupShardCapacity.load()) {
+                // table is full, log without tracking
+                s_untrackedMessages.fetch_add(1, memory_order_relaxed);
+                return true;
+            }
+
+            slot = messageHash;
+            shard.size++;
+            return true;
+        }
+    }
+}
+
+void Logger::setDedupCapacity(const size_t& capacity)
+{
+    s_dedupShardCapacity.store(max<size_t>(1, (capacity + DEDUP_SHARD_COUNT - 1) / DEDUP_SHARD_COUNT));
+
+    // drop existing tables so they are resized on next use
+    for (auto& shard : s_dedupShards) {
+        const lock_guard lock(shard.mutex);
+        shard.slots.clear();
+        shard.slots.shrink_to_fit();
+        shard.size = 0;
+    }
+}
+
+auto Logger::getSuppressedDuplicateCount() -> uint64_t { return s_suppressedMessages.load(); }
+
+auto Logger::getUntrackedMessageCount() -> uint64_t { return s_untrackedMessages.load(); }
+
 void Logger::startThreadedBuffer()
 {
     s_isThreadedBufferActive = true;
@@ -0,0 +1,107 @@
+#include "util/MemoryBudget.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <utility>
+
+using namespace std;
+
+MemoryBudget::MemoryBudget(string name,
+                           const size_t& budget)
+    : m_name(std::move(name))
+    , m_budget(budget)
+{
+}
+
+void MemoryBudget::setBudget(const size_t& budget)
+{
+    {
+        const lock_guard lock(m_mutex);
+        m_budget = budget;
+    }
+    m_cv.notify_all();
+}
+
+auto MemoryBudget::acquire(const size_t& bytes) -> bool
+{
+    unique_lock lock(m_mutex);
+    m_cv.wait(lock, [this, &bytes]() -> bool {
+        return m_cancelled || m_budget == 0 || m_used == 0 || m_used + bytes <= m_budget;
+    });
+    if (m_cancelled) {
+        return false;
+    }
+
+    m_used += bytes;
+    m_peak = max(m_peak, m_used);
+    return true;
+}
+
+void MemoryBudget::forceAcquire(const size_t& bytes)
+{
+    const lock_guard lock(m_mutex);
+    m_used += bytes;
+    m_peak = max(m_peak, m_used);
+}
+
+void MemoryBudget::release(const size_t& bytes)
+{
+    {
+        const lock_guard lock(m_mutex);
+        m_used -= min(bytes, m_used);
+    }
+    m_cv.notify_all();
+}
+
+void MemoryBudget::adjust(const size_t& oldBytes,
+                          const size_t& newBytes)
+{
+    if (newBytes >= oldBytes) {
+        forceAcquire(newBytes - oldBytes);
+    } else {
+        release(oldBytes - newBytes);
+    }
+}
+
+void MemoryBudget::cancel()
+{
+    {
+        const lock_guard lock(m_mutex);
+        m_cancelled = true;
+    }
+    m_cv.notify_all();
+}
+
+void MemoryBudget::resume()
+{
+    const lock_guard lock(m_mutex);
+    m_cancelled = false;
+}
+
+auto MemoryBudget::getName() const -> const string& { return m_name; }
+
+auto MemoryBudget::getBudget() const -> size_t
+{
+    const lock_guard lock(m_mutex);
+    return m_budget;
+}
+
+auto MemoryBudget::getUsed() const -> size_t
+{
+    const lock_guard lock(m_mutex);
+    return m_used;
+}
+
+auto MemoryBudget::getPeak() const -> size_t
+{
+    const lock_guard lock(m_mutex);
+    return m_peak;
+}
+
+void MemoryBudget::resetPeak()
+{
+    const lock_guard lock(m_mutex);
+    m_peak = m_used;
+}
@@ -0,0 +1,258 @@
+#include "util/MemoryGovernor.hpp"
+
+#include "util/ExceptionHandler.hpp"
+#include "util/Logger.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+constexpr double BYTES_PER_MIB = 1024.0 * 1024.0;
+
+auto toMiB(const size_t& bytes) -> double { return static_cast<double>(bytes) / BYTES_PER_MIB; }
+}
+
+MemoryGovernor::Reservation::Reservation(Subsystem* subsystem,
+                                         const size_t& bytes)
+    : m_subsystem(subsystem)
+    , m_bytes(bytes)
+{
+}
+
+MemoryGovernor::Reservation::~Reservation() { reset(); }
+
+MemoryGovernor::Reservation::Reservation(Reservation&& other) noexcept
+    : m_subsystem(std::exchange(other.m_subsystem, nullptr))
+    , m_bytes(std::exchange(other.m_bytes, 0))
+{
+}
+
+auto MemoryGovernor::Reservation::operator=(Reservation&& other) noexcept -> Reservation&
+{
+    if (this != &other) {
+        reset();
+        m_subsystem = std::exchange(other.m_subsystem, nullptr);
+        m_bytes = std::exchange(other.m_bytes, 0);
+    }
+
+    return *this;
+}
+
+void MemoryGovernor::Reservation::reset()
+{
+    if (m_subsystem != nullptr && m_bytes > 0) {
+        MemoryGovernor::release(m_subsystem, m_bytes);
+    }
+
+    m_subsystem = nullptr;
+    m_bytes = 0;
+}
+
+auto MemoryGovernor::getTotalUsedLocked() -> size_t
+{
+    size_t total = s_used;
+    for (const auto* budget : s_attachedBudgets) {
+        total += budget->getUsed();
+    }
+
+    return total;
+}
+
+auto MemoryGovernor::isOverBudgetLocked(const size_t& extraBytes) -> bool
+{
+    return s_budget != 0 && getTotalUsedLocked() + extraBytes > s_budget;
+}
+
+void MemoryGovernor::setBudget(const size_t& bytes)
+{
+    {
+        const lock_guard lock(s_mutex);
+        s_budget = bytes;
+    }
+    s_cv.notify_all();
+}
+
+auto MemoryGovernor::getBudget() -> size_t
+{
+    const lock_guard lock(s_mutex);
+    return s_budget;
+}
+
+auto MemoryGovernor::getUsed() -> size_t
+{
+    const lock_guard lock(s_mutex);
+    return getTotalUsedLocked();
+}
+
+auto MemoryGovernor::registerSubsystem(string name,
+                                       EvictFunc evict) -> Subsystem*
+{
+    const lock_guard lock(s_mutex);
+    return &s_subsystems.emplace_back(Subsystem {.name = std::move(name), .evict = std::move(evict)});
+}
+
+void MemoryGovernor::unregisterSubsystem(Subsystem* subsystem)
+{
+    if (subsystem == nullptr) {
+        return;
+    }
+
+    {
+        const lock_guard lock(s_mutex);
+        s_used -= min(subsystem->used, s_used);
+        subsystem->used = 0;
+        subsystem->evict = {};
+        subsystem->active = false;
+    }
+    s_cv.notify_all();
+}
+
+void MemoryGovernor::attachBudget(MemoryBudget* budget)
+{
+    const lock_guard lock(s_mutex);
+    if (ranges::find(s_attachedBudgets, budget) == s_attachedBudgets.end()) {
+        s_attachedBudgets.push_back(budget);
+    }
+}
+
+void MemoryGovernor::charge(Subsystem* subsystem,
+                            const size_t& bytes)
+{
+    const lock_guard lock(s_mutex);
+    if (!subsystem->active) {
+        return;
+    }
+
+    subsystem->used += bytes;
+    subsystem->peak = max(subsystem->peak, subsystem->used);
+    s_used += bytes;
+    s_peak = max(s_peak, getTotalUsedLocked());
+}
+
+void MemoryGovernor::release(Subsystem* subsystem,
+                             const size_t& bytes)
+{
+    {
+        const lock_guard lock(s_mutex);
+        const size_t freed = min(bytes, subsystem->used);
+        subsystem->used -= freed;
+        s_used -= min(freed, s_used);
+    }
+    s_cv.notify_all();
+}
+
+void MemoryGovernor::reclaim(Subsystem* caller,
+                             const size_t& extraBytes)
+{
+    {
+        const lock_guard lock(s_mutex);
+        if (!isOverBudgetLocked(extraBytes)) {
+            return;
+        }
+    }
+
+    // another thread might have evicted enough while we waited for the lock
+    const lock_guard evictLock(s_evictMutex);
+
+    // index based since other threads may register subsystems meanwhile, which invalidates deque iterators
+    for (size_t subsystemIdx = 0;; subsystemIdx++) {
+        EvictFunc evict;
+        size_t needed = 0;
+        {
+            const lock_guard lock(s_mutex);
+            if (subsystemIdx >= s_subsystems.size() || !isOverBudgetLocked(extraBytes)) {
+                return;
+            }
+
+            auto& subsystem = s_subsystems[subsystemIdx];
+            if (&subsystem == caller || !subsystem.evict || subsystem.used == 0) {
+                continue;
+            }
+
+            needed = getTotalUsedLocked() + extraBytes - s_budget;
+            evict = subsystem.evict;
+            subsystem.evictions++;
+        }
+
+        // called without the governor lock, the callback takes its own cache lock and calls release()
+        evict(needed);
+    }
+}
+
+auto MemoryGovernor::acquire(Subsystem* subsystem,
+                             const size_t& bytes) -> Reservation
+{
+    reclaim(subsystem, bytes);
+
+    unique_lock lock(s_mutex);
+    const auto canProceed = [subsystem, &bytes]() -> bool {
+        return !subsystem->active || subsystem->used == 0 || !isOverBudgetLocked(bytes)
+            || ExceptionHandler::hasException();
+    };
+
+    while (!canProceed()) {
+        // attached budgets do not notify us, so re-check periodically and give caches another chance to shrink
+        if (!s_cv.wait_for(lock, WAIT_INTERVAL, canProceed)) {
+            lock.unlock();
+            reclaim(subsystem, bytes);
+            lock.lock();
+        }
+    }
+
+    if (!subsystem->active) {
+        return {};
+    }
+
+    subsystem->used += bytes;
+    subsystem->peak = max(subsystem->peak, subsystem->used);
+    s_used += bytes;
+    s_peak = max(s_peak, getTotalUsedLocked());
+
+    return {subsystem, bytes};
+}
+
+void MemoryGovernor::resetPeaks()
+{
+    const lock_guard lock(s_mutex);
+    for (auto& subsystem : s_subsystems) {
+        subsystem.peak = subsystem.used;
+        subsystem.evictions = 0;
+    }
+    for (auto* budget : s_attachedBudgets) {
+        budget->resetPeak();
+    }
+    s_peak = getTotalUsedLocked();
+}
+
+void MemoryGovernor::logSummary()
+{
+    const lock_guard lock(s_mutex);
+
+    if (s_budget == 0) {
+        Logger::info("Memory peak: {:.1f} MiB (no budget)", toMiB(s_peak));
+    } else {
+        Logger::info("Memory peak: {:.1f} MiB of {:.1f} MiB budget", toMiB(s_peak), toMiB(s_budget));
+    }
+
+    for (const auto* budget : s_attachedBudgets) {
+        Logger::info("  {}: peak {:.1f} MiB of {:.1f} MiB",
+                     budget->getName(),
+                     toMiB(budget->getPeak()),
+                     toMiB(budget->getBudget()));
+    }
+
+    for (const auto& subsystem : s_subsystems) {
+        if (subsystem.evictions > 0) {
+            Logger::info(
+                "  {}: peak {:.1f} MiB, evicted {} times", subsystem.name, toMiB(subsystem.peak), subsystem.evictions);
+        } else {
+            Logger::info("  {}: peak {:.1f} MiB", subsystem.name, toMiB(subsystem.peak));
+        }
+    }
+}
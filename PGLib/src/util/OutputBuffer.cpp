@@ -0,0 +1,225 @@
+#include "util/OutputBuffer.hpp"
+
+#include "util/HashUtil.hpp"
+#include "util/Logger.hpp"
+#include "util/MemoryGovernor.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ios>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+constexpr double BYTES_PER_MIB = 1024.0 * 1024.0;
+}
+
+OutputBuffer::OutputBuffer(bool computeCRC)
+    : m_computeCRC(computeCRC)
+{
+    s_buffers++;
+
+    {
+        const lock_guard lock(s_poolMutex);
+        if (!s_pool.empty()) {
+            m_storage = std::move(s_pool.back());
+            s_pool.pop_back();
+            MemoryGovernor::release(getPoolMemory(), m_storage.size());
+            s_poolReuses++;
+            return;
+        }
+    }
+
+    m_storage.resize(INITIAL_CAPACITY);
+}
+
+OutputBuffer::~OutputBuffer()
+{
+    s_bytesWritten += m_size;
+
+    if (m_storage.size() > MAX_POOLED_CAPACITY) {
+        return;
+    }
+
+    // an idle pool is not worth evicting caches for
+    const auto budget = MemoryGovernor::getBudget();
+    if (budget != 0 && MemoryGovernor::getUsed() + m_storage.size() > budget) {
+        return;
+    }
+
+    const lock_guard lock(s_poolMutex);
+    if (s_pool.size() < MAX_POOLED_BUFFERS) {
+        MemoryGovernor::charge(getPoolMemory(), m_storage.size());
+        s_pool.push_back(std::move(m_storage));
+    }
+}
+
+auto OutputBuffer::getPoolMemory() -> MemoryGovernor::Subsystem*
+{
+    static auto* const subsystem
+        = MemoryGovernor::registerSubsystem("Output Buffer Pool", [](size_t /*bytes*/) -> void { clearPool(); });
+    return subsystem;
+}
+
+void OutputBuffer::clearPool()
+{
+    vector<vector<char>> pool;
+    {
+        const lock_guard lock(s_poolMutex);
+        pool.swap(s_pool);
+    }
+
+    size_t poolBytes = 0;
+    for (const auto& storage : pool) {
+        poolBytes += storage.size();
+    }
+    MemoryGovernor::release(getPoolMemory(), poolBytes);
+}
+
+auto OutputBuffer::data() const -> const char* { return m_storage.data(); }
+
+auto OutputBuffer::size() const -> size_t { return m_size; }
+
+void OutputBuffer::ensureCapacity(size_t capacity)
+{
+    if (capacity <= m_storage.size()) {
+        return;
+    }
+
+    m_storage.resize(max(capacity, m_storage.size() * 2));
+    s_reallocations++;
+}
+
+void OutputBuffer::write(const char* src,
+                         size_t count)
+{
+    ensureCapacity(m_pos + count);
+
+    if (m_pos > m_size) {
+        // seeked past the end, the gap reads as zeros like it would in a file
+        memset(m_storage.data() + m_size, 0, m_pos - m_size);
+    }
+
+    if (m_computeCRC && m_pos < m_crcPos) {
+        recordCRCPatch(m_pos, src, min(count, m_crcPos - m_pos));
+    }
+
+    memcpy(m_storage.data() + m_pos, src, count);
+    m_pos += count;
+    m_size = max(m_size, m_pos);
+
+    if (m_computeCRC && m_pos > m_crcPos) {
+        m_crc = HashUtil::crc32(m_storage.data() + m_crcPos, m_pos - m_crcPos, m_crc);
+        m_crcPos = m_pos;
+    }
+}
+
+void OutputBuffer::recordCRCPatch(size_t offset,
+                                  const char* src,
+                                  size_t count)
+{
+    // consecutive writes are merged, nifly writes the block sizes one by one
+    if (m_crcPatches.empty() || m_crcPatches.back().offset + m_crcPatches.back().delta.size() != offset) {
+        m_crcPatches.push_back({.offset = offset, .delta = {}});
+    }
+
+    auto& delta = m_crcPatches.back().delta;
+    for (size_t i = 0; i < count; i++) {
+        delta.push_back(static_cast<char>(m_storage[offset + i] ^ src[i]));
+    }
+}
+
+auto OutputBuffer::getCRC32() -> uint32_t
+{
+    if (!m_computeCRC) {
+        throw runtime_error("CRC32 was not enabled for this output buffer");
+    }
+
+    // every write past the hashed part is hashed right away, so m_crc covers all m_size bytes as first written
+    // crc(new) = crc(old) ^ rawcrc(new ^ old) for messages of the same length, rawcrc being the CRC32 without init
+    // value and final XOR. Combining with an empty second CRC moves the delta CRC over the zero bytes after it
+    uint32_t checksum = m_crc;
+    for (const auto& patch : m_crcPatches) {
+        const uint32_t deltaCRC = ~HashUtil::crc32(patch.delta.data(), patch.delta.size(), ~0U);
+        checksum ^= HashUtil::crc32Combine(deltaCRC, 0, m_size - patch.offset - patch.delta.size());
+    }
+
+    return checksum;
+}
+
+auto OutputBuffer::overflow(int_type ch) -> int_type
+{
+    if (traits_type::eq_int_type(ch, traits_type::eof())) {
+        return traits_type::not_eof(ch);
+    }
+
+    const char c = traits_type::to_char_type(ch);
+    write(&c, 1);
+    return ch;
+}
+
+auto OutputBuffer::xsputn(const char_type* s,
+                          streamsize count) -> streamsize
+{
+    if (count <= 0) {
+        return 0;
+    }
+
+    write(s, static_cast<size_t>(count));
+    return count;
+}
+
+auto OutputBuffer::seekoff(off_type off,
+                           ios_base::seekdir dir,
+                           ios_base::openmode which) -> pos_type
+{
+    if ((which & ios_base::out) == 0) {
+        return {off_type(-1)};
+    }
+
+    off_type base = 0;
+    if (dir == ios_base::cur) {
+        base = static_cast<off_type>(m_pos);
+    } else if (dir == ios_base::end) {
+        base = static_cast<off_type>(m_size);
+    }
+
+    const off_type newPos = base + off;
+    if (newPos < 0) {
+        return {off_type(-1)};
+    }
+
+    m_pos = static_cast<size_t>(newPos);
+    return {newPos};
+}
+
+auto OutputBuffer::seekpos(pos_type pos,
+                           ios_base::openmode which) -> pos_type
+{
+    return seekoff(off_type(pos), ios_base::beg, which);
+}
+
+auto OutputBuffer::getStats() -> Stats
+{
+    return {.buffers = s_buffers.load(),
+            .poolReuses = s_poolReuses.load(),
+            .reallocations = s_reallocations.load(),
+            .bytesWritten = s_bytesWritten.load()};
+}
+
+void OutputBuffer::logStats()
+{
+    const auto stats = getStats();
+    Logger::debug("Output buffers: {} used, {} reused from pool, {} reallocations, {:.1f} MiB written, CRC32 via {}",
+                  stats.buffers,
+                  stats.poolReuses,
+                  stats.reallocations,
+                  static_cast<double>(stats.bytesWritten) / BYTES_PER_MIB,
+                  HashUtil::getCRC32Implementation());
+}
@@ -5,9 +5,6 @@
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/locale.hpp>
 #include <boost/locale/encoding.hpp>
-#include <nlohmann/detail/output/serializer.hpp>
-#include <nlohmann/json.hpp>
-#include <nlohmann/json_fwd.hpp>
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
@@ -152,19 +149,6 @@ auto containsOnlyAscii(const std::wstring& str) -> bool
     return std::ranges::all_of(str, [](wchar_t wc) { return wc <= ASCII_UPPER_BOUND; });
 }
 
-auto checkIfStringInJSONArray(const nlohmann::json& json,
-                              const string& str) -> bool
-{
-    if (json.is_array()) {
-        for (const auto& item : json) {
-            if (item.is_string() && item.get<string>() == str) {
-                return true;
-            }
-        }
-    }
-    return false;
-}
-
 auto toLowerASCIIFast(const std::string& str) -> std::string
 {
     std::string lowerStr = str;
@@ -189,19 +173,21 @@ auto toLowerASCIIFast(const std::wstring& str) -> std::wstring
 
 auto toLowerASCIIFastInPlace(std::string& str) -> void
 {
+    // branchless so the loop gets vectorized, the unsigned subtraction folds both range checks into one compare
+    static constexpr unsigned ALPHA_COUNT = 26;
     for (char& ch : str) {
-        if (ch >= 'A' && ch <= 'Z') {
-            ch += ('a' - 'A');
-        }
+        const auto isUpper = static_cast<unsigned char>(static_cast<unsigned char>(ch) - 'A') < ALPHA_COUNT;
+        ch = static_cast<char>(ch + (isUpper ? ('a' - 'A') : 0));
     }
 }
 
 auto toLowerASCIIFastInPlace(std::wstring& str) -> void
 {
+    // branchless so the loop gets vectorized, the unsigned subtraction folds both range checks into one compare
+    static constexpr unsigned ALPHA_COUNT = 26;
     for (wchar_t& ch : str) {
-        if (ch >= L'A' && ch <= L'Z') {
-            ch += (L'a' - L'A');
-        }
+        const auto isUpper = static_cast<unsigned>(ch - L'A') < ALPHA_COUNT;
+        ch = static_cast<wchar_t>(ch + (isUpper ? (L'a' - L'A') : 0));
     }
 }
 
@@ -907,8 +907,8 @@ public class PGMutagen
         }
     }
 
-    [UnmanagedCallersOnly(EntryPoint = "SetModelUses", CallConvs = [typeof(CallConvCdecl)])]
-    public static unsafe void SetModelUses(
+    [UnmanagedCallersOnly(EntryPoint = "SetModelUsesBatch", CallConvs = [typeof(CallConvCdecl)])]
+    public static unsafe void SetModelUsesBatch(
       [DNNE.C99Type("const unsigned int")] uint length,
       [DNNE.C99Type("const uint8_t*")] byte* bufferPtr)
     {
@@ -916,12 +916,12 @@ public class PGMutagen
         {
             if (Env is null)
             {
-                throw new Exception("Initialize must be called before SetModelUses");
+                throw new Exception("Initialize must be called before SetModelUsesBatch");
             }
 
             if (OutMod is null)
             {
-                throw new Exception("OutMod is null in SetModelUses");
+                throw new Exception("OutMod is null in SetModelUsesBatch");
             }
 
             if (length == 0 || bufferPtr == null)
@@ -934,240 +934,239 @@ public class PGMutagen
 
             // Load onto buffer
             var buffer = new ByteBuffer(bufferSpan.ToArray());
-            var modelUses = PGMutagenBuffers.ModelUses.GetRootAsModelUses(buffer);
+            var batch = PGMutagenBuffers.ModelUseBatch.GetRootAsModelUseBatch(buffer);
 
-            // Loop through each model use
-            for (int i = 0; i < modelUses.UsesLength; i++)
+            // Decode every distinct string once
+            var strings = new string[batch.StringsLength];
+            for (int i = 0; i < batch.StringsLength; i++)
             {
-                var modelUseContainer = modelUses.Uses(i);
-                if (!modelUseContainer.HasValue)
+                strings[i] = batch.Strings(i) ?? string.Empty;
+            }
+
+            // Loop through each model use, in the order they were added
+            for (int i = 0; i < batch.FormIdLength; i++)
+            {
+                Dictionary<int, Tuple<int, string[]?>> altTexDict = [];
+                for (int j = (int)batch.AltTexStart(i); j < (int)batch.AltTexStart(i + 1); j++)
                 {
-                    continue;
+                    var bufTextures = new string[8];
+                    for (int k = 0; k < 8; k++)
+                    {
+                        bufTextures[k] = strings[batch.SlotTextures((j * 8) + k)];
+                    }
+
+                    altTexDict[batch.SlotId(j)] = new Tuple<int, string[]?>(batch.SlotIdNew(j), bufTextures);
                 }
 
-                var modelUse = modelUseContainer.Value;
-                var searchFormKey = new FormKey(modelUse.ModName, modelUse.FormId);
+                ApplyModelUse(strings[batch.ModName(i)], batch.FormId(i), strings[batch.SubModel(i)], strings[batch.MeshFile(i)], altTexDict);
+            }
+        }
+        catch (Exception ex)
+        {
+            ExceptionHandler.SetLastException(ex);
+        }
+    }
+
+    // altTexDict maps the old alternate texture idx to the new idx and the new textures (null to keep them)
+    private static void ApplyModelUse(string modName, uint formId, string subModel, string meshFile, Dictionary<int, Tuple<int, string[]?>> altTexDict)
+    {
+        if (Env is null || OutMod is null)
+        {
+            throw new Exception("Initialize must be called before ApplyModelUse");
+        }
+
+        var searchFormKey = new FormKey(modName, formId);
+
+        // Find winning record for this formkey
+        if (!Env.LinkCache.TryResolve<IMajorRecordGetter>(searchFormKey, out var existingRecord))
+        {
+            // Record doesn't exist, skip
+            throw new Exception("Failed to resolve model record for formkey: " + searchFormKey);
+        }
+
+        // check if we already modified this record
+        IMajorRecord? modRecord = null;
+        if (ModifiedRecords.TryGetValue(searchFormKey, out IMajorRecord? value))
+        {
+            // record already modified
+            modRecord = value;
+        }
+        else
+        {
+            try
+            {
+                // create a mutable copy of the existing record
+                modRecord = existingRecord.DeepCopy();
+            }
+            catch (Exception)
+            {
+                MessageHandler.Log("Failed to copy model record: " + GetRecordDesc(existingRecord), 4);
+                ModifiedRecords[searchFormKey] = null;
+            }
+        }
+
+        if (modRecord is null)
+        {
+            // invalid record, skip
+            return;
+        }
 
-                // Find winning record for this formkey
-                if (!Env.LinkCache.TryResolve<IMajorRecordGetter>(searchFormKey, out var existingRecord))
+        // Find model record to modify
+        var matchExistingElem = GetModelElemBySubModel(existingRecord, subModel);
+        var matchModElem = GetModelElemBySubModel(modRecord, subModel);
+        if (matchExistingElem is null || matchModElem is null)
+        {
+            throw new Exception("Failed to find submodel: " + subModel + " in record: " + GetRecordDesc(existingRecord));
+        }
+
+        // Actual changes starting
+        bool changed = false;
+
+        // Check model major record if it is addon node and weight slider is enabled
+        string newMeshFile = meshFile;
+        if (modRecord is IArmorAddon armorAddonRec)
+        {
+            // if weight slider is enabled, do not update the file if it is either _1 or _0 variant
+            if (((subModel == "MALE" || subModel == "1STMALE") && armorAddonRec.WeightSliderEnabled.Male) ||
+                ((subModel == "FEMALE" || subModel == "1STFEMALE") && armorAddonRec.WeightSliderEnabled.Female))
+            {
+                string existingFile = matchExistingElem.File.ToString();
+                // add other variant to check list
+                if (existingFile.EndsWith("_0.nif", StringComparison.OrdinalIgnoreCase) && newMeshFile.EndsWith("_1.nif", StringComparison.OrdinalIgnoreCase))
                 {
-                    // Record doesn't exist, skip
-                    throw new Exception("Failed to resolve model record for formkey: " + searchFormKey);
+                    newMeshFile = string.Concat(newMeshFile.AsSpan(0, newMeshFile.Length - 6), "_0.nif");
                 }
+                else if (existingFile.EndsWith("_1.nif", StringComparison.OrdinalIgnoreCase) && newMeshFile.EndsWith("_0.nif", StringComparison.OrdinalIgnoreCase))
+                {
+                    newMeshFile = string.Concat(newMeshFile.AsSpan(0, newMeshFile.Length - 6), "_1.nif");
+                }
+            }
+        }
 
-                // check if we already modified this record
-                IMajorRecord? modRecord = null;
-                if (ModifiedRecords.TryGetValue(searchFormKey, out IMajorRecord? value))
+        // Mesh path
+        if (!string.Equals(matchExistingElem.File.ToString(), newMeshFile, StringComparison.OrdinalIgnoreCase))
+        {
+            // Change mesh path
+            matchModElem.File = RemovePrefixIfExists("meshes\\", newMeshFile);
+            changed = true;
+        }
+
+        if (matchExistingElem.AlternateTextures is not null && matchModElem.AlternateTextures is not null)
+        {
+            // Loop through existing alternate textures
+            for (int j = 0; j < matchModElem.AlternateTextures.Count; j++)
+            {
+                var curAltTex = matchModElem.AlternateTextures[j];
+                if (!altTexDict.ContainsKey(curAltTex.Index))
                 {
-                    // record already modified
-                    modRecord = value;
+                    continue;
                 }
-                else
+
+                // Found matching alternate texture, update it if required
+                var bufAltTex = altTexDict[curAltTex.Index];
+
+                // Index
+                var newAltTex = bufAltTex.Item1;
+                if (curAltTex.Index != newAltTex)
                 {
-                    try
-                    {
-                        // create a mutable copy of the existing record
-                        modRecord = existingRecord.DeepCopy();
-                    }
-                    catch (Exception)
+                    changed = true;
+                    if (newAltTex == -1)
                     {
-                        MessageHandler.Log("Failed to copy model record: " + GetRecordDesc(existingRecord), 4);
-                        ModifiedRecords[searchFormKey] = null;
+                        // delete the alternate texture
+                        matchModElem.AlternateTextures.RemoveAt(j);
+                        j--;
+                        continue;
                     }
+
+                    // Change index
+                    matchModElem.AlternateTextures[j].Index = newAltTex;
                 }
 
-                if (modRecord is null)
+                // Find new texture set
+                if (bufAltTex.Item2 is not { } bufTextures)
                 {
-                    // invalid record, skip
+                    // No texture set, skip
                     continue;
                 }
 
-                // Find model record to modify
-                var matchExistingElem = GetModelElemBySubModel(existingRecord, modelUse.SubModel);
-                var matchModElem = GetModelElemBySubModel(modRecord, modelUse.SubModel);
-                if (matchExistingElem is null || matchModElem is null)
+                string[] existingTextures;
+                // find existing texture set record
+                if (Env.LinkCache.TryResolve<ITextureSetGetter>(curAltTex.NewTexture.FormKey, out var existingTXSTRec))
                 {
-                    throw new Exception("Failed to find submodel: " + modelUse.SubModel + " in record: " + GetRecordDesc(existingRecord));
+                    existingTextures = GetTextureSet(existingTXSTRec);
                 }
-
-                // Actual changes starting
-                bool changed = false;
-
-                // Check model major record if it is addon node and weight slider is enabled
-                string newMeshFile = modelUse.MeshFile;
-                if (modRecord is IArmorAddon armorAddonRec)
+                else
                 {
-                    // if weight slider is enabled, do not update the file if it is either _1 or _0 variant
-                    if (((modelUse.SubModel == "MALE" || modelUse.SubModel == "1STMALE") && armorAddonRec.WeightSliderEnabled.Male) ||
-                        ((modelUse.SubModel == "FEMALE" || modelUse.SubModel == "1STFEMALE") && armorAddonRec.WeightSliderEnabled.Female))
-                    {
-                        string existingFile = matchExistingElem.File.ToString();
-                        // add other variant to check list
-                        if (existingFile.EndsWith("_0.nif", StringComparison.OrdinalIgnoreCase) && newMeshFile.EndsWith("_1.nif", StringComparison.OrdinalIgnoreCase))
-                        {
-                            newMeshFile = string.Concat(newMeshFile.AsSpan(0, newMeshFile.Length - 6), "_0.nif");
-                        }
-                        else if (existingFile.EndsWith("_1.nif", StringComparison.OrdinalIgnoreCase) && newMeshFile.EndsWith("_0.nif", StringComparison.OrdinalIgnoreCase))
-                        {
-                            newMeshFile = string.Concat(newMeshFile.AsSpan(0, newMeshFile.Length - 6), "_1.nif");
-                        }
-                    }
+                    existingTextures = [.. Enumerable.Repeat(string.Empty, 8)];
                 }
 
-                // Mesh path
-                if (!string.Equals(matchExistingElem.File.ToString(), newMeshFile, StringComparison.OrdinalIgnoreCase))
+                // check if textures are different
+                if (existingTextures.SequenceEqual(bufTextures, StringComparer.OrdinalIgnoreCase))
                 {
-                    // Change mesh path
-                    matchModElem.File = RemovePrefixIfExists("meshes\\", newMeshFile);
-                    changed = true;
+                    continue;
                 }
 
-                if (matchExistingElem.AlternateTextures is not null && matchModElem.AlternateTextures is not null)
+                // Textures are different, we need to find or create a new texture set record
+                changed = true;
+                if (NewTextureSets.TryGetValue(bufTextures, out Tuple<ITextureSet, bool>? existingTXSTTuple))
                 {
-                    // Create dictionary of old alternate texture idx to buffer entry
-                    Dictionary<int, PGMutagenBuffers.AlternateTexture> altTexDict = [];
-                    for (int j = 0; j < modelUse.AlternateTexturesLength; j++)
-                    {
-                        var curAltTex = modelUse.AlternateTextures(j);
-                        if (!curAltTex.HasValue)
-                        {
-                            continue;
-                        }
+                    // already exists, just use that
+                    matchModElem.AlternateTextures[j].NewTexture.FormKey = existingTXSTTuple.Item1.FormKey;
 
-                        altTexDict[curAltTex.Value.SlotId] = curAltTex.Value;
+                    // Update usage flag
+                    if (!existingTXSTTuple.Item2)
+                    {
+                        NewTextureSets[bufTextures] = new Tuple<ITextureSet, bool>(existingTXSTTuple.Item1, true);
                     }
-                    // Loop through existing alternate textures
-                    for (int j = 0; j < matchModElem.AlternateTextures.Count; j++)
+                }
+                else
+                {
+                    // Create a new texture set record
+                    var newFormKey = new FormKey(OutMod.ModKey, GetLowestAvailableFormID());
+                    // find filename of diffuse texture (just .dds file no path), also remove extension
+                    var diffuseTex = bufTextures[0].IsNullOrEmpty() ? "" : Path.GetFileNameWithoutExtension(bufTextures[0]);
+                    var formIDHex = newFormKey.ID.ToString("X6");
+                    var newEDID = "PG_";
+                    if (!diffuseTex.IsNullOrEmpty())
                     {
-                        var curAltTex = matchModElem.AlternateTextures[j];
-                        if (!altTexDict.ContainsKey(curAltTex.Index))
-                        {
-                            continue;
-                        }
-
-                        // Found matching alternate texture, update it if required
-                        var bufAltTex = altTexDict[curAltTex.Index];
-
-                        // Index
-                        var newAltTex = bufAltTex.SlotIdNew;
-                        if (curAltTex.Index != newAltTex)
-                        {
-                            changed = true;
-                            if (newAltTex == -1)
-                            {
-                                // delete the alternate texture
-                                matchModElem.AlternateTextures.RemoveAt(j);
-                                j--;
-                                continue;
-                            }
-
-                            // Change index
-                            matchModElem.AlternateTextures[j].Index = newAltTex;
-                        }
-
-                        // Find new texture set
-                        if (bufAltTex.Slots is null || !bufAltTex.Slots.HasValue || bufAltTex.Slots.Value.TexturesLength != 8)
-                        {
-                            // No texture set, skip
-                            continue;
-                        }
-
-                        // get texture set array from buffer
-                        string[] bufTextures = [
-                            bufAltTex.Slots.Value.Textures(0) ?? string.Empty,
-                        bufAltTex.Slots.Value.Textures(1) ?? string.Empty,
-                        bufAltTex.Slots.Value.Textures(2) ?? string.Empty,
-                        bufAltTex.Slots.Value.Textures(3) ?? string.Empty,
-                        bufAltTex.Slots.Value.Textures(4) ?? string.Empty,
-                        bufAltTex.Slots.Value.Textures(5) ?? string.Empty,
-                        bufAltTex.Slots.Value.Textures(6) ?? string.Empty,
-                        bufAltTex.Slots.Value.Textures(7) ?? string.Empty
-                        ];
-
-                        string[] existingTextures;
-                        // find existing texture set record
-                        if (Env.LinkCache.TryResolve<ITextureSetGetter>(curAltTex.NewTexture.FormKey, out var existingTXSTRec))
-                        {
-                            existingTextures = GetTextureSet(existingTXSTRec);
-                        }
-                        else
-                        {
-                            existingTextures = [.. Enumerable.Repeat(string.Empty, 8)];
-                        }
-
-                        // check if textures are different
-                        if (existingTextures.SequenceEqual(bufTextures, StringComparer.OrdinalIgnoreCase))
-                        {
-                            continue;
-                        }
+                        newEDID += diffuseTex + "_" + formIDHex;
+                    }
+                    else
+                    {
+                        newEDID += formIDHex;
+                    }
 
-                        // Textures are different, we need to find or create a new texture set record
-                        changed = true;
-                        if (NewTextureSets.TryGetValue(bufTextures, out Tuple<ITextureSet, bool>? existingTXSTTuple))
-                        {
-                            // already exists, just use that
-                            matchModElem.AlternateTextures[j].NewTexture.FormKey = existingTXSTTuple.Item1.FormKey;
+                    var newTXSTObj = new TextureSet(newFormKey, Env.GameRelease.ToSkyrimRelease())
+                    {
+                        Diffuse = bufTextures[0].IsNullOrEmpty() ? null : RemovePrefixIfExists("textures\\", bufTextures[0]),
+                        NormalOrGloss = bufTextures[1].IsNullOrEmpty() ? null : RemovePrefixIfExists("textures\\", bufTextures[1]),
+                        GlowOrDetailMap = bufTextures[2].IsNullOrEmpty() ? null : RemovePrefixIfExists("textures\\", bufTextures[2]),
+                        Height = bufTextures[3].IsNullOrEmpty() ? null : RemovePrefixIfExists("textures\\", bufTextures[3]),
+                        Environment = bufTextures[4].IsNullOrEmpty() ? null : RemovePrefixIfExists("textures\\", bufTextures[4]),
+                        EnvironmentMaskOrSubsurfaceTint = bufTextures[5].IsNullOrEmpty() ? null : RemovePrefixIfExists("textures\\", bufTextures[5]),
+                        Multilayer = bufTextures[6].IsNullOrEmpty() ? null : RemovePrefixIfExists("textures\\", bufTextures[6]),
+                        BacklightMaskOrSpecular = bufTextures[7].IsNullOrEmpty() ? null : RemovePrefixIfExists("textures\\", bufTextures[7]),
+                        EditorID = newEDID
+                    };
 
-                            // Update usage flag
-                            if (!existingTXSTTuple.Item2)
-                            {
-                                NewTextureSets[bufTextures] = new Tuple<ITextureSet, bool>(existingTXSTTuple.Item1, true);
-                            }
-                        }
-                        else
-                        {
-                            // Create a new texture set record
-                            var newFormKey = new FormKey(OutMod.ModKey, GetLowestAvailableFormID());
-                            // find filename of diffuse texture (just .dds file no path), also remove extension
-                            var diffuseTex = bufTextures[0].IsNullOrEmpty() ? "" : Path.GetFileNameWithoutExtension(bufTextures[0]);
-                            var formIDHex = newFormKey.ID.ToString("X6");
-                            var newEDID = "PG_";
-                            if (!diffuseTex.IsNullOrEmpty())
-                            {
-                                newEDID += diffuseTex + "_" + formIDHex;
-                            }
-                            else
-                            {
-                                newEDID += formIDHex;
-                            }
+                    // Add to output mod
+                    OutMod.TextureSets.Add(newTXSTObj);
+                    allocatedFormIDs.Add(newFormKey.ID);
+                    lastUsedFormID = newFormKey.ID;
 
-                            var newTXSTObj = new TextureSet(newFormKey, Env.GameRelease.ToSkyrimRelease())
-                            {
-                                Diffuse = bufTextures[0].IsNullOrEmpty() ? null : RemovePrefixIfExists("textures\\", bufTextures[0]),
-                                NormalOrGloss = bufTextures[1].IsNullOrEmpty() ? null : RemovePrefixIfExists("textures\\", bufTextures[1]),
-                                GlowOrDetailMap = bufTextures[2].IsNullOrEmpty() ? null : RemovePrefixIfExists("textures\\", bufTextures[2]),
-                                Height = bufTextures[3].IsNullOrEmpty() ? null : RemovePrefixIfExists("textures\\", bufTextures[3]),
-                                Environment = bufTextures[4].IsNullOrEmpty() ? null : RemovePrefixIfExists("textures\\", bufTextures[4]),
-                                EnvironmentMaskOrSubsurfaceTint = bufTextures[5].IsNullOrEmpty() ? null : RemovePrefixIfExists("textures\\", bufTextures[5]),
-                                Multilayer = bufTextures[6].IsNullOrEmpty() ? null : RemovePrefixIfExists("textures\\", bufTextures[6]),
-                                BacklightMaskOrSpecular = bufTextures[7].IsNullOrEmpty() ? null : RemovePrefixIfExists("textures\\", bufTextures[7]),
-                                EditorID = newEDID
-                            };
-
-                            // Add to output mod
-                            OutMod.TextureSets.Add(newTXSTObj);
-                            allocatedFormIDs.Add(newFormKey.ID);
-                            lastUsedFormID = newFormKey.ID;
-
-                            // Add to dictionary
-                            NewTextureSets[bufTextures] = new Tuple<ITextureSet, bool>(newTXSTObj, true);
-
-                            // Update formkey
-                            matchModElem.AlternateTextures[j].NewTexture.FormKey = newFormKey;
-                        }
-                    }
-                }
+                    // Add to dictionary
+                    NewTextureSets[bufTextures] = new Tuple<ITextureSet, bool>(newTXSTObj, true);
 
-                // add to modified records only if something has changed
-                if (changed)
-                {
-                    ModifiedRecords[searchFormKey] = modRecord;
+                    // Update formkey
+                    matchModElem.AlternateTextures[j].NewTexture.FormKey = newFormKey;
                 }
             }
         }
-        catch (Exception ex)
+
+        // add to modified records only if something has changed
+        if (changed)
         {
-            ExceptionHandler.SetLastException(ex);
+            ModifiedRecords[searchFormKey] = modRecord;
         }
     }
 
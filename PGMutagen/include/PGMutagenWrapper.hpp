@@ -1,9 +1,12 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 /**
@@ -47,6 +50,71 @@ public:
         std::vector<AlternateTexture> alternateTextures; ///< List of alternate texture entries for this model.
     };
 
+    /**
+     * @brief Model uses stored in columns with an interned UTF-8 string table, submitted in one call.
+     *
+     * Mod names, mesh paths and texture paths repeat across uses, so each distinct string is converted and sent once.
+     * Uses are submitted in the order they were added.
+     */
+    class ModelUseBatch {
+    private:
+        std::vector<std::string> m_strings; ///< UTF-8 string table.
+        std::unordered_map<std::wstring, uint32_t> m_wideStringIndices;
+        std::unordered_map<std::string, uint32_t> m_stringIndices;
+        size_t m_stringBytes = 0; ///< UTF-8 bytes in the string table.
+
+        // Columns per model use
+        std::vector<uint32_t> m_modName;
+        std::vector<uint32_t> m_formID;
+        std::vector<uint32_t> m_subModel;
+        std::vector<uint32_t> m_meshFile;
+        std::vector<uint32_t> m_altTexStart {0}; ///< Alternate textures of use i are [i, i + 1), one entry more.
+
+        // Columns per alternate texture
+        std::vector<int32_t> m_slotID;
+        std::vector<int32_t> m_slotIDNew;
+        std::vector<uint32_t> m_slotTextures; ///< NUM_PLUGIN_TEXTURE_SLOTS string indices per alternate texture.
+
+        auto intern(const std::wstring& str) -> uint32_t;
+        auto intern(const std::string& str) -> uint32_t;
+
+        friend class PGMutagenWrapper;
+
+    public:
+        /**
+         * @brief Starts a new model use. Alternate textures added afterwards belong to it.
+         *
+         * @param modName  Name of the plugin that owns the record.
+         * @param formID   FormID of the record.
+         * @param subModel Sub-model identifier within the record.
+         * @param meshFile New mesh path of the record.
+         */
+        void addModelUse(const std::wstring& modName,
+                         const unsigned int& formID,
+                         const std::string& subModel,
+                         const std::wstring& meshFile);
+
+        /**
+         * @brief Adds an alternate texture to the last model use.
+         *
+         * @param altTex Alternate texture to add.
+         */
+        void addAlternateTexture(const AlternateTexture& altTex);
+
+        /**
+         * @brief Approximate size of the serialized batch in bytes.
+         */
+        [[nodiscard]] auto getBytes() const -> size_t;
+
+        [[nodiscard]] auto size() const -> size_t;
+        [[nodiscard]] auto empty() const -> bool;
+
+        /**
+         * @brief Drops all uses and the string table.
+         */
+        void clear();
+    };
+
     /**
      * @brief Initializes the PGMutagen C# library and loads the specified game's plugin data.
      *
@@ -92,11 +160,14 @@ public:
     static auto libGetModelUses(const std::wstring& modelPath) -> std::vector<ModelUse>;
 
     /**
-     * @brief Pushes updated model-use records back to the C# library for serialisation into the output plugin.
+     * @brief Pushes a batch of updated model-use records back to the C# library for serialisation into the output
+     * plugin.
+     *
+     * Uses are applied to the output plugin in the order they were added to the batch.
      *
-     * @param modelUses Updated list of ModelUse structs to write.
+     * @param batch Model uses to write.
      */
-    static void libSetModelUses(const std::vector<ModelUse>& modelUses);
+    static void libSetModelUsesBatch(const ModelUseBatch& batch);
 
 private:
     // Helpers
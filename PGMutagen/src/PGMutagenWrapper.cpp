@@ -13,6 +13,7 @@
 
 #include <array>
 #include <combaseapi.h>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <minwindef.h>
@@ -20,6 +21,7 @@
 #include <stdexcept>
 #include <string>
 #include <stringapiset.h>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <winbase.h>
@@ -247,64 +249,125 @@ auto PGMutagenWrapper::libGetModelUses(const std::wstring& modelPath) -> std::ve
     return modelUsesOut;
 }
 
-void PGMutagenWrapper::libSetModelUses(const std::vector<ModelUse>& modelUses)
+void PGMutagenWrapper::libSetModelUsesBatch(const ModelUseBatch& batch)
 {
-    flatbuffers::FlatBufferBuilder builder(DEFAULT_BUFFER_SIZE);
+    if (batch.empty()) {
+        return;
+    }
 
-    vector<flatbuffers::Offset<PGMutagenBuffers::ModelUse>> modelUsesOffsets;
-    modelUsesOffsets.reserve(modelUses.size());
+    flatbuffers::FlatBufferBuilder builder(batch.getBytes() + DEFAULT_BUFFER_SIZE);
+
+    const auto stringsOffset = builder.CreateVectorOfStrings(batch.m_strings);
+    const auto modNameOffset = builder.CreateVector(batch.m_modName);
+    const auto formIDOffset = builder.CreateVector(batch.m_formID);
+    const auto subModelOffset = builder.CreateVector(batch.m_subModel);
+    const auto meshFileOffset = builder.CreateVector(batch.m_meshFile);
+    const auto altTexStartOffset = builder.CreateVector(batch.m_altTexStart);
+    const auto slotIDOffset = builder.CreateVector(batch.m_slotID);
+    const auto slotIDNewOffset = builder.CreateVector(batch.m_slotIDNew);
+    const auto slotTexturesOffset = builder.CreateVector(batch.m_slotTextures);
+
+    const auto batchRoot = PGMutagenBuffers::CreateModelUseBatch(builder,
+                                                                 stringsOffset,
+                                                                 modNameOffset,
+                                                                 formIDOffset,
+                                                                 subModelOffset,
+                                                                 meshFileOffset,
+                                                                 altTexStartOffset,
+                                                                 slotIDOffset,
+                                                                 slotIDNewOffset,
+                                                                 slotTexturesOffset);
+    builder.Finish(batchRoot);
 
-    for (const auto& mu : modelUses) {
-        const auto modNameOffset = builder.CreateString(utf16toUTF8(mu.modName));
-        const auto subModelOffset = builder.CreateString(mu.subModel);
-        const auto meshFileOffset = builder.CreateString(utf16toUTF8(mu.meshFile));
+    uint8_t const* buf = builder.GetBufferPointer();
+    unsigned int const size = builder.GetSize();
 
-        vector<flatbuffers::Offset<PGMutagenBuffers::AlternateTexture>> altTexOffsets;
-        altTexOffsets.reserve(mu.alternateTextures.size());
+    {
+        const lock_guard<mutex> lock(s_libMutex);
+        SetModelUsesBatch(size, buf);
+        libLogMessageIfExists();
+        libThrowExceptionIfExists();
+    }
+}
 
-        for (const auto& altTex : mu.alternateTextures) {
-            vector<flatbuffers::Offset<flatbuffers::String>> texOffsets;
-            texOffsets.reserve(NUM_PLUGIN_TEXTURE_SLOTS);
+auto PGMutagenWrapper::ModelUseBatch::intern(const wstring& str) -> uint32_t
+{
+    const auto [it, inserted] = m_wideStringIndices.try_emplace(str, static_cast<uint32_t>(m_strings.size()));
+    if (inserted) {
+        m_strings.push_back(utf16toUTF8(str));
+        m_stringBytes += m_strings.back().size();
+    }
 
-            for (const auto& tex : altTex.slots) {
-                texOffsets.push_back(builder.CreateString(utf16toUTF8(tex)));
-            }
+    return it->second;
+}
 
-            const auto slotsOffset = PGMutagenBuffers::CreateTextureSet(builder, builder.CreateVector(texOffsets));
+auto PGMutagenWrapper::ModelUseBatch::intern(const string& str) -> uint32_t
+{
+    const auto [it, inserted] = m_stringIndices.try_emplace(str, static_cast<uint32_t>(m_strings.size()));
+    if (inserted) {
+        m_strings.push_back(str);
+        m_stringBytes += str.size();
+    }
 
-            const auto altTexOffset
-                = PGMutagenBuffers::CreateAlternateTexture(builder, altTex.slotID, altTex.slotIDNew, slotsOffset);
-            altTexOffsets.push_back(altTexOffset);
-        }
+    return it->second;
+}
 
-        const auto altTexVectorOffset = builder.CreateVector(altTexOffsets);
-
-        const auto modelUseOffset = PGMutagenBuffers::CreateModelUse(builder,
-                                                                     modNameOffset,
-                                                                     mu.formID,
-                                                                     subModelOffset,
-                                                                     false,
-                                                                     meshFileOffset,
-                                                                     false,
-                                                                     false,
-                                                                     {},
-                                                                     altTexVectorOffset);
-        modelUsesOffsets.push_back(modelUseOffset);
+void PGMutagenWrapper::ModelUseBatch::addModelUse(const wstring& modName,
+                                                  const unsigned int& formID,
+                                                  const string& subModel,
+                                                  const wstring& meshFile)
+{
+    m_modName.push_back(intern(modName));
+    m_formID.push_back(formID);
+    m_subModel.push_back(intern(subModel));
+    m_meshFile.push_back(intern(meshFile));
+    m_altTexStart.push_back(static_cast<uint32_t>(m_slotID.size()));
+}
+
+void PGMutagenWrapper::ModelUseBatch::addAlternateTexture(const AlternateTexture& altTex)
+{
+    if (m_formID.empty()) {
+        throw runtime_error("addModelUse must be called before addAlternateTexture");
     }
 
-    const auto modelUsesVectorOffset = builder.CreateVector(modelUsesOffsets);
-    const auto modelUsesRoot = PGMutagenBuffers::CreateModelUses(builder, modelUsesVectorOffset);
-    builder.Finish(modelUsesRoot);
+    m_slotID.push_back(altTex.slotID);
+    m_slotIDNew.push_back(altTex.slotIDNew);
+    for (const auto& slot : altTex.slots) {
+        m_slotTextures.push_back(intern(slot));
+    }
+    m_altTexStart.back() = static_cast<uint32_t>(m_slotID.size());
+}
 
-    uint8_t const* buf = builder.GetBufferPointer();
-    unsigned int const size = builder.GetSize();
+auto PGMutagenWrapper::ModelUseBatch::getBytes() const -> size_t
+{
+    // strings carry a length prefix and terminator, columns are 4 bytes per entry
+    static constexpr size_t STRING_OVERHEAD = 8;
+    static constexpr size_t USE_COLUMNS = 5;
+    static constexpr size_t ALT_TEX_COLUMNS = 2 + NUM_PLUGIN_TEXTURE_SLOTS;
+
+    return m_stringBytes + (m_strings.size() * STRING_OVERHEAD)
+        + (m_formID.size() * USE_COLUMNS * sizeof(uint32_t))
+        + (m_slotID.size() * ALT_TEX_COLUMNS * sizeof(uint32_t));
+}
 
-    {
-        const lock_guard<mutex> lock(s_libMutex);
-        SetModelUses(size, buf);
-        libLogMessageIfExists();
-        libThrowExceptionIfExists();
-    }
+auto PGMutagenWrapper::ModelUseBatch::size() const -> size_t { return m_formID.size(); }
+
+auto PGMutagenWrapper::ModelUseBatch::empty() const -> bool { return m_formID.empty(); }
+
+void PGMutagenWrapper::ModelUseBatch::clear()
+{
+    m_strings.clear();
+    m_wideStringIndices.clear();
+    m_stringIndices.clear();
+    m_stringBytes = 0;
+    m_modName.clear();
+    m_formID.clear();
+    m_subModel.clear();
+    m_meshFile.clear();
+    m_altTexStart.assign(1, 0);
+    m_slotID.clear();
+    m_slotIDNew.clear();
+    m_slotTextures.clear();
 }
 
 auto PGMutagenWrapper::utf8toUTF16(const string& str) -> wstring
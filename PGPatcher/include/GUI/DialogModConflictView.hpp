@@ -2,6 +2,7 @@
 
 #include "PGModManager.hpp"
 #include "PGPatcher.hpp"
+#include "pgutil/PGMeshPatchStore.hpp"
 #include "pgutil/PGMeshPermutationTracker.hpp"
 
 #include <wx/listctrl.h>
@@ -75,8 +76,8 @@ private:
     wxCheckBox* m_showDisabledCheckbox = nullptr; ///< Toggle visibility of disabled/untracked matches.
     wxCheckBox* m_showOnlyConflictsCheckbox = nullptr; ///< When checked, show only conflicting shapes.
 
-    /// Thread-safe snapshot of mesh patch metadata taken at construction time.
-    PGPatcher::MeshPatchInfo m_patchMeta;
+    /// Immutable snapshot of mesh patch metadata shared with the patcher, taken at construction time.
+    std::shared_ptr<const PGMeshPatchStore::View> m_patchMeta;
     /// Ordered list of mesh paths currently visible in the left panel.
     std::vector<std::filesystem::path> m_filteredMeshes;
     /// Cached display labels for the visible mesh paths, kept in the same order as m_filteredMeshes.
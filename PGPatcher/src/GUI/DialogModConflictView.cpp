@@ -237,9 +237,9 @@ DialogModConflictView::DialogModConflictView(const unordered_set<wstring>& filte
 
 auto DialogModConflictView::PluginUseInfo::displayString() const -> wxString
 {
-    wxString label = wxString(formKey.modKey);
+    wxString label = wxString(formKey.getModKey());
     label += wxString::Format(L":%06X:", formKey.formID);
-    label += wxString::FromUTF8(formKey.subMODL);
+    label += wxString::FromUTF8(formKey.getSubMODL());
     return label;
 }
 
@@ -314,13 +314,13 @@ auto DialogModConflictView::shapeHasActualConflict(const vector<MatchView>& matc
 auto DialogModConflictView::meshPassesModFilter(const PGPatcher::MeshMeta& meshMeta) const -> bool
 {
     return ranges::any_of(meshMeta.shapeMeta,
-                          [this](const auto& shapeEntry) { return shapePassesIntersectionFilter(shapeEntry.second); });
+                          [this](const auto& shapeMeta) { return shapePassesIntersectionFilter(shapeMeta); });
 }
 
 auto DialogModConflictView::meshPassesAnyModFilter(const PGPatcher::MeshMeta& meshMeta) const -> bool
 {
     return ranges::any_of(meshMeta.shapeMeta,
-                          [this](const auto& shapeEntry) { return shapePassesAnyModFilter(shapeEntry.second); });
+                          [this](const auto& shapeMeta) { return shapePassesAnyModFilter(shapeMeta); });
 }
 
 auto DialogModConflictView::shapePassesAnyModFilter(const PGPatcher::MeshShapeMeta& shape) const -> bool
@@ -418,11 +418,15 @@ void DialogModConflictView::rebuildMeshList()
     m_matchListCtrl->DeleteAllItems();
     m_filteredMeshes.clear();
     m_filteredMeshLabels.clear();
-    m_filteredMeshLabels.reserve(m_patchMeta.size());
+    m_filteredMeshLabels.reserve(m_patchMeta->size());
 
     const wxString searchTerm = m_meshSearchCtrl->GetValue().Lower();
 
-    for (const auto& [meshPath, meshData] : m_patchMeta) {
+    // The snapshot is sorted by mesh path, so the filtered list is too
+    for (const auto& meshEntry : *m_patchMeta) {
+        const auto& meshPath = meshEntry->meshPath;
+        const auto& meshData = meshEntry->meta;
+
         // When "show only conflicts" is on, apply mod/conflict filter. Otherwise show all meshes.
         if (m_showOnlyConflicts && !meshPassesModFilter(meshData)) {
             continue;
@@ -441,29 +445,6 @@ void DialogModConflictView::rebuildMeshList()
         m_filteredMeshLabels.push_back(meshStr);
     }
 
-    // Stable sort so the list order is deterministic
-    vector<size_t> sortedIndices;
-    sortedIndices.reserve(m_filteredMeshes.size());
-    for (size_t i = 0; i < m_filteredMeshes.size(); ++i) {
-        sortedIndices.push_back(i);
-    }
-
-    sort(sortedIndices.begin(), sortedIndices.end(), [&](size_t a, size_t b) {
-        return m_filteredMeshes.at(a) < m_filteredMeshes.at(b);
-    });
-
-    vector<filesystem::path> sortedMeshes;
-    vector<wxString> sortedLabels;
-    sortedMeshes.reserve(m_filteredMeshes.size());
-    sortedLabels.reserve(m_filteredMeshLabels.size());
-    for (const size_t idx : sortedIndices) {
-        sortedMeshes.push_back(std::move(m_filteredMeshes.at(idx)));
-        sortedLabels.push_back(std::move(m_filteredMeshLabels.at(idx)));
-    }
-
-    m_filteredMeshes = std::move(sortedMeshes);
-    m_filteredMeshLabels = std::move(sortedLabels);
-
     for (const auto& meshLabel : m_filteredMeshLabels) {
         m_meshListCtrl->InsertItem(m_meshListCtrl->GetItemCount(), meshLabel);
     }
@@ -481,17 +462,16 @@ void DialogModConflictView::populateShapeList(long meshIdx)
     }
 
     const auto& meshPath = m_filteredMeshes.at(static_cast<size_t>(meshIdx));
-    const auto meshIt = m_patchMeta.find(meshPath);
-    if (meshIt == m_patchMeta.end()) {
+    const auto* meshData = m_patchMeta->find(meshPath);
+    if (meshData == nullptr) {
         return;
     }
 
-    const auto& meshData = meshIt->second;
-
-    // Sort shapes by map key so the list is stable.
+    // Shapes are stored in shape index order, so the list is stable.
     vector<pair<int, const PGPatcher::MeshShapeMeta*>> sortedShapes;
-    sortedShapes.reserve(meshData.shapeMeta.size());
-    for (const auto& [shapeKey, shapeInfo] : meshData.shapeMeta) {
+    sortedShapes.reserve(meshData->shapeMeta.size());
+    for (size_t shapeKey = 0; shapeKey < meshData->shapeMeta.size(); shapeKey++) {
+        const auto& shapeInfo = meshData->shapeMeta[shapeKey];
         // When "show only conflicts" is on:
         //   - if filterMods set: shape must pass intersection filter
         //   - if filterMods empty: shape must have an actual conflict
@@ -514,12 +494,13 @@ void DialogModConflictView::populateShapeList(long meshIdx)
         }
         sortedShapes.emplace_back(static_cast<int>(shapeKey), &shapeInfo);
     }
-    sort(sortedShapes.begin(), sortedShapes.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
 
     for (const auto& [idx3D, shapeInfo] : sortedShapes) {
         (void)idx3D;
-        const wxString baseShapeName
-            = shapeInfo->shapeName.empty() ? wxString("[ Unnamed ]") : wxString::FromUTF8(shapeInfo->shapeName);
+        const wxString baseShapeName = shapeInfo->shapeName.empty()
+            ? wxString("[ Unnamed ]")
+            : wxString::FromUTF8(shapeInfo->shapeName.data(),
+                                 shapeInfo->shapeName.size());
         const wxString shapeLabelText = wxString::Format("%s (%u)", baseShapeName, shapeInfo->blockID);
 
         const long row = m_shapeListCtrl->InsertItem(m_shapeListCtrl->GetItemCount(), shapeLabelText);
@@ -537,17 +518,12 @@ void DialogModConflictView::populatePluginUseList(const filesystem::path& meshPa
     m_pluginUseCombo->SetSelection(0);
     m_selectedPluginUseIdx = -1;
 
-    const auto meshIt = m_patchMeta.find(meshPath);
-    if (meshIt == m_patchMeta.end()) {
-        return;
-    }
-
-    const auto& meshMeta = meshIt->second;
-    if (meshMeta.formKeys.empty()) {
+    const auto* meshMeta = m_patchMeta->find(meshPath);
+    if (meshMeta == nullptr || meshMeta->formKeys.empty()) {
         return;
     }
 
-    for (const auto& formKey : meshMeta.formKeys) {
+    for (const auto& formKey : meshMeta->formKeys) {
         PluginUseInfo info;
         info.formKey = formKey;
         m_currentPluginUses.push_back(std::move(info));
@@ -560,18 +536,12 @@ void DialogModConflictView::populateMatchList(const filesystem::path& meshPath,
 {
     m_matchListCtrl->DeleteAllItems();
 
-    const auto meshIt = m_patchMeta.find(meshPath);
-    if (meshIt == m_patchMeta.end()) {
-        return;
-    }
-
-    const auto& meshMeta = meshIt->second;
-    const auto shapeIt = meshMeta.shapeMeta.find(idx3D);
-    if (shapeIt == meshMeta.shapeMeta.end()) {
+    const auto* meshMeta = m_patchMeta->find(meshPath);
+    if (meshMeta == nullptr || idx3D >= meshMeta->shapeMeta.size()) {
         return;
     }
 
-    const auto& shapeMeta = shapeIt->second;
+    const auto& shapeMeta = meshMeta->shapeMeta[idx3D];
 
     optional<PGMeshPermutationTracker::FormKey> selectedFormKey;
     if (m_selectedPluginUseIdx >= 0 && static_cast<size_t>(m_selectedPluginUseIdx) < m_currentPluginUses.size()) {
@@ -1037,7 +1007,7 @@ void DialogModConflictView::onMeshSelected(wxListEvent& event)
     // Populate plugin use dropdown based on the selected mesh
     if (static_cast<size_t>(meshIdx) < m_filteredMeshes.size()) {
         const auto& meshPath = m_filteredMeshes.at(static_cast<size_t>(meshIdx));
-        if (m_patchMeta.contains(meshPath)) {
+        if (m_patchMeta->contains(meshPath)) {
             populatePluginUseList(meshPath);
         } else {
             m_currentPluginUses.clear();
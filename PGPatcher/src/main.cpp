@@ -11,6 +11,7 @@
 #include "PGPatcherGlobals.hpp"
 #include "PGPlugin.hpp"
 #include "PGUI.hpp"
+#include "common/BethesdaDataSource.hpp"
 #include "common/BethesdaGame.hpp"
 #include "patchers/PatcherMeshPostFixSSS.hpp"
 #include "patchers/PatcherMeshPostHairFlowMap.hpp"
@@ -28,6 +29,7 @@
 #include "util/ExceptionHandler.hpp"
 #include "util/FileUtil.hpp"
 #include "util/Logger.hpp"
+#include "util/OutputBuffer.hpp"
 #include "util/StringUtil.hpp"
 #include "util/TaskPoolRunner.hpp"
 #include "util/TaskQueue.hpp"
@@ -75,6 +77,7 @@ struct ParallaxGenCLIArgs {
     bool forceDark = false;
     bool considerAllMeshes = false;
     bool ignoreMO2Check = false;
+    bool mo2ReadModFolders = false;
     bool disableDynCubemap = false;
     bool forceAlwaysCM = false;
     bool excludeFacegens = false;
@@ -397,19 +400,28 @@ void mainRunnerPrep(const ParallaxGenCLIArgs& args,
 
     if (params.ModManager.type == PGModManager::ModManagerType::MODORGANIZER2
         && !params.ModManager.mo2InstanceDir.empty()) {
-        // Make sure running is USVFS
-        if (!args.ignoreMO2Check && !PGHandlers::isUnderUSVFS()) {
+        // Make sure running is USVFS, reading the mod folders in place does not need it
+        if (!args.ignoreMO2Check && !args.mo2ReadModFolders && !PGHandlers::isUnderUSVFS()) {
             Logger::critical("Please verify that you are launching PGPatcher from MO2, VFS not detected.");
             return;
         }
 
         // MO2
-        if (params.Processing.multithread) {
+        if (args.mo2ReadModFolders) {
+            // Read the mod folders in place on top of the data folder instead of going through the VFS. The file map
+            // needs the mod list, so this can't run in the background
+            pgmm->populateModFileMapMO2(
+                params.ModManager.mo2InstanceDir, params.Output.dir, params.Processing.multithread);
+
+            auto layerDirs = pgmm->getMO2OverlayFolders();
+            layerDirs.insert(layerDirs.begin(), bg->getGameDataPath());
+            pgd->setDataSource(make_unique<BethesdaOverlaySource>(layerDirs));
+        } else if (params.Processing.multithread) {
             modManagerInit.queueTask([&pgmm, &params]() -> void {
                 pgmm->populateModFileMapMO2(params.ModManager.mo2InstanceDir, params.Output.dir);
             });
         } else {
-            pgmm->populateModFileMapMO2(params.ModManager.mo2InstanceDir, params.Output.dir);
+            pgmm->populateModFileMapMO2(params.ModManager.mo2InstanceDir, params.Output.dir, false);
         }
     } else if (params.ModManager.type == PGModManager::ModManagerType::VORTEX) {
         // Vortex
@@ -708,10 +720,9 @@ void mainRunnerPatch(const ParallaxGenCLIArgs& args,
     progressWindow->CallAfter([progressWindow]() -> void { progressWindow->setStepLabel("Saving Diff Json"); });
 
     // Save diff json
-    const auto diffJSON = PGPatcher::getDiffJSON();
-    if (!diffJSON.empty()) {
+    if (PGPatcher::hasDiffData()) {
         const filesystem::path diffJSONPath = params.Output.dir / "ParallaxGen_Diff.json";
-        FileUtil::saveJSON(diffJSONPath, diffJSON, true);
+        PGPatcher::saveDiffJSON(diffJSONPath);
 
         PGGlobals::getPGD()->addGeneratedFile("ParallaxGen_Diff.json");
     }
@@ -860,6 +871,10 @@ void mainRunner(ParallaxGenCLIArgs& args,
     timeTaken += chrono::duration_cast<chrono::seconds>(endTime - startTime).count();
 
     Logger::info("PGPatcher took {} seconds to complete (does not include time in user interface)", timeTaken);
+    OutputBuffer::logStats();
+    Logger::debug("Suppressed {} duplicate log messages ({} messages not tracked for duplicates)",
+                  Logger::getSuppressedDuplicateCount(),
+                  Logger::getUntrackedMessageCount());
 
     // Show completion dialog
     CompletionDialog dlg(timeTaken);
@@ -903,6 +918,9 @@ void addArguments(CLI::App& app,
     app.add_flag(
         "--consider-allmeshes", args.considerAllMeshes, "Consider all meshes, even those not in plugins, for patching");
     app.add_flag("--ignore-mo2vfscheck", args.ignoreMO2Check, "Ignore MO2 VFS check - might be useful for Linux users");
+    app.add_flag("--mo2-read-mod-folders",
+                 args.mo2ReadModFolders,
+                 "Read MO2 mod folders directly on top of the data folder instead of through the VFS");
     app.add_flag(
         "--disable-dyncubemap", args.disableDynCubemap, "Do not apply dynamic cubemap to any Complex Material");
     app.add_flag(
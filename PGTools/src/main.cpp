@@ -17,6 +17,9 @@
 #include "patchers/PatcherTextureHookFixSSS.hpp"
 #include "patchers/base/PatcherUtil.hpp"
 #include "util/ExceptionHandler.hpp"
+#include "util/Logger.hpp"
+#include "util/MemoryGovernor.hpp"
+#include "util/OutputBuffer.hpp"
 
 #include <CLI/CLI.hpp>
 #include <cpptrace/from_current.hpp>
@@ -25,6 +28,7 @@
 
 #include <array>
 #include <chrono>
+#include <cstddef>
 #include <cstdlib>
 #include <exception>
 #include <filesystem>
@@ -38,6 +42,8 @@
 using namespace std;
 
 namespace {
+constexpr size_t DEFAULT_MEM_BUDGET_MIB = 8192;
+
 auto getExecutablePath() -> filesystem::path
 {
     array<wchar_t, MAX_PATH> buffer {};
@@ -80,6 +86,7 @@ struct PGToolsCLIArgs {
     int verbosity = 0;
     bool multithreading = true;
     bool shortcut = false;
+    size_t logDedupCapacity = 0;
 
     struct Patch {
         CLI::App* subCommand = nullptr;
@@ -88,6 +95,8 @@ struct PGToolsCLIArgs {
         filesystem::path output = "ParallaxGen_Output";
         bool mapTexturesFromMeshes = false;
         bool highMem = false;
+        size_t memBudgetMiB = DEFAULT_MEM_BUDGET_MIB;
+        bool verifyMeshPrefilter = false;
     } Patch;
 };
 
@@ -115,6 +124,14 @@ void mainRunner(PGToolsCLIArgs& args)
         args.Patch.source = filesystem::absolute(args.Patch.source);
         args.Patch.output = filesystem::absolute(args.Patch.output);
 
+        // High memory mode lifts the budget, caches are then never evicted and producers never wait
+        const size_t memBudget = args.Patch.highMem ? 0 : args.Patch.memBudgetMiB << 20U;
+        MemoryGovernor::setBudget(memBudget);
+        if (memBudget > 0) {
+            // decoded textures get half, caches, parsed NIFs and the mesh write queue share the rest
+            PGPatcher::setTexturePixelBudget(memBudget / 2);
+        }
+
         auto pgd = PGDirectory(args.Patch.source, args.Patch.output);
         PGGlobals::setPGD(&pgd);
         auto pgd3D = PGD3D(exePath / "cshaders");
@@ -238,6 +255,7 @@ void mainRunner(PGToolsCLIArgs& args)
         }
 
         PGPatcher::loadPatchers(meshPatchers, texPatchers);
+        PGPatcher::setMeshPrefilter(true, args.Patch.verifyMeshPrefilter);
         PGPatcher::patchMeshes(args.multithreading, true);
         PGPatcher::patchTextures(args.multithreading);
 
@@ -269,6 +287,11 @@ void mainRunner(PGToolsCLIArgs& args)
         timeTaken += chrono::duration_cast<chrono::seconds>(endTime - startTime).count();
 
         spdlog::info("PGPatcher took {} seconds to complete", timeTaken);
+        MemoryGovernor::logSummary();
+        OutputBuffer::logStats();
+        spdlog::debug("Suppressed {} duplicate log messages ({} messages not tracked for duplicates)",
+                      Logger::getSuppressedDuplicateCount(),
+                      Logger::getUntrackedMessageCount());
     }
 }
 
@@ -284,6 +307,9 @@ void addArguments(CLI::App& app,
     app.add_flag("--shortcut",
                  args.shortcut,
                  "Keep pgtools running at the end (useful if you are running not in a terminal directly)");
+    app.add_option("--log-dedup-capacity",
+                   args.logDedupCapacity,
+                   "Maximum number of distinct warnings/errors tracked for duplicate suppression (default: 1048576)");
 
     args.Patch.subCommand = app.add_subcommand("patch", "Patch meshes");
     args.Patch.subCommand->add_option("patcher", args.Patch.patchers, "List of patchers to use")
@@ -292,7 +318,16 @@ void addArguments(CLI::App& app,
     args.Patch.subCommand->add_option("source", args.Patch.source, "Source directory")->default_str("");
     args.Patch.subCommand->add_option("output", args.Patch.output, "Output directory")
         ->default_str("ParallaxGen_Output");
-    args.Patch.subCommand->add_flag("--high-mem", args.Patch.highMem, "High memory usage mode (default: false)");
+    auto* memBudgetOpt = args.Patch.subCommand->add_option(
+        "--mem-budget", args.Patch.memBudgetMiB, "Memory budget in MiB for caches and in-flight data (default: 8192)");
+    args.Patch.subCommand
+        ->add_flag(
+            "--high-mem", args.Patch.highMem, "High memory usage mode, disables the memory budget (default: false)")
+        ->excludes(memBudgetOpt);
+    args.Patch.subCommand->add_flag("--verify-mesh-prefilter",
+                                    args.Patch.verifyMeshPrefilter,
+                                    "Patch meshes the mesh prefilter would skip and report every one that changed, "
+                                    "slow (default: false)");
 }
 }
 
@@ -332,6 +367,10 @@ auto main(int argC,
         spdlog::trace("TRACE logging enabled");
     }
 
+    if (args.logDedupCapacity > 0) {
+        Logger::setDedupCapacity(args.logDedupCapacity);
+    }
+
     // Main Runner (Catches all exceptions)
     CPPTRACE_TRY { mainRunner(args); }
     CPPTRACE_CATCH(const exception& e)